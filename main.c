@@ -1,21 +1,186 @@
-#include <raylib.h>
-#include <stdio.h>    // For file I/O (fopen, fprintf, fscanf), snprintf
-#include <stdlib.h>   // For strtof, atoi, exit
+#if !defined(_WIN32)
+    #define _POSIX_C_SOURCE 200809L // For fsync, fileno, mmap, sockets
+#else
+    #define _CRT_RAND_S // For rand_s (password salts)
+#endif
+#if defined(AUCTION_HEADLESS)
+    // Headless build (cc -DAUCTION_HEADLESS main.c -lpthread): the auction core without raylib,
+    // for the server and benchmarks. The window, drawing and input code is left out; the plain
+    // raylib types and the few calls the core makes are defined here (see Headless Platform Functions).
+    #include <stdbool.h>
+    #define CLITERAL(type) (type)
+    typedef struct Vector2 { float x; float y; } Vector2;
+    typedef struct Rectangle { float x; float y; float width; float height; } Rectangle;
+    typedef struct Color { unsigned char r; unsigned char g; unsigned char b; unsigned char a; } Color;
+    typedef struct Image { void* data; int width; int height; int mipmaps; int format; } Image;
+    typedef struct Texture2D { unsigned int id; int width; int height; int mipmaps; int format; } Texture2D;
+    enum { LOG_ALL = 0, LOG_TRACE, LOG_DEBUG, LOG_INFO, LOG_WARNING, LOG_ERROR, LOG_FATAL, LOG_NONE }; // raylib's TraceLogLevel
+#else
+    #include <raylib.h>
+#endif
+#include <stdio.h>    // For file I/O (fopen, fprintf, fscanf), snprintf, vsnprintf
+#include <stdarg.h>   // For FrameFormat's variable arguments
+#include <stdlib.h>   // For strtoll, malloc, qsort
 #include <string.h>   // For strcmp, strcpy, strlen, strncpy, strtok, strchr
-#include "raygui.h"
+#include <stdint.h>   // For fixed-width integers in binary file formats
+#include <stddef.h>   // For offsetof
+#include <time.h>     // For time, clock_gettime
+#include <signal.h>   // For sig_atomic_t and stopping the server with Ctrl+C
+#include <pthread.h>  // For the bid ledger flush thread
+#if defined(_WIN32)
+    #include <io.h>   // For _commit, _fileno, _chsize
+    #include <sys/stat.h> // For stat
+    #define fsync _commit
+    #define fileno _fileno
+    #define ftruncate _chsize
+    #include <direct.h> // For _mkdir, _chdir
+    #define chdir _chdir
+    #define mkdir(path, mode) _mkdir(path)
+    // For ProfilerClock; declared as raylib does, since windows.h cannot be included next to raylib.h
+    __declspec(dllimport) int __stdcall QueryPerformanceCounter(unsigned long long int* count);
+    __declspec(dllimport) int __stdcall QueryPerformanceFrequency(unsigned long long int* frequency);
+#else
+    #include <unistd.h>   // For fsync, ftruncate, close, chdir
+    #include <fcntl.h>    // For open
+    #include <sys/mman.h> // For mmap, munmap
+    #include <sys/stat.h> // For fstat, stat, mkdir
+    #include <sys/socket.h>   // For the bid server and network client
+    #include <netinet/in.h>   // For sockaddr_in
+    #include <netinet/tcp.h>  // For TCP_NODELAY
+    #include <netdb.h>        // For getaddrinfo
+    #include <poll.h>         // For poll
+    #include <errno.h>        // For EAGAIN, EINTR
+#endif
+#if !defined(AUCTION_HEADLESS)
+    #include "raygui.h"
+#endif
 
 // --- Constants ---
-#define MAX_ITEMS 5         // Maximum number of auction items the app can hold
-#define MAX_USERS 10        // Maximum number of registered users
+#define INITIAL_ITEM_CAPACITY 64 // Starting capacity of the item store (grows on demand)
+#define INITIAL_POOL_CAPACITY 4096 // Starting size in bytes of each item string pool
+#define INITIAL_USER_CAPACITY 16 // Starting capacity of the user array (grows on demand)
+#define INITIAL_USER_INDEX_SLOTS 32 // Starting slot count of the username hash index (power of two)
 #define MAX_NAME_LENGTH 32  // Max length for item names, usernames, bidder names
 #define MAX_DESC_LENGTH 128 // Max length for item descriptions
 #define MAX_BIDDER_LENGTH 32 // Max length for bidder names
+#define BIDDER_CHUNK_SIZE 1024 // Bidder names per registry chunk (chunks never move once allocated)
+#define BIDDER_MAX_CHUNKS 4096 // Registry limit: BIDDER_CHUNK_SIZE * BIDDER_MAX_CHUNKS distinct bidders (must stay below 1 << BID_BIDDER_BITS)
+#define INITIAL_BIDDER_INDEX_SLOTS 64 // Starting slot count of the bidder name hash index (power of two)
+#define BIDDER_NONE UINT32_MAX // Returned by InternBidder when a name cannot be stored
+#define INITIAL_SEARCH_SLOTS 4096 // Starting slot count of the search trigram table (power of two)
+#define MAX_SEARCH_TEXT 256 // Bytes of an item's name or description that are searchable
 #define MAX_INPUT_CHARS 20  // Max characters for input fields (bid amount, bidder name, username, password)
-// Using a simple unsigned int for our basic hash, so MAX_PASSWORD_HASH_LENGTH is not directly relevant for string representation
-// but rather for the hash value itself. We'll use 12 for general buffer safety if ever converting hash to string.
-#define MAX_PASSWORD_HASH_LENGTH 12
+#define MAX_PASSWORD_TOKEN_LENGTH 128 // Longest text form of a password hash in USERS_FILE / USERS_LOG_FILE
+#define PASSWORD_SALT_LENGTH 16 // Random salt bytes stored with each password hash
+#define PASSWORD_KEY_LENGTH 32  // Derived key bytes stored with each password hash
+#define KDF_LOG_N 14 // scrypt cost for new hashes: N = 2^KDF_LOG_N (memory = 128 * KDF_R * N bytes = 16 MiB)
+#define KDF_R 8      // scrypt block size for new hashes (raises memory and time together)
+#define KDF_P 1      // scrypt parallelism for new hashes (raises time only)
+#define KDF_MAX_LOG_N 24 // Largest cost accepted from a stored record (guards against a doctored users file)
+#define KDF_MAX_R 32
+#define KDF_MAX_P 16
+#define KDF_MAX_MEMORY (256ULL * 1024 * 1024) // Largest 128 * r * N accepted from a stored record (16x the default)
+#define KDF_MAX_WORK (1ULL << 23) // Largest p * N * r accepted from a stored record (64x the default, bounds CPU time)
 
-#define USERS_FILE "users.txt" // File to store user credentials
+// UI scaling (every coordinate and font size below is in design pixels, see UiPx)
+#define UI_DESIGN_WIDTH 800   // Window size the screens are laid out for at scale 1
+#define UI_DESIGN_HEIGHT 600
+#define UI_SCALE_STEP 0.25f   // The UI scale is rounded down to a multiple of this, so fonts are re-baked only on real size changes
+#define UI_MIN_SCALE 0.5f     // Smallest UI scale (tiny windows clip instead of shrinking further)
+#define UI_FONT_FILE "ui-font.ttf" // Optional TrueType font baked into the text atlases (raylib's default font is scaled without it)
+#define UI_FONT_SIZE_COUNT 5  // Text sizes the UI uses (see UI_FONT_SIZES), one atlas each
+#define UI_FONT_FIRST_GLYPH 32 // Printable ASCII [32, 126] has a cached advance; other text is measured by raylib
+#define UI_FONT_GLYPH_COUNT 95
+
+// Item list layout (the list is virtualized, so only rows inside the viewport are drawn)
+#define LIST_TOP 100          // Y coordinate where the list viewport starts
+#define LIST_BOTTOM_MARGIN 40 // Space kept free below the viewport (UI message bar)
+#define LIST_SIDE_MARGIN 50   // Horizontal margin on both sides of the rows
+#define LIST_ROW_HEIGHT 50    // Height of a single row
+#define LIST_ROW_STRIDE 60    // Distance between the tops of two consecutive rows
+#define LIST_SCROLL_SPEED 3   // Rows scrolled per mouse wheel notch
+
+#define IDLE_POLL_INTERVAL (1.0 / 60.0) // Seconds between input polls while a timed redraw is pending
+
+#define USERS_FILE "users.txt" // Snapshot of all user credentials (rewritten only on compaction)
+#define USERS_TEMP_FILE "users.txt.tmp" // Scratch file the snapshot is written to before being renamed into place
+#define USERS_LOG_FILE "users.log" // Append-only log of registrations made since the last snapshot
+#define USERS_DB_FILE "users.db" // Optional binary snapshot; used instead of USERS_FILE when present
+#define USERS_DB_TEMP_FILE "users.db.tmp" // Scratch file for writing the binary snapshot
+#define USER_DB_MAGIC "SDAU"    // First four bytes of USERS_DB_FILE
+#define USER_DB_VERSION 2       // Bumped whenever the binary layout changes (1: djb2 hashes)
+#define CATALOG_FILE "catalog.csv" // Optional item catalog streamed in at startup (demo items are used without it)
+#define CATALOG_CHUNK_SIZE 65536 // Bytes read from the catalog per fread
+#define CATALOG_FIELD_COUNT 7 // name, description, current_bid, highest_bidder, closed, ends_at, image
+#define CATALOG_LOAD_BUDGET 0.004 // Seconds per frame spent loading the catalog, keeps the UI interactive
+#define PROFILER_MAX_EVENTS 65536 // Timed scopes kept for trace export (oldest are overwritten)
+#define PROFILER_FRAME_HISTORY 240 // Frames used for the p50/p99 frame time overlay
+#define FRAME_ARENA_SIZE (64 * 1024) // Bytes of per-frame scratch memory (strings and layout data)
+#define FRAME_ARENA_ALIGNMENT 16 // Alignment of every FrameAlloc block
+#define PROFILER_TRACE_FILE "trace.json" // Chrome trace (chrome://tracing, Perfetto) written by F12
+#define MAX_BID_CENTS 99999999900LL // Largest bid accepted, $999,999,999.00 (checked by the server too)
+#define BID_BIDDER_BITS 24 // Low bits of a bid word holding the bidder id; the 40 above hold the amount in cents
+#define MAX_CENTS_TEXT 32 // Buffer size for FormatCents
+#define BID_RECORD_CENTS_TAG 0x43454E54u // XORed into the checksum of ledger records that store cents ("CENT")
+#define DEFAULT_SERVER_PORT "7777" // TCP port used by --server and --connect when none is given
+#define BENCH_DIRECTORY "bench-data" // Working directory of --bench, so real user and bid files are never touched
+#define BENCH_DEFAULT_USERS 10000 // Accounts in the synthetic user directory
+#define BENCH_DEFAULT_ITEMS 10000 // Items in the synthetic item store
+#define BENCH_DEFAULT_THREADS 4 // Threads submitting bids at the same time
+#define BENCH_MAX_THREADS 64 // Upper limit for the thread count argument
+#define BENCH_BIDS_PER_THREAD 100000 // Bids each thread submits
+#define BENCH_BURST_SIZE 32 // Bids a thread places back to back on one item
+#define BENCH_HOT_ITEMS 16 // Every other burst targets one of these items, so threads collide on them
+#define BENCH_BIDDERS_PER_THREAD 64 // Distinct bidder names each thread bids under
+#define BENCH_AUTH_SAMPLES 8 // Registrations and sign-ins timed through the I/O worker (each runs scrypt)
+#define BENCH_FILE_ROUNDS 5 // Times SaveUsers and LoadUsers are each measured
+#define NET_MAX_PAYLOAD 255 // Largest message payload in the bid protocol
+#define NET_MAX_OUTPUT (8 * 1024 * 1024) // Bytes queued for one client before it is dropped as too slow
+#define NET_POLL_TIMEOUT_MS 100 // Longest time the server sleeps in poll()
+#define NET_MAX_SUBSCRIPTIONS 256 // Items one client can follow at a time (a screenful is a few dozen)
+#define NET_IDS_PER_MESSAGE (NET_MAX_PAYLOAD / 4) // Item ids that fit one subscribe or unsubscribe message
+#define NET_DELTA_SIZE 12 // Bytes per bid delta: u32 item, u64 bid word
+#define NET_DELTAS_PER_MESSAGE (NET_MAX_PAYLOAD / NET_DELTA_SIZE) // Bid deltas batched into one message
+#define SERVER_MAX_SHARDS 64 // Upper limit for the shard count of --server (one ledger segment each)
+#define SHARD_QUEUE_CAPACITY 4096 // Slots in each shard's request and result rings (power of two)
+#define SERVER_PARALLEL_FLUSH_CLIENTS 64 // Clients needed before a pass's update fan-out is shared with the shards
+#define BID_LEDGER_FILE "bids.ledger" // Append-only binary record of every accepted bid
+#define BID_LEDGER_FLUSH_INTERVAL_MS 50 // Longest time an accepted bid waits before its batch is committed
+#define BID_LEDGER_INITIAL_BATCH 256 // Starting capacity of the in-memory batch of unflushed bids
+#define BID_LEDGER_WRITE_CHUNK 128 // Records the flush thread encodes per fwrite
+#define BID_LEDGER_MAX_SEGMENTS 64 // Ledger files replayed at startup (one per server shard)
+#define BID_LEDGER_SEGMENT_FORMAT BID_LEDGER_FILE ".%d" // File name of ledger segment k >= 1 (segment 0 is BID_LEDGER_FILE)
+#define CHECKPOINT_FILE "auction.snapshot" // Newest snapshot of the item store; restarts replay only the ledger after it
+#define CHECKPOINT_TEMP_FILE "auction.snapshot.tmp" // Scratch file the snapshot is written to before being renamed into place
+#define CHECKPOINT_MAGIC "SDAS" // First four bytes of CHECKPOINT_FILE
+#define CHECKPOINT_VERSION 2 // Bumped whenever the snapshot layout changes (1: no ledger identities)
+#define CHECKPOINT_INTERVAL_SECONDS 30 // Seconds between snapshots while bids keep arriving (bounds the ledger tail a restart replays)
+#define USER_LOG_COMPACT_THRESHOLD 1024 // Log records that trigger folding the log into a new snapshot
+#define SESSION_TOKEN_LENGTH 16 // Random bytes in a session token
+#define SESSION_LIFETIME_MS (30LL * 60 * 1000) // A session expires this long after sign-in
+#define INITIAL_SESSION_SLOTS 64 // Starting size of the session table (power of two)
+#define CREDENTIAL_CACHE_SLOTS 64 // Recently verified sign-ins remembered (power of two, direct-mapped by username)
+#define CREDENTIAL_CACHE_LIFETIME_MS (8LL * 60 * 60 * 1000) // How long a verified password skips the KDF (one kiosk shift)
+#define ANTI_SNIPE_SECONDS 120 // A bid this close to an auction's end pushes the end to this long after the bid
+#define INITIAL_SCHEDULER_CAPACITY 64 // Starting capacity of the close scheduler's deadline heap
+#define IO_QUEUE_CAPACITY 64 // Slots in each I/O worker ring (power of two); also the limit on jobs in flight
+#define THUMBNAIL_SIZE 128 // Largest width/height of a decoded thumbnail (one atlas slot)
+#define THUMBNAIL_ATLAS_SIZE 1024 // Width and height of the thumbnail atlas texture
+#define THUMBNAIL_SLOT_COUNT ((THUMBNAIL_ATLAS_SIZE / THUMBNAIL_SIZE) * (THUMBNAIL_ATLAS_SIZE / THUMBNAIL_SIZE)) // Thumbnails the GPU holds at once
+#define THUMBNAIL_UPLOADS_PER_FRAME 4 // Decoded thumbnails copied into the atlas per frame at most
+#define LIST_THUMB_SIZE 40 // Size of the thumbnail drawn in a list row
+#define MAX_IMAGE_PATH 256 // Longest image path passed to the decoder
+#define MAX_SCREEN_WIDGETS 32 // Clickable widgets one screen can declare (one bit each in the widget grid)
+#define WIDGET_GRID_SIZE 8 // The widget grid splits the window into this many columns and rows
+#define INPUT_RECORD_MAGIC 0x43524941u // "AIRC": first four bytes of an input recording (--record)
+#define INPUT_RECORD_VERSION 1 // Bumped whenever the frame encoding changes
+#define INPUT_REPLAY_TIMESTEP (1.0 / 60.0) // Seconds of simulated time per replayed frame
+#define INPUT_MAX_CHARS 16 // Characters typed in one frame that are kept (raylib queues at most 16 too)
+#define INPUT_PASSWORD_PLACEHOLDER '*' // Recorded instead of each character typed into a password box
+#define CAPTURE_DIRECTORY "capture-data" // Working directory of --record and --replay (its own catalog.csv, images and users)
+#define CAPTURE_USER "replay" // Account every captured session starts with
+#define CAPTURE_PASSWORD "*****" // CAPTURE_USER's password: placeholders only, so a replay types exactly what was checked live
+#define INPUT_REPLAY_IO_TIMEOUT 30.0 // Seconds a replayed frame waits for the I/O results it expects
 
 // --- Custom Colors (using Raylib's CLITERAL for direct color definition) ---
 #define LIGHTGRAY_CUSTOM CLITERAL(Color){ 200, 200, 200, 255 } // Lighter gray for UI elements
@@ -35,17 +200,123 @@ typedef enum AppScreen {
     SCREEN_ITEM_DETAILS,  // Shows detailed information for a selected item
     SCREEN_PLACE_BID      // Screen for entering a new bid
 } AppScreen;
+#define SCREEN_COUNT (SCREEN_PLACE_BID + 1) // Number of AppScreen values
 
 // --- Structures ---
 
-// AuctionItem: Represents a single item up for auction
-typedef struct AuctionItem {
-    char name[MAX_NAME_LENGTH];      // Name of the item
-    char description[MAX_DESC_LENGTH]; // Detailed description
-    float currentBid;                  // The highest bid currently placed
-    char highestBidder[MAX_BIDDER_LENGTH]; // Name of the highest bidder
-    bool auctionClosed;                // True if the auction for this item is over
-} AuctionItem;
+// StringPool: Stores many null-terminated strings back-to-back in one growable buffer.
+// Strings are referenced by their byte offset, which stays valid when the buffer grows.
+typedef struct StringPool {
+    char* data;    // All strings, each followed by its null terminator
+    int size;      // Number of bytes currently in use
+    int capacity;  // Number of bytes allocated
+} StringPool;
+
+// ItemRenderCache: Formatted strings and text widths for one item, reused across frames.
+// Entries are rebuilt lazily the next time the item is drawn after being invalidated,
+// which only happens when the item's bid or status changes.
+typedef struct ItemRenderCache {
+    char bidLabel[14 + MAX_CENTS_TEXT]; // "Current Bid: $1500.00" for the item's current bid (the prefix plus any FormatCents text)
+    int bidLabelWidth;      // Width of bidLabel at the list font size (20), in window pixels
+    int bidLabelWidthLarge; // Width of bidLabel at the details/bid screen font size (25)
+    int titleWidth;         // Width of the item name at the title font size (40)
+    int itemLabelWidth;     // Width of "Item: <name>" at font size 25 (bid screen)
+    uint64_t bidState;      // Bid word the labels were built from; a different word means stale
+    int uiGeneration;       // ui.generation the widths were measured at; a different one means stale
+    int thumbSlot;          // Thumbnail cache slot holding the item's image (-1 if not cached)
+    bool valid;             // False if the entry must be rebuilt before use
+} ItemRenderCache;
+
+// ItemStore: Holds all auction items in structure-of-arrays layout.
+// The list screen touches the hot columns every frame, so they are kept small and
+// contiguous. Text that is only needed on the details screens lives in the cold
+// columns and in a separate string pool.
+typedef struct ItemStore {
+    // Hot columns
+    uint64_t* bidState;      // Current high bid of each item: cents << BID_BIDDER_BITS | bidder id (see PackBid)
+    bool* auctionClosed;     // True if the auction for the item is over
+    int64_t* endTime;        // Unix time in milliseconds the auction closes at (0 = no deadline)
+    int* nameOffset;         // Handle of the item's name in the 'names' pool
+    // Cold columns
+    int* descriptionOffset;  // Handle of the item's description in the 'descriptions' pool
+    int* imageOffset;        // Handle of the item's image path in the 'imagePaths' pool (-1 if none)
+    ItemRenderCache* renderCache; // Cached labels and measurements for drawing each item
+    int count;               // Number of items in the store
+    int capacity;            // Number of items the columns can hold before growing
+    StringPool names;        // Item names
+    StringPool descriptions; // Item descriptions (cold text, kept away from the names)
+    StringPool imagePaths;   // Image file of each item that has one
+} ItemStore;
+
+// ItemSortOrder: Row orders offered by the list screen.
+typedef enum ItemSortOrder {
+    SORT_LISTED = 0,  // Catalog order (item index)
+    SORT_HIGHEST_BID, // Highest current bid first, ties in catalog order
+    SORT_ENDING_SOON, // Open auctions by deadline, earliest first
+    SORT_ORDER_COUNT  // Number of orders (for cycling)
+} ItemSortOrder;
+
+// ItemTreap: A treap over all items in one sort order, with per-subtree item and open-item
+// counts so the k-th row of the order (optionally counting open items only) is selected
+// directly. Node i is item i; the per-node arrays are indexed by item (-1 = no child).
+typedef struct ItemTreap {
+    ItemSortOrder order;     // Order of the nodes (SORT_HIGHEST_BID or SORT_ENDING_SOON)
+    int* left;               // Left child of each node
+    int* right;              // Right child of each node
+    int* size;               // Items in each node's subtree
+    int* openSize;           // Open items in each node's subtree
+    int root;                // Root node, -1 if empty
+} ItemTreap;
+
+// ItemViews: Secondary indexes behind the sorted and filtered list views. They are updated
+// one item at a time as bids, deadline extensions and closes happen, so any row of any view
+// is found in O(log n) and switching views costs nothing.
+// - One treap ordered by bid and one ordered by deadline.
+// - A bitmap of closed items with a Fenwick tree over per-word open counts, so the k-th open
+//   item in catalog order can be selected directly.
+typedef struct ItemViews {
+    bool enabled;            // Maintained only by the UI (the headless server has no views)
+    ItemSortOrder sort;      // Current order of the list screen
+    bool openOnly;           // Hide closed auctions
+    int capacity;            // Items the per-item arrays can hold
+    ItemTreap byBid;         // Items by current bid
+    ItemTreap byEnd;         // Items by deadline
+    int64_t* key;            // Bid (cents) each item is filed under (may lag the bid word until reindexed)
+    int64_t* endKey;         // Deadline each item is filed under (may lag an extension until reindexed)
+    bool* keyClosed;         // Closed state each item is counted under
+    // Closed bitmap for catalog order
+    uint64_t* closedBits;    // One bit per item, set = closed (bits past the last item are set too)
+    int* openFenwick;        // Fenwick tree over the open count of each 64-item word (1-based)
+    int wordCapacity;        // Words in 'closedBits' (and Fenwick size)
+    int openCount;           // Open items in total
+} ItemViews;
+
+// PostingList: Indexes of the items whose text contains one trigram, in ascending order.
+typedef struct PostingList {
+    int* items;   // Item indexes (each item at most once)
+    int count;    // Items in the list
+    int capacity; // Items the list can hold before growing
+} PostingList;
+
+// ItemSearch: Trigram index over item names and descriptions behind the search box.
+// Text is lowercased and split into words, and every 3-byte window of each word padded as
+// "  word " is filed. A query word of three or more characters is looked up by its own
+// trigrams (substring match), a shorter one by its padded leading trigram (word prefix).
+// Candidates come from intersecting the posting lists, rarest first, and are confirmed
+// against the text, so a keystroke costs about the size of the rarest list, not a scan.
+typedef struct ItemSearch {
+    bool enabled;            // Maintained only by the UI (the headless server has no search box)
+    uint32_t* slotCodes;     // Trigram code + 1 stored in each slot, 0 = empty
+    PostingList* lists;      // Posting list of the trigram in the same slot
+    int slotCount;           // Number of slots (power of two)
+    int slotsUsed;           // Number of occupied slots
+    char query[MAX_INPUT_CHARS + 1]; // Query typed into the search box
+    bool active;             // True if the query has at least one word (the list shows results)
+    bool dirty;              // True if the results must be recomputed before use
+    int* results;            // Matching items in the current view's order
+    int resultCount;         // Number of matching items
+    int resultCapacity;      // Items 'results' can hold before growing
+} ItemSearch;
 
 // InputBox: A helper structure to manage a single text input field
 typedef struct InputBox {
@@ -57,115 +328,1298 @@ typedef struct InputBox {
     bool isPassword;             // New: True if this is a password field (for masking input)
 } InputBox;
 
+// PasswordScheme: How a stored password hash was produced.
+typedef enum PasswordScheme {
+    PASSWORD_LEGACY_DJB2 = 0, // Unsalted 32-bit djb2 from older versions; replaced at the user's next login
+    PASSWORD_SCRYPT = 1       // Salted scrypt with the cost parameters stored alongside
+} PasswordScheme;
+
+// PasswordHash: A stored credential. Each record carries its own salt and cost parameters,
+// so the KDF_* costs can be raised later without invalidating existing users.
+typedef struct PasswordHash {
+    uint8_t scheme;                      // PasswordScheme
+    uint8_t logN;                        // scrypt: N = 2^logN
+    uint8_t r;                           // scrypt: block size
+    uint8_t p;                           // scrypt: parallelism
+    uint32_t legacy;                     // PASSWORD_LEGACY_DJB2: the old hash value
+    uint8_t salt[PASSWORD_SALT_LENGTH];  // scrypt: per-user random salt
+    uint8_t key[PASSWORD_KEY_LENGTH];    // scrypt: derived key
+} PasswordHash;
+
 // User: Represents a registered user account
 typedef struct User {
     char username[MAX_NAME_LENGTH];      // User's chosen username
-    unsigned int hashedPassword;          // New: Stores the hashed version of the password
+    PasswordHash password;               // Salted hash of the user's password
 } User;
 
+// LegacyUserRecord: Record layout of version 1 USERS_DB_FILE files, read once for migration.
+typedef struct LegacyUserRecord {
+    char username[MAX_NAME_LENGTH]; // User's chosen username
+    uint32_t hashedPassword;        // djb2 hash of the password
+} LegacyUserRecord;
+
+// Sha256: Incremental SHA-256 state (used by HMAC/PBKDF2 inside scrypt).
+typedef struct Sha256 {
+    uint32_t state[8];   // Intermediate hash value
+    uint64_t length;     // Bytes hashed so far
+    uint8_t block[64];   // Partially filled input block
+    int used;            // Bytes in 'block'
+} Sha256;
+
+// UserIndex: Open-addressing (linear probing) hash table keyed on username.
+// Each slot holds a position in the 'users' array plus one, so zero means empty.
+// The table is kept at most half full so probe sequences stay short.
+typedef struct UserIndex {
+    int* slots;     // User array positions + 1 (0 = empty slot)
+    int slotCount;  // Number of slots, always a power of two
+    int used;       // Number of occupied slots
+} UserIndex;
+
+// UserSnapshot: The users and index to write into a snapshot file. SaveUsers points it at the
+// live directory; background compaction gives the worker its own copy.
+typedef struct UserSnapshot {
+    User* users;      // Records to write
+    int userCount;    // Number of records
+    UserIndex index;  // Username index saved alongside the records (binary format only)
+    bool binary;      // Write USERS_DB_FILE instead of USERS_FILE
+} UserSnapshot;
+
+// UserDatabaseHeader: Start of the binary USERS_DB_FILE. It is followed by 'recordCount'
+// User records and then by the 'slotCount' int slots of the username index, so both can be
+// used straight from a memory mapping. Values are stored in native byte order.
+typedef struct UserDatabaseHeader {
+    char magic[4];        // USER_DB_MAGIC
+    uint32_t version;     // USER_DB_VERSION
+    uint32_t recordSize;  // sizeof(User), rejects files written with a different layout
+    uint32_t recordCount; // Number of User records after the header
+    uint32_t slotCount;   // Number of index slots after the records (power of two)
+    uint32_t slotsUsed;   // Occupied index slots, restores UserIndex.used
+} UserDatabaseHeader;
+
+// BidRecord: One accepted bid as stored in BID_LEDGER_FILE (fixed size, native byte order).
+// Records are appended in acceptance order, so replaying them rebuilds every item's state.
+typedef struct BidRecord {
+    int64_t timestamp;                // Seconds since the Unix epoch when the bid was accepted
+    int64_t amount;                   // Accepted bid in cents
+    uint32_t itemId;                  // Position of the item in the item store
+    char bidder[MAX_BIDDER_LENGTH];   // Name of the bidder (ids are per process, so the file keeps names)
+    uint32_t checksum;                // HashBytes of everything above ^ BID_RECORD_CENTS_TAG, detects torn records
+} BidRecord;
+
+// LegacyBidRecord: Layout of BidRecord from before amounts were stored in cents. It has the
+// same size, and its checksum is not tagged, so ledgers written by older versions replay
+// unchanged and new records can be appended after them (see ReplayBidLedger).
+typedef struct LegacyBidRecord {
+    int64_t timestamp;
+    uint32_t itemId;
+    float amount;                     // Accepted bid in dollars
+    char bidder[MAX_BIDDER_LENGTH];
+    uint32_t reserved;
+    uint32_t checksum;                // HashBytes of everything above
+} LegacyBidRecord;
+typedef char BidRecordSizeCheck[(sizeof(BidRecord) == sizeof(LegacyBidRecord)) ? 1 : -1]; // Fails to compile if the layouts drift apart
+
+// PendingBid: An accepted bid waiting in the ledger batch. It holds the bidder id; the flush
+// thread looks the name up when it encodes the BidRecord, so the bid path copies no strings.
+typedef struct PendingBid {
+    int64_t timestamp; // Seconds since the Unix epoch when the bid was accepted
+    int64_t amount;    // Accepted bid in cents
+    uint32_t itemId;   // Position of the item in the item store
+    uint32_t bidderId; // Interned bidder name
+} PendingBid;
+
+// LedgerSegment: One ledger file with group commit. Bidding threads only append to the
+// in-memory 'pending' batch; a background thread swaps the batch out, writes it and
+// issues a single fsync for the whole batch.
+typedef struct LedgerSegment {
+    FILE* file;                  // Segment file opened for appending
+    char fileName[32];           // Name of the file, for messages
+    pthread_t flushThread;       // Background thread that commits batches
+    pthread_mutex_t lock;        // Guards 'pending', 'pendingCount' and 'running'
+    pthread_cond_t wake;         // Signals the flush thread (new bids or shutdown)
+    PendingBid* pending;         // Bids accepted but not yet handed to the flush thread
+    int pendingCount;            // Number of bids in 'pending'
+    int pendingCapacity;         // Capacity of 'pending'
+    bool running;                // False once CloseBidLedger asked the thread to stop
+    bool open;                   // True if the segment was opened successfully
+    int64_t committedBytes;      // Length of the intact, fsynced prefix of the file (under 'lock')
+    uint32_t identity;           // Checksum of the file's first record, 0 while it is empty (under 'lock')
+} LedgerSegment;
+
+// BidLedger: Durable bid history, split into segments by item id (item % segmentCount) so each
+// server shard commits its own bids to its own file. The UI uses a single segment.
+typedef struct BidLedger {
+    LedgerSegment segments[BID_LEDGER_MAX_SEGMENTS]; // Segment k is BID_LEDGER_FILE or BID_LEDGER_SEGMENT_FORMAT
+    int segmentCount;            // Segments receiving new bids
+    int64_t replayFrom[BID_LEDGER_MAX_SEGMENTS]; // Byte offset replay starts at in each segment (set by LoadCheckpoint)
+    uint32_t replayIdentity[BID_LEDGER_MAX_SEGMENTS]; // Identity each segment had at the snapshot; another file is replayed from 0
+    BidRecord* latest;           // Newest replayed bid per item id, for items that are still streaming in
+    bool* latestPresent;         // True if 'latest' holds a bid for that item id
+    int latestCount;             // Number of entries in 'latest' (highest replayed item id + 1)
+} BidLedger;
+
+// CheckpointHeader: Start of CHECKPOINT_FILE. It is followed by 'itemCount' CheckpointItem
+// records, each followed by its strings. 'ledgerOffsets' is how much of each ledger segment was
+// committed before the items were read, so every bid newer than the snapshot is after those
+// offsets. Values are stored in native byte order.
+typedef struct CheckpointHeader {
+    char magic[4];            // CHECKPOINT_MAGIC
+    uint32_t version;         // CHECKPOINT_VERSION
+    uint32_t itemCount;       // Records after the header
+    uint32_t recordSize;      // sizeof(CheckpointItem), rejects files written with a different layout
+    int64_t catalogSize;      // Size of CATALOG_FILE the items came from, -1 for the demo items
+    int64_t catalogModified;  // Its modification time (Unix seconds)
+    int64_t createdAt;        // Unix time in milliseconds the snapshot was started
+    int64_t ledgerOffsets[BID_LEDGER_MAX_SEGMENTS]; // Bytes of each segment already reflected in the items
+    uint32_t ledgerIdentities[BID_LEDGER_MAX_SEGMENTS]; // LedgerSegment.identity of each segment then (a rotated file has another)
+    uint32_t checksum;        // HashBytes of the header up to here and everything after it
+} CheckpointHeader;
+
+// CheckpointItem: One item of a snapshot. Its name, description, image path and highest bidder
+// follow it in that order, each with a terminating '\0' that the lengths do not count.
+typedef struct CheckpointItem {
+    int64_t amount;             // High bid in cents
+    int64_t endTime;            // Deadline in Unix milliseconds, 0 for none
+    uint16_t nameLength;        // Bytes of the name
+    uint16_t descriptionLength; // Bytes of the description
+    uint16_t imageLength;       // Bytes of the image path, 0 for none
+    uint8_t bidderLength;       // Bytes of the highest bidder's name
+    uint8_t closed;             // 1 if the auction is over
+} CheckpointItem;
+
+// Checkpointer: Background thread that snapshots the item store every
+// CHECKPOINT_INTERVAL_SECONDS while bids keep arriving. Bid words, deadlines and closed flags
+// are atomic and the rest of the store no longer changes once loaded, so the thread reads the
+// live columns in place: nothing is copied and bidding never pauses. A bid that lands during
+// the scan may or may not be in the snapshot, but it is always in the ledger tail after
+// 'ledgerOffsets', and replay only ever raises bids, so loading the snapshot and replaying the
+// tail rebuilds the same state.
+typedef struct Checkpointer {
+    pthread_t thread;         // Runs CheckpointThread
+    pthread_mutex_t lock;     // Guards 'running'
+    pthread_cond_t wake;      // Signalled to stop the thread
+    bool running;             // False once StopCheckpointer asked the thread to stop
+    bool started;             // True from StartCheckpointer until StopCheckpointer
+    bool attempted;           // True once StartCheckpointer ran, even if the thread failed to start (tried once only)
+    bool saved;               // True if 'savedOffsets' describes the snapshot on disk
+    int64_t savedOffsets[BID_LEDGER_MAX_SEGMENTS]; // Ledger position of the newest snapshot
+    uint32_t savedIdentities[BID_LEDGER_MAX_SEGMENTS]; // And the segment files it refers to
+    int64_t catalogSize;      // Fingerprint of the catalog the items came from (see CatalogFingerprint)
+    int64_t catalogModified;
+} Checkpointer;
+
+// CsvState: Where the catalog parser is inside the current CSV field.
+typedef enum CsvState {
+    CSV_FIELD_START = 0, // At the beginning of a field
+    CSV_UNQUOTED,        // Inside a plain field
+    CSV_QUOTED,          // Inside a "quoted" field (commas and newlines are literal)
+    CSV_QUOTE_IN_QUOTED  // Just saw a quote inside a quoted field: either "" or the closing quote
+} CsvState;
+
+// CatalogLoader: Streams CATALOG_FILE into the item store a chunk at a time. The parser is a
+// small state machine that survives chunk boundaries and writes straight into fixed field
+// buffers, so loading never allocates per field or holds more than one chunk in memory.
+typedef struct CatalogLoader {
+    FILE* file;                                          // Open catalog, NULL once finished
+    char chunk[CATALOG_CHUNK_SIZE];                      // Current block of raw file data
+    char fields[CATALOG_FIELD_COUNT][MAX_DESC_LENGTH];   // Fields of the record being parsed
+    int fieldLengths[CATALOG_FIELD_COUNT];               // Characters stored in each field
+    int fieldIndex;                                      // Field currently being filled
+    CsvState state;                                      // Parser state at the end of the last chunk
+    int recordsSeen;                                     // Records parsed so far, including the header
+    int skipped;                                         // Malformed records that were ignored
+    bool active;                                         // True while records are still being loaded
+} CatalogLoader;
+
+// ProfileEvent: One completed timed scope.
+typedef struct ProfileEvent {
+    const char* name; // Scope name (string literal)
+    double start;     // Seconds since the profiler epoch
+    double duration;  // Seconds spent inside the scope
+    int threadId;     // 1 for the UI thread, 2 for any other thread
+} ProfileEvent;
+
+// Profiler: Ring buffer of timed scopes plus recent frame times. Scopes are recorded with
+// ProfileBegin/ProfileEnd from any thread; the overlay and export run on the UI thread.
+typedef struct Profiler {
+    ProfileEvent events[PROFILER_MAX_EVENTS]; // Ring buffer of completed scopes
+    long long eventCount;                     // Scopes recorded since startup (ring index = count % max)
+    float frameTimes[PROFILER_FRAME_HISTORY]; // CPU time of the most recent drawn frames, in seconds
+    int frameCount;                           // Frames recorded since startup
+    pthread_mutex_t lock;                     // Guards 'events' and 'eventCount'
+    pthread_t mainThread;                     // Thread that called InitProfiler (the UI thread)
+    double epoch;                             // Clock value at InitProfiler
+    bool overlayVisible;                      // Toggled with F3
+} Profiler;
+
+// FrameArena: Bump allocator for data that only lives until the end of the current frame.
+// Allocation is a pointer increment, nothing is freed individually, and ResetFrameArena
+// after EndDrawing releases everything at once. The memory is static, so formatting on the
+// draw path never touches the heap. UI thread only.
+typedef struct FrameArena {
+    unsigned char memory[FRAME_ARENA_SIZE]; // Backing storage
+    size_t used;                            // Bytes handed out this frame
+    size_t lastUsed;                        // Bytes the previous frame used
+    size_t peak;                            // Most bytes any frame has used
+    int failedAllocations;                  // Requests this frame that did not fit
+} FrameArena;
+
+// UserRequestStatus: What RegisterUser or AuthenticateUser did with a request.
+typedef enum UserRequestStatus {
+    USER_REQUEST_FAILED = 0, // Rejected right away (name taken, another request in flight, queue full)
+    USER_REQUEST_PENDING,    // Queued; the outcome arrives through SetUIMessage when the worker finishes
+    USER_REQUEST_DONE        // Finished at once (sign-in matched the credential cache)
+} UserRequestStatus;
+
+// IoJobType: Work the UI thread hands to the I/O worker.
+typedef enum IoJobType {
+    IO_JOB_REGISTER = 0, // Hash a new user's password and durably append it to USERS_LOG_FILE
+    IO_JOB_VERIFY,       // Check a password against a stored hash (rehashing outdated ones)
+    IO_JOB_COMPACT       // Write a new user snapshot and empty the log
+} IoJobType;
+
+// IoJob: One unit of work. The same struct travels back on the result ring with 'ok' set.
+typedef struct IoJob {
+    IoJobType type;                  // What to do
+    char username[MAX_NAME_LENGTH];  // REGISTER/VERIFY: the user
+    char password[MAX_INPUT_CHARS + 1]; // REGISTER/VERIFY: plain password (wiped by the worker)
+    PasswordHash hash;               // REGISTER: result; VERIFY: stored hash in, replacement out if 'upgraded'
+    bool userFound;                  // VERIFY: false if the name is unknown (the hash still runs, for even timing)
+    UserSnapshot snapshot;           // IO_JOB_COMPACT: private copy of the directory (freed by the worker)
+    bool ok;                         // Result: true if the job succeeded (VERIFY: password matched)
+    bool upgraded;                   // Result (VERIFY): 'hash' was replaced with a current-cost scrypt hash
+    bool cacheable;                  // Result (VERIFY): 'credentialDigest' is set
+    uint8_t credentialDigest[32];    // Result (VERIFY): CredentialDigest of the password, for the credential cache
+    int logRecords;                  // Result: records in USERS_LOG_FILE after the job
+} IoJob;
+
+// SessionToken: Opaque handle of a signed-in session; the UI keeps nothing else about the user.
+typedef struct SessionToken {
+    uint8_t bytes[SESSION_TOKEN_LENGTH]; // Random, from FillRandom
+} SessionToken;
+
+// SessionSlotState: Occupancy of a session table slot.
+typedef enum SessionSlotState {
+    SESSION_SLOT_EMPTY = 0, // Never used: ends a probe sequence
+    SESSION_SLOT_LIVE,      // Holds a session
+    SESSION_SLOT_DELETED    // Signed out or expired: probing continues past it
+} SessionSlotState;
+
+// Session: One signed-in user.
+typedef struct Session {
+    SessionToken token;             // Key of the slot
+    uint32_t userId;                // Who signed in, as an interned name (the same id their bids carry)
+    int64_t expiresAt;              // WallClockMs() after which the token is refused
+    uint8_t state;                  // SessionSlotState
+} Session;
+
+// SessionTable: Open-addressing (linear probing) hash table of sessions keyed on the token.
+// Tokens are random, so their first four bytes are already a good hash.
+typedef struct SessionTable {
+    Session* slots; // slotCount entries
+    int slotCount;  // Power of two
+    int used;       // Live and deleted slots (both lengthen probes)
+} SessionTable;
+
+// CredentialCacheEntry: A sign-in that passed the KDF recently. 'digest' is a keyed HMAC of the
+// password and the stored hash, so a later sign-in with the same password costs one HMAC.
+typedef struct CredentialCacheEntry {
+    char username[MAX_NAME_LENGTH]; // Empty for an unused entry
+    uint8_t digest[32];             // CredentialDigest at the time of the verification
+    int64_t expiresAt;              // WallClockMs() after which the KDF runs again
+} CredentialCacheEntry;
+
+// CredentialCache: Direct-mapped cache of verified sign-ins, keyed with a per-process secret.
+typedef struct CredentialCache {
+    bool keyReady;                                        // 'key' has been drawn from FillRandom
+    uint8_t key[32];                                      // HMAC key, never stored anywhere
+    CredentialCacheEntry entries[CREDENTIAL_CACHE_SLOTS]; // Slot = HashUsername & (slots - 1)
+} CredentialCache;
+
+// IoRing: Single-producer/single-consumer ring of jobs. 'head' is only written by the
+// consumer and 'tail' only by the producer, so neither side ever takes a lock.
+typedef struct IoRing {
+    IoJob slots[IO_QUEUE_CAPACITY]; // Job storage
+    uint32_t head;                  // Next slot to read (consumer)
+    uint32_t tail;                  // Next slot to write (producer)
+} IoRing;
+
+// IoWorker: Background thread that runs file I/O so a slow disk never stalls a frame.
+// The UI thread produces on 'jobs' and consumes 'results'; the worker does the reverse.
+typedef struct IoWorker {
+    pthread_t thread;     // The worker thread
+    IoRing jobs;          // UI -> worker
+    IoRing results;       // Worker -> UI
+    pthread_mutex_t lock; // Only used to sleep/wake the worker when 'jobs' is empty
+    pthread_cond_t wake;  // Signalled when a job is posted or on shutdown
+    bool running;         // False asks the worker to finish the queue and exit
+    bool started;         // True if the thread exists; otherwise jobs run inline
+    int outstanding;      // Jobs posted whose results the UI has not consumed yet (UI thread only)
+} IoWorker;
+
+// BidStatus: Outcome of validating a bid. Shared by the local UI and the bid server.
+typedef enum BidStatus {
+    BID_ACCEPTED = 0, // The bid is now the highest bid on the item
+    BID_NO_NAME,      // No bidder name was given
+    BID_TOO_LOW,      // Not higher than the current bid
+    BID_TOO_LARGE,    // Above MAX_BID_CENTS
+    BID_CLOSED,       // The auction for the item is over
+    BID_UNKNOWN_ITEM, // No item with that id
+    BID_FAILED,       // The bid could not be processed (out of memory, or the server is overloaded)
+    BID_INVALID_AMOUNT // Not an amount ParseCents understands
+} BidStatus;
+
+// BidderRegistry: Interns bidder names to 32-bit ids so that an item's whole high bid fits
+// in one 64-bit word and can be replaced with a single compare-and-swap. Names are stored in
+// chunks that never move, so a published id can be resolved to its name without locking.
+typedef struct BidderRegistry {
+    char (*chunks[BIDDER_MAX_CHUNKS])[MAX_BIDDER_LENGTH]; // Name storage, allocated one chunk at a time
+    uint32_t count;           // Number of interned names (ids 0..count-1)
+    uint32_t* slots;          // Open-addressing name index: id + 1, or 0 for an empty slot
+    uint32_t slotCount;       // Number of slots (power of two, kept at most half full)
+    pthread_rwlock_t lock;    // Shared for lookups, exclusive while adding a name; never held during a bid
+} BidderRegistry;
+
+// Deadline: One entry of the close scheduler's heap. 'endTime' is the item's deadline when it
+// was scheduled; anti-sniping can only move the real deadline later.
+typedef struct Deadline {
+    int64_t endTime; // Unix time in milliseconds
+    int itemIndex;   // Item the deadline belongs to
+} Deadline;
+
+// CloseScheduler: Binary min-heap of the deadlines of open auctions (all of them in the UI,
+// one shard's items on the server). Each frame (or shard wake-up) pops only the deadlines that are due, so closing costs O(log n) per auction and
+// nothing while none is due. An extended deadline is found stale when it surfaces and is
+// pushed again with its new time instead of being looked up and moved inside the heap.
+typedef struct CloseScheduler {
+    bool enabled;     // True in the process that owns the auctions (not in --connect mode); only read on closeScheduler
+    Deadline* heap;   // heap[0] has the earliest deadline
+    int count;        // Deadlines in the heap
+    int capacity;     // Deadlines the heap can hold before growing
+} CloseScheduler;
+
+// NetMessageType: Message kinds of the bid protocol. Every message is framed as
+// [u8 payload length][u8 type][payload]; integers are little-endian, amounts are u64 cents,
+// strings are [u8 length][bytes]. Clients only hear about the items they subscribed to. A bid
+// word is PackBid(amount, server bidder id); each name crosses the link once, in NET_MSG_BIDDER.
+typedef enum NetMessageType {
+    NET_MSG_ITEM_STATE = 1, // Server -> client: u32 item, u64 bid word, u8 closed, u64 end time (on subscribe, close, extension)
+    NET_MSG_BID,            // Client -> server: u32 request, u32 item, u64 amount, str bidder
+    NET_MSG_BID_RESULT,     // Server -> client: u32 request, u8 BidStatus, u64 current bid
+    NET_MSG_BID_UPDATE,     // Retired (per-bid broadcast with a name string); the number stays reserved
+    NET_MSG_SUBSCRIBE,      // Client -> server: u32 item per id, up to NET_IDS_PER_MESSAGE (adds them to the client's set)
+    NET_MSG_UNSUBSCRIBE,    // Client -> server: u32 item per id (removes them from the set)
+    NET_MSG_BIDDER,         // Server -> client: u32 server bidder id, str name (sent once, before the first bid word using it)
+    NET_MSG_BID_DELTAS      // Server -> client: [u32 item][u64 bid word], up to NET_DELTAS_PER_MESSAGE
+} NetMessageType;
+
+// NetBuffer: Growable byte queue for one direction of a connection.
+typedef struct NetBuffer {
+    unsigned char* data; // Queued bytes
+    int size;            // Bytes currently queued
+    int capacity;        // Bytes allocated
+} NetBuffer;
+
+// NetReader: Bounds-checked cursor over one received message payload.
+typedef struct NetReader {
+    const unsigned char* data; // Next unread byte
+    int remaining;             // Bytes left in the payload
+    bool ok;                   // False once a read ran past the end
+} NetReader;
+
+// NetConnection: A non-blocking TCP socket with its input and output queues.
+typedef struct NetConnection {
+    int socket;    // Socket descriptor, -1 if closed
+    NetBuffer in;  // Received bytes not yet parsed into messages
+    NetBuffer out; // Encoded messages not yet sent
+} NetConnection;
+
+// ItemDirtyFlags: What changed about an item during one server pass (BidServer.dirtyItems).
+typedef enum ItemDirtyFlags {
+    ITEM_DIRTY_BID = 1 << 0,  // New high bid: subscribers get a delta
+    ITEM_DIRTY_STATE = 1 << 1 // Closed or deadline extended: subscribers get the full item state
+} ItemDirtyFlags;
+
+// ServerClient: One connected client and what it follows.
+typedef struct ServerClient {
+    NetConnection connection;                         // Link to the client
+    uint32_t subscriptions[NET_MAX_SUBSCRIPTIONS];    // Subscribed item ids, ascending
+    int subscriptionCount;
+    uint32_t* sentBidders;                            // Bit per server bidder id whose name the client has
+    int sentBidderWords;                              // Length of 'sentBidders' in 32-bit words
+    uint32_t id;                                      // Stable id that shard results are addressed to (ascending in 'clients')
+} ServerClient;
+
+// ShardMessage: A bid on its way to the item's shard, or what came of it on the way back.
+// Closes found by a shard come back as results with no client.
+typedef struct ShardMessage {
+    uint32_t clientId;               // ServerClient.id to answer, 0 for a close
+    uint32_t requestId;              // Echoed in NET_MSG_BID_RESULT
+    int itemIndex;                   // Item the bid is for (always owned by the shard)
+    int64_t amount;                  // Request: offered amount. Result: the item's high bid afterwards
+    uint8_t status;                  // Result: BidStatus
+    uint8_t dirty;                   // Result: ItemDirtyFlags for the item's subscribers, 0 if nothing changed
+    char bidder[MAX_BIDDER_LENGTH];  // Request: bidder name
+} ShardMessage;
+
+// ShardRing: Single-producer single-consumer queue between the network thread and one shard,
+// the same lock-free scheme as IoRing.
+typedef struct ShardRing {
+    ShardMessage slots[SHARD_QUEUE_CAPACITY]; // Message storage
+    uint32_t head;                            // Next slot to read (consumer)
+    uint32_t tail;                            // Next slot to write (producer)
+} ShardRing;
+
+// BidShard: One bid worker of the server. Items are partitioned by id (item % shardCount) and
+// only an item's shard applies bids to it or closes it, so bids on one item are applied in the
+// order they arrived; bids on items of different shards run in parallel. The shard also owns
+// its items' deadlines and ledger segment (the ledger splits by the same rule).
+typedef struct BidShard {
+    pthread_t thread;          // Runs ShardThread
+    pthread_mutex_t lock;      // Guards 'running' and the sleep on 'wake'
+    pthread_cond_t wake;       // Signalled for new requests, a flush batch or shutdown
+    ShardRing requests;        // Bids from the network thread, in arrival order
+    ShardRing results;         // Outcomes and closes for the network thread
+    CloseScheduler scheduler;  // Deadlines of this shard's items
+    uint32_t flushGeneration;  // Last flush batch this shard took part in
+    int index;                 // Position in BidServer.shards
+    bool running;              // False once the network thread asked the shard to stop
+    bool started;              // True if the thread was created
+    bool wakePending;          // Network thread only: requests were queued this pass
+} BidShard;
+
+// FlushSlice: The range of clients one participant of a flush batch starts with. Indices are
+// claimed with an atomic fetch-add on 'next', by the owner and by participants that ran out
+// of their own work and steal from it.
+typedef struct FlushSlice {
+    int next; // Next unclaimed client index
+    int end;  // One past the last client of the slice
+} FlushSlice;
+
+// BidServer: Headless server that owns the authoritative item state (--server mode). The
+// network thread does all socket I/O and parsing and hands bids to the item's shard. Changes
+// reported back during a poll pass are collected in the dirty list and sent once at the end of
+// the pass, each client getting only the items it subscribed to; with many clients that
+// fan-out is split among the network thread and the shards, which steal from each other.
+typedef struct BidServer {
+    int listenSocket;           // Socket accepting new clients
+    ServerClient* clients;      // Connected clients
+    int clientCount;            // Number of connected clients
+    int clientCapacity;         // Capacity of 'clients'
+    uint32_t nextClientId;      // Id given to the next accepted client
+    struct pollfd* pollSet;     // Scratch array for poll(): the listener, the wake pipe, then one entry per client
+    uint8_t* dirtyItems;        // ItemDirtyFlags per item for the current pass
+    int* dirtyList;             // Items with dirtyItems != 0, in the order they changed
+    int dirtyCount;
+    BidShard* shards;           // Bid workers, one per partition of the items
+    int shardCount;             // Number of shards (0 outside --server)
+    int wakePipe[2];            // Shards write a byte to [1] when they post results; [0] is polled
+    FlushSlice* flushSlices;    // One per shard plus the network thread's (the last)
+    uint32_t flushGeneration;   // Bumped to start a flush batch (atomic)
+    int flushPending;           // Shards still working on the batch
+    pthread_mutex_t flushLock;  // Guards 'flushPending'
+    pthread_cond_t flushDone;   // Signalled when the last shard finishes the batch
+} BidServer;
+
+// NetClient: Connection from the UI to a bid server (--connect mode).
+typedef struct NetClient {
+    NetConnection connection; // Link to the server
+    bool connected;           // True while the link is up
+    uint32_t nextRequestId;   // Id attached to the next bid, echoed in its result
+    uint32_t subscriptions[NET_MAX_SUBSCRIPTIONS]; // Item ids the server sends updates for, ascending
+    int subscriptionCount;
+    uint32_t* bidderIds;      // Local bidder id for each server bidder id, BIDDER_NONE if not named yet
+    uint32_t bidderIdCount;   // Length of 'bidderIds'
+} NetClient;
+
+// DrawCommandType: Primitives a screen's static layout is recorded as.
+typedef enum DrawCommandType {
+    DRAW_FILL = 0,     // Filled rectangle
+    DRAW_OUTLINE,      // Rectangle outline, 2 pixels thick
+    DRAW_TEXT,         // Text with the UI font atlas of its size
+    DRAW_COMMAND_TYPES // Number of command types
+} DrawCommandType;
+
+// DrawCommand: One recorded primitive. Positions and text widths are resolved when the list
+// is built, so submitting it does no layout work.
+typedef struct DrawCommand {
+    DrawCommandType type;
+    Rectangle rect;       // Rectangle to fill or outline; for text only x and y are used
+    Color color;
+    const char* text;     // Text to draw (a string literal), DRAW_TEXT only
+    int fontSize;         // Design size (see UI_FONT_SIZES), DRAW_TEXT only
+} DrawCommand;
+
+// WidgetAction: What clicking a widget does. The update pass of the widget's screen carries it out.
+typedef enum WidgetAction {
+    ACTION_NONE = 0,      // No widget was clicked
+    ACTION_OPEN_SIGN_IN,  // Auth menu: go to the sign-in screen
+    ACTION_OPEN_SIGN_UP,  // Auth menu: go to the sign-up screen
+    ACTION_LOGIN,         // Sign-in: check the credentials
+    ACTION_REGISTER,      // Sign-up: create the account
+    ACTION_BACK,          // Return to the previous screen
+    ACTION_CYCLE_SORT,    // Item list: next sort order
+    ACTION_TOGGLE_FILTER, // Item list: all items / open items only
+    ACTION_LOGOUT,        // Item list: sign out
+    ACTION_OPEN_BID,      // Item details: go to the place-bid screen
+    ACTION_SUBMIT_BID,    // Place bid: validate and place the bid
+    ACTION_CANCEL_BID     // Place bid: back to the details without bidding
+} WidgetAction;
+
+// Widget: A clickable area of a screen, declared once by BuildScreenLayout for both passes.
+typedef struct Widget {
+    Rectangle rect;       // Area that reacts to the mouse (the button's drawn rectangle)
+    WidgetAction action;  // Carried out by the screen's update pass when clicked
+} Widget;
+
+// DrawList: The retained titles and buttons of one screen, and the table of its clickable
+// widgets. It is rebuilt only when the window size or the screen's layout key (see
+// ScreenLayoutKey) differs from the ones it was built for.
+typedef struct DrawList {
+    DrawCommand* commands; // Grouped by type, see SortDrawList
+    int count;
+    int capacity;
+    Widget widgets[MAX_SCREEN_WIDGETS]; // Clickable widgets in declaration order
+    int widgetCount;
+    uint32_t widgetGrid[WIDGET_GRID_SIZE * WIDGET_GRID_SIZE]; // Per window cell: bit i set if widget i overlaps it
+    int width;             // Window size the list was built for
+    int height;
+    int key;               // Layout key the list was built for
+    bool built;            // False until the first build
+} DrawList;
+
+#if !defined(AUCTION_HEADLESS)
+// UiFont: One UI text size, baked into its own atlas at the current scale, so it is drawn at
+// the size it was rasterized at. Measuring printable ASCII only sums 'advance'.
+typedef struct UiFont {
+    Font font;             // Atlas baked from UI_FONT_FILE, or raylib's default font
+    float pixelSize;       // Height the text is drawn at (design size times the UI scale)
+    float spacing;         // Pixels added after every glyph but the last (DrawText uses size / 10)
+    float advance[UI_FONT_GLYPH_COUNT]; // Horizontal advance of each printable ASCII glyph at pixelSize
+    bool baked;            // True if 'font' was loaded from UI_FONT_FILE and must be unloaded
+} UiFont;
+
+// UiLayout: How design pixels map to the window. Rebuilt by UpdateUiScale when the window
+// size changes; the fonts only when the rounded scale does.
+typedef struct UiLayout {
+    float scale;           // Window pixels per design pixel
+    int width;             // Window size the scale was computed for
+    int height;
+    UiFont fonts[UI_FONT_SIZE_COUNT]; // One per entry of UI_FONT_SIZES
+    int generation;        // Bumped whenever the scale changes; text widths measured under another one are stale
+    bool ready;            // False until the fonts are loaded
+} UiLayout;
+#endif
+
+// PointerState: The mouse as sampled once at the start of a frame, and what it is over on the
+// current screen. The update pass reads the click from here and the draw pass the hover, so
+// neither queries raylib or hit-tests again.
+typedef struct PointerState {
+    Vector2 position;     // Cursor position this frame
+    bool pressed;         // True if the left button went down this frame
+    AppScreen screen;     // Screen the fields below were resolved on
+    float scrollOffset;   // listScrollOffset hoveredRow was resolved at
+    int hoveredWidget;    // Index in the screen's widget table, -1 if none
+    WidgetAction clicked; // Action of the widget pressed this frame, ACTION_NONE if none
+    int hoveredRow;       // List row under the cursor (-1 if none or not on the list screen)
+} PointerState;
+
+// InputKey: Keys the application reacts to, as bit numbers in FrameInput.keys.
+typedef enum InputKey {
+    INPUT_KEY_BACKSPACE = 0, // Deletes in an input box
+    INPUT_KEY_ENTER,         // Leaves an input box
+    INPUT_KEY_PAGE_UP,       // Scrolls the list
+    INPUT_KEY_PAGE_DOWN,
+    INPUT_KEY_F3,            // Profiler overlay
+    INPUT_KEY_F12,           // Trace export
+    INPUT_KEY_COUNT
+} InputKey;
+
+// InputFrameFlags: First byte of every recorded frame; says which fields follow it, in this order.
+typedef enum InputFrameFlags {
+    INPUT_FRAME_ACTIVITY = 1 << 0,     // Any input at all, including resizes (repaints); no payload
+    INPUT_FRAME_LEFT_PRESSED = 1 << 1, // The left button went down; no payload
+    INPUT_FRAME_MOUSE = 1 << 2,        // The cursor moved: u32 holding i16 x (low half) and i16 y
+    INPUT_FRAME_WHEEL = 1 << 3,        // u32 IEEE-754 bits of the wheel movement
+    INPUT_FRAME_KEYS = 1 << 4,         // u8 InputKey bits of the keys pressed
+    INPUT_FRAME_CHARS = 1 << 5,        // u8 count, then a u32 per typed codepoint
+    INPUT_FRAME_IO = 1 << 6            // u8 number of I/O results applied in the frame
+} InputFrameFlags;
+
+// FrameInput: Everything the UI reads from the mouse and keyboard in one frame. SampleInput
+// fills it once per frame, from raylib or from a recording, and nothing else asks raylib.
+typedef struct FrameInput {
+    double time;                 // Clock the frame runs at (fixed steps during a replay)
+    Vector2 mouse;               // Cursor position in whole pixels
+    bool leftPressed;            // The left button went down this frame
+    float wheel;                 // Mouse wheel movement
+    uint8_t keys;                // Bit (1 << InputKey) set for each key pressed this frame
+    int chars[INPUT_MAX_CHARS];  // Characters typed this frame, in order
+    int charCount;
+    bool activity;               // HasInputActivity() was true
+    bool passwordFocus;          // A password box had focus when the frame was sampled
+    int ioResults;               // I/O results applied this frame (a replay applies as many)
+} FrameInput;
+
+// InputRecording: State of --record, which appends every frame's input to a file, or of
+// --replay, which feeds a recorded session back frame by frame.
+typedef struct InputRecording {
+    bool recording;          // --record is active
+    bool replaying;          // --replay is active
+    bool render;             // Replayed frames are drawn (false with --no-render)
+    FILE* file;              // --record: output file
+    NetBuffer encoded;       // --record: scratch buffer for one encoded frame
+    void* data;              // --replay: mapped recording
+    size_t size;             // --replay: size of 'data'
+    NetReader reader;        // --replay: position of the next frame
+    Vector2 lastMouse;       // Cursor of the previous frame; positions are only stored when they change
+    double startTime;        // --replay: clock of the first frame
+    long long frames;        // Frames recorded or replayed so far
+    double frameWait;        // --replay: seconds this frame spent waiting for the I/O worker
+    float* frameTimes;       // --replay: CPU time of every frame, for the summary
+    int frameTimeCount;
+    int frameTimeCapacity;
+} InputRecording;
+
+// ThumbnailState: Lifecycle of a thumbnail cache slot.
+typedef enum ThumbnailState {
+    THUMB_EMPTY = 0, // Slot holds nothing
+    THUMB_LOADING,   // Image is queued for or being decoded
+    THUMB_READY,     // Image is in the atlas
+    THUMB_FAILED     // Item's image file is missing or could not be decoded
+} ThumbnailState;
+
+// ThumbnailSlot: One fixed-size cell of the thumbnail atlas.
+typedef struct ThumbnailSlot {
+    int itemIndex;        // Item whose thumbnail the slot holds (-1 if none)
+    ThumbnailState state; // What the slot currently holds
+    uint64_t lastUsed;    // Frame the thumbnail was last drawn in (LRU key)
+    int width;            // Size of the image inside the cell
+    int height;
+} ThumbnailSlot;
+
+// DecodeJob: An image to decode for a slot, and its result once decoded.
+typedef struct DecodeJob {
+    int slot;                   // Cache slot the image is loaded for
+    int itemIndex;              // Item the slot belonged to when the job was posted
+    char path[MAX_IMAGE_PATH];  // Image file to decode
+    Image image;                // Decoded RGBA8 image no larger than THUMBNAIL_SIZE (data NULL on failure)
+} DecodeJob;
+
+// ThumbnailCache: Item images kept in one atlas texture, so GPU memory is bounded by
+// THUMBNAIL_SLOT_COUNT cells and a page of thumbnails is drawn from a single texture. Only rows
+// being drawn request images; the least recently drawn cell is reused for a new one. Files are
+// decoded on a background thread and copied into the atlas by the UI thread a few per frame.
+typedef struct ThumbnailCache {
+    Texture2D atlas;          // THUMBNAIL_ATLAS_SIZE square texture holding every cell
+    bool atlasReady;          // True once the atlas texture has been created
+    ThumbnailSlot slots[THUMBNAIL_SLOT_COUNT]; // Cell i sits at column i % 8, row i / 8
+    uint64_t frame;           // Frames drawn so far (the LRU clock)
+    int outstanding;          // Jobs posted whose results have not been uploaded yet (UI thread only)
+    pthread_t thread;         // Decoder thread
+    pthread_mutex_t lock;     // Guards requests, results and running
+    pthread_cond_t wake;      // Signalled when a request is posted or the decoder must stop
+    DecodeJob requests[THUMBNAIL_SLOT_COUNT]; // Jobs not picked up yet (newest last, taken first)
+    int requestCount;
+    DecodeJob results[THUMBNAIL_SLOT_COUNT];  // Decoded images waiting for upload (oldest first)
+    int resultCount;
+    bool running;             // Cleared to stop the decoder
+    bool started;             // True if the decoder thread was started
+} ThumbnailCache;
+
+// BenchWorker: One bid-submitting thread of --bench and what it measured.
+typedef struct BenchWorker {
+    pthread_t thread;
+    int id;                   // Thread number, part of its bidder names
+    int itemCount;            // Bids go to items [0, itemCount)
+    int bidCount;             // Bids to submit
+    uint64_t seed;            // BenchRandom state
+    double* latencies;        // Seconds each SubmitBid took
+    int accepted;             // Bids that became the high bid
+    int outbid;               // BID_TOO_LOW: another thread raised the item first
+    int failed;               // Any other status
+} BenchWorker;
+
 // --- Global Variables ---
-AuctionItem items[MAX_ITEMS]; // Array to hold all auction items
-int itemCount = 0;            // Current number of active auction items
+ItemStore items = { 0 };      // Column store holding all auction items
+ItemViews itemViews = { .byBid = { .order = SORT_HIGHEST_BID, .root = -1 }, .byEnd = { .order = SORT_ENDING_SOON, .root = -1 } }; // Sorted and filtered views of the item list
+ItemSearch itemSearch = { 0 }; // Trigram index and results of the list screen's search box
 int selectedItemIndex = -1;   // Index of the item currently selected/viewed (-1 if none)
+float listScrollOffset = 0.0f; // How far (in pixels) the item list is scrolled down
 AppScreen currentScreen = SCREEN_AUTH_MENU; // The application starts at the authentication menu
 
 // User management variables
-User users[MAX_USERS];        // Array to hold registered users
+User* users = NULL;           // Growable array holding registered users
 int userCount = 0;            // Current number of registered users
-char loggedInUsername[MAX_NAME_LENGTH] = ""; // Stores username of the currently logged-in user
+int userCapacity = 0;         // Number of users the array can hold before growing
+UserIndex userIndex = { 0 };  // Username -> user array position lookup
+FILE* userLogFile = NULL;     // Open handle on USERS_LOG_FILE (opened on first registration)
+int userLogRecords = 0;       // Records in USERS_LOG_FILE that are not in the snapshot yet
+bool binaryUserDatabase = false; // True if snapshots are kept in USERS_DB_FILE instead of USERS_FILE
+bool userRequestPending = false; // True while a registration or sign-in waits for the I/O worker
+IoWorker ioWorker = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER }; // Runs file I/O off the UI thread
+void* userDatabaseMapping = NULL; // Mapped USERS_DB_FILE that 'users' and 'userIndex' point into (NULL if on the heap)
+size_t userDatabaseMappingSize = 0; // Size in bytes of userDatabaseMapping
+
+BidLedger bidLedger = { 0 };  // Durable record of all accepted bids
+Checkpointer checkpointer = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER }; // Periodic snapshots of the item store
+BidderRegistry bidders = { .lock = PTHREAD_RWLOCK_INITIALIZER }; // Interned bidder names referenced by bid words
+CatalogLoader catalogLoader = { 0 }; // Incremental loader state for CATALOG_FILE
+Profiler profiler = { .lock = PTHREAD_MUTEX_INITIALIZER }; // Timed scopes and frame times
+FrameArena frameArena = { 0 }; // Scratch memory reset after every frame
+BidServer bidServer = { .listenSocket = -1, .wakePipe = { -1, -1 } }; // State of --server mode
+NetClient netClient = { .connection = { .socket = -1 } }; // State of --connect mode
+CloseScheduler closeScheduler = { 0 }; // Deadlines of the open auctions
+DrawList screenLayouts[SCREEN_COUNT] = { 0 }; // Retained static layout of each screen
+PointerState pointer = { .hoveredWidget = -1, .hoveredRow = -1 }; // Mouse state shared by the update and draw passes
+FrameInput frameInput = { 0 }; // This frame's mouse and keyboard input (see SampleInput)
+InputRecording inputRecording = { 0 }; // State of --record / --replay
+ThumbnailCache thumbnails = { .lock = PTHREAD_MUTEX_INITIALIZER, .wake = PTHREAD_COND_INITIALIZER }; // Item images on the GPU
+#if !defined(AUCTION_HEADLESS)
+UiLayout ui = { .scale = 1.0f }; // UI scale and the font atlases baked for it
+const int UI_FONT_SIZES[UI_FONT_SIZE_COUNT] = { 15, 20, 25, 30, 40 }; // Design sizes of UI text, indexed like ui.fonts
+#endif
+volatile sig_atomic_t serverStopRequested = 0; // Set by SIGINT/SIGTERM to stop the server loop
+int benchStartFlag = 0; // Set (atomically) once every benchmark bid thread exists
+#if defined(AUCTION_HEADLESS)
+int headlessLogLevel = LOG_INFO; // TraceLog drops messages below this level (SetTraceLogLevel)
+#endif
+
+// Profiler scope names for each screen's draw block, indexed by AppScreen
+const char* SCREEN_DRAW_SCOPES[] = { "Draw Auth Menu", "Draw Sign In", "Draw Sign Up", "Draw Item List", "Draw Item Details", "Draw Place Bid" };
+uint32_t loggedInUserId = BIDDER_NONE; // Interned name of the signed-in user, resolved only for display
+SessionToken currentSession = { 0 }; // Token issued at sign-in, valid while loggedInUserId is set
+SessionTable sessions = { 0 }; // Every live session, looked up by token
+CredentialCache credentialCache = { 0 }; // Recently verified sign-ins
 
 // Input boxes for various screens (declared globally for easy access and reset)
 InputBox bidAmountInput;
-InputBox bidderNameInput;
 InputBox signInUsernameInput;
 InputBox signInPasswordInput;
 InputBox signUpUsernameInput;
 InputBox signUpPasswordInput;
 InputBox signUpConfirmPasswordInput;
+InputBox searchInput;
 
 // UI Message display variables
 char uiMessage[100] = "";     // Buffer to store temporary messages for the user
 float uiMessageTimer = 0.0f;  // Timer for how long the message should be displayed
 const float UI_MESSAGE_DURATION = 3.0f; // Message display duration in seconds
 
+// Redraw scheduling (the screen is only repainted when something visible changed)
+bool redrawRequested = true;  // True if the next loop iteration must repaint the screen
+int lastCursorBlinkPhase = -1; // Cursor blink phase (half-seconds) shown by the last repaint
+int64_t lastCountdownSecond = -1; // Wall-clock second shown by the last repaint's countdown
+
 // --- Function Prototypes ---
 // Declaring functions before their implementation allows for better code organization.
-void InitAuctionData(); // Initializes dummy data for auction items
-void DrawItemListItem(int index, int x, int y, int width, int height); // Draws a single item in the list view
+void InitAuctionData(bool restore); // Restores CHECKPOINT_FILE if 'restore' and it matches the catalog, else streams CATALOG_FILE or adds demo items
+bool OpenCatalog(const char* fileName); // Prepares the catalog loader for 'fileName'
+bool PumpCatalogLoader(double budgetSeconds); // Loads catalog chunks for up to 'budgetSeconds', true if items were added
+void ParseCatalogChunk(const char* data, int length); // Feeds raw catalog bytes through the CSV state machine
+void FinishCatalogRecord(); // Turns the parsed fields into an item
+void CloseCatalog(); // Stops loading and closes the catalog file
+void FreeAuctionData(); // Releases all memory owned by the item store
+bool ReserveItems(int capacity); // Grows the item store so it can hold at least 'capacity' items
+int AddAuctionItem(const char* name, const char* description, int64_t currentBid, const char* highestBidder, bool auctionClosed, int64_t endTime); // Appends an item, returns its index or -1
+const char* GetItemName(int index); // Returns the name of an item from the string pool
+const char* GetItemDescription(int index); // Returns the description of an item from the string pool
+const ItemRenderCache* GetItemRenderCache(int index); // Returns an item's render cache, rebuilding it if stale
+void InvalidateItemRender(int index); // Marks an item's render cache stale after its bid or status changed
+int StringPoolAdd(StringPool* pool, const char* text); // Copies a string into a pool, returns its handle or -1
+void DrawItemListItem(int index, int row, int x, int y, int width, int height); // Draws a single item in the list view
+void GetVisibleItemRange(int* first, int* last); // Computes the rows inside the list viewport [first, last)
+int CollectShownItems(uint32_t* ids, int capacity); // Items the current screen shows, for the server subscription
+int ItemRowAtPoint(Vector2 point); // Maps a point to the list row under it, -1 if none
+void ScrollItemList(float deltaPixels); // Scrolls the list, clamped to its content
 void DrawInputBox(InputBox* box, const char* label); // Draws an input box with a label
 void UpdateInputBox(InputBox* box); // Handles keyboard input for an active input box
-bool IsMouseOver(Rectangle rect); // Checks if the mouse cursor is over a given rectangle
 void ResetInputBoxes(); // Clears and deactivates all input boxes for a clean state
 void SetUIMessage(const char* message); // Displays a temporary message to the user
+void RequestRedraw(); // Marks the screen dirty so the next loop iteration repaints it
+bool HasInputActivity(); // True if the user moved the mouse, clicked, scrolled, typed or resized
+bool IsAnyInputBoxActive(); // True if some input box is focused (its cursor is blinking)
+bool IsPasswordBoxActive(); // True if one of the password boxes is focused
+void WaitForRedrawTrigger(); // Sleeps until input arrives or the next timed change is due
+
+// Input Recording Functions
+bool SampleInput(double now); // Fills frameInput for this frame; false once a replay has run out of frames
+void SampleLiveInput(double now); // Reads this frame's input from raylib
+bool FrameKeyPressed(InputKey key); // True if 'key' was pressed this frame
+bool StartInputRecording(const char* fileName); // --record: creates the file and writes its header
+bool StartInputReplay(const char* fileName, bool render); // --replay: maps a recording and checks its header
+void StopInputRecording(); // Closes the recording, or ends a replay and reports its frame times
+void WriteRecordedFrame(); // Appends frameInput to the recording
+bool ReadRecordedFrame(); // Decodes the next recorded frame into frameInput, false at the end
+void WaitForIoResults(int count); // Replay: applies as many I/O results as the recorded frame did
+void RecordReplayFrame(double seconds); // Replay: keeps one frame's CPU time for the summary
+bool EnterCaptureDirectory(); // Moves a captured session into CAPTURE_DIRECTORY and clears its users
+bool AddCaptureUser(); // Registers CAPTURE_USER for the session (in memory only)
+
+// Screen Layout Functions
+void SubmitScreenLayout(AppScreen screen); // Draws a screen's titles and buttons
+DrawList* PrepareScreenLayout(AppScreen screen); // Returns a screen's draw list and widgets, rebuilding them if stale
+int ScreenLayoutKey(AppScreen screen); // State (besides the window size) a screen's layout depends on
+void BuildScreenLayout(AppScreen screen, DrawList* list, int key); // Records a screen's titles and buttons
+void AddButton(DrawList* list, WidgetAction action, Rectangle rect, const char* label, int fontSize, Color fill, Color textColor); // Records a button and its widget
+void AddWidget(DrawList* list, WidgetAction action, Rectangle rect); // Declares a clickable area and files it in the widget grid
+int WidgetAtPoint(const DrawList* list, Vector2 point); // Index of the widget under a point, -1 if none
+void SamplePointer(); // Reads the mouse once for the frame
+void ResolvePointer(AppScreen screen); // Finds the widget and list row under the sampled cursor
+void AddCenteredText(DrawList* list, const char* text, int centerX, int y, int fontSize, Color color); // Records a centered label
+void PushDrawCommand(DrawList* list, DrawCommand command); // Appends a command to a draw list
+void SortDrawList(DrawList* list); // Groups a draw list's commands by primitive type
+void FreeScreenLayouts(); // Releases every screen's draw list
+
+#if !defined(AUCTION_HEADLESS)
+// UI Scaling Functions
+void UpdateUiScale(); // Follows the window size: new scale, fonts and input box positions when it changed
+void LayoutInputBoxes(); // Places the input boxes for the current window size and scale
+void LoadUiFonts(float scale); // Bakes one atlas per UI text size and caches its glyph advances
+void UnloadUiFonts(); // Releases the baked atlases (call before CloseWindow)
+int UiPx(int designPixels); // Converts a design length to window pixels at the current scale
+const UiFont* UiFontFor(int designSize); // Atlas of the UI text size closest to 'designSize'
+int MeasureUiText(const char* text, int designSize); // Width of 'text' in window pixels, from the cached advances
+void DrawUiText(const char* text, int x, int y, int designSize, Color color); // Draws text with its size's atlas at a window position
+#endif
+
+// Item View Functions
+void EnableItemViews(); // Builds the view indexes for the items loaded so far and keeps them current
+void FreeItemViews(); // Releases the view indexes
+bool ReserveItemTreap(ItemTreap* tree, int capacity); // Grows one treap's per-node arrays
+bool ReserveItemViews(int capacity); // Grows the per-item index arrays
+void IndexNewItem(int index); // Adds a freshly appended item to the indexes
+void ReindexItem(int index); // Refiles an item whose bid, deadline or closed state changed
+void SetViewClosedBit(int index, bool closed); // Updates the closed bitmap and its Fenwick tree
+void SetItemViewMode(ItemSortOrder sort, bool openOnly); // Switches the list screen's view
+int ViewItemCount(); // Rows in the current view
+int ViewItemAt(int row); // Item shown in 'row' of the current view, -1 if past the end
+bool ItemOrderBefore(ItemSortOrder order, int a, int b); // Row order of the bid and deadline views
+unsigned int TreapPriority(int node); // Heap priority of a treap node (a hash of the item index)
+void TreapUpdate(ItemTreap* tree, int node); // Recomputes a node's subtree counts
+void TreapInsert(ItemTreap* tree, int node); // Links an unlinked node at its place in the order
+void TreapSplit(ItemTreap* tree, int node, int pivot, int* before, int* rest); // Splits into nodes ordered before 'pivot' and the rest
+int TreapMerge(ItemTreap* tree, int first, int second); // Joins two treaps where every node of 'first' comes first
+int TreapErase(ItemTreap* tree, int node, int target); // Removes 'target' from the subtree, returns the new subtree root
+int TreapSelect(const ItemTreap* tree, int rank, bool openOnly); // Node at 'rank' in the tree's order (counting only open items if asked)
+int SelectOpenListed(int rank); // The rank-th open item in catalog order
+
+// Item Search Functions
+void EnableItemSearch(); // Indexes the text of every item loaded so far and keeps the index current
+void FreeItemSearch(); // Releases the trigram index and the results
+void IndexItemText(int index); // Files the trigrams of an item's name and description
+bool IndexTextTrigrams(int index, const char* text); // Files the trigrams of every word in 'text'
+bool AddTrigramPosting(uint32_t code, int index); // Appends an item to a trigram's posting list
+PostingList* FindTrigram(uint32_t code); // Posting list of a trigram, NULL if no item contains it
+bool GrowTrigramTable(); // Doubles the trigram hash table
+int NormalizeSearchText(const char* text, char* normalized, int capacity); // Lowercases, turns punctuation into single spaces
+void SetSearchQuery(const char* query); // Filters the list screen by 'query' ("" shows every item)
+void RefreshSearchResults(); // Recomputes the matches of the current query in the current view
+bool ItemMatchesQuery(int index, const char* terms); // Confirms a candidate against its text
+bool PostingContains(const PostingList* list, int index); // Binary search in a posting list
+int CompareSearchResults(const void* a, const void* b); // qsort order of the current sorted view
+
+// Thumbnail Functions
+void InitThumbnails(); // Starts the image decoder (call after InitWindow)
+void ShutdownThumbnails(); // Stops the decoder and releases the atlas (call before CloseWindow)
+void ForgetThumbnails(); // Detaches the cache from the items after the item store was freed
+void DrawThumbnail(int index, Rectangle bounds); // Draws an item's image fitted into 'bounds' once it is loaded
+const ThumbnailSlot* RequestThumbnail(int index); // Marks an item's image as used, loading it if needed; NULL until ready
+int AcquireThumbnailSlot(); // Free or least recently used slot, -1 if all are in use this frame
+void PumpThumbnails(); // Uploads a few decoded images into the atlas (once per frame)
+void* ThumbnailDecodeThread(void* arg); // Decodes requested images off the UI thread
+void SetItemImage(int index, const char* path); // Sets the image file shown for an item
+const char* GetItemImage(int index); // Image path of an item, "" if none
 
 // User Management Functions (New)
-unsigned int HashPassword(const char* password); // Simple non-cryptographic hash function
-bool LoadUsers(); // Loads user data from USERS_FILE
-bool SaveUsers(); // Saves current user data to USERS_FILE
-bool RegisterUser(const char* username, const char* password); // Registers a new user
-bool AuthenticateUser(const char* username, const char* password); // Authenticates a user
+bool HashPassword(const char* password, PasswordHash* hash); // Salted scrypt hash at the current KDF_* cost (slow: worker only)
+bool VerifyPassword(const char* password, const PasswordHash* hash); // Checks a password against a stored hash (slow: worker only)
+bool PasswordNeedsRehash(const PasswordHash* hash); // True for djb2 records and scrypt below the current cost
+uint32_t LegacyPasswordHash(const char* password); // djb2, only for verifying records from older versions
+void FormatPasswordHash(const PasswordHash* hash, char* text, int capacity); // Text form used in USERS_FILE / USERS_LOG_FILE
+bool ParsePasswordHash(const char* text, PasswordHash* hash); // Reads the text form (also plain djb2 numbers)
+bool PasswordCostAllowed(int logN, int r, int p); // True if scrypt costs read from a file are within the KDF_MAX_* limits
+bool PasswordHashUsable(const PasswordHash* hash); // True if a stored hash has a known scheme and allowed costs
+bool LoadUsers(); // Loads the USERS_FILE snapshot and replays USERS_LOG_FILE on top of it
+bool SaveUsers(); // Atomically writes a new USERS_FILE snapshot of all current users
+bool WriteUsersSnapshot(const UserSnapshot* snapshot); // Writes 'snapshot' to the snapshot file atomically
+bool AppendUserLog(const char* username, const PasswordHash* hash); // Durably appends one user record to USERS_LOG_FILE
+int ReplayUserLog(bool* tornTail); // Re-applies USERS_LOG_FILE records, returns how many were applied
+bool CompactUsers(); // Folds the log into a fresh snapshot and empties the log
+bool TruncateUserLog(); // Empties USERS_LOG_FILE once its records are in a snapshot
+UserSnapshot LiveUserSnapshot(); // Snapshot view of the current directory (no copy)
+bool CopyUserSnapshot(UserSnapshot* copy); // Private copy of the current directory for the worker
+void CloseUserLog(); // Closes the registration log handle
+bool MapUserDatabase(bool* needsRewrite); // Maps USERS_DB_FILE and uses its records and index in place
+bool DetachUserDatabase(); // Copies mapped users and index to the heap so they can grow
+bool WriteUserDatabase(FILE* file, const UserSnapshot* snapshot); // Writes the binary snapshot (header, records, index) to 'file'
+bool ConvertUsersToBinary(); // One-shot conversion of USERS_FILE + USERS_LOG_FILE into USERS_DB_FILE
+void* MapFileReadOnly(const char* fileName, size_t* size); // Maps a whole file read-only, NULL on failure
+void UnmapFile(void* data, size_t size); // Releases a mapping made by MapFileReadOnly
+UserRequestStatus RegisterUser(const char* username, const char* password); // Starts registering a new user
+UserRequestStatus AuthenticateUser(const char* username, const char* password); // Starts checking a user's password
 bool UsernameExists(const char* username); // Checks if a username is already taken
+unsigned int HashUsername(const char* username); // FNV-1a hash used by the username index
+void IndexUser(int position); // Inserts users[position] into the hash index
+int FindUser(const char* username); // Looks up a user's position via the hash index, -1 if missing
+bool AddUser(const char* username, const PasswordHash* hash); // Appends a user and indexes it
+bool UpsertUser(const char* username, const PasswordHash* hash); // Replaces a user's hash, or adds the user if new
+bool RebuildUserIndex(int slotCount); // Re-creates the hash index with 'slotCount' slots
+void FreeUsers(); // Releases the user array and its hash index (or their mapping)
+
+// Session Functions
+bool IssueSession(const char* username, SessionToken* token); // Starts a session for a signed-in user
+const Session* FindSession(const SessionToken* token); // O(1) lookup of a live session, NULL if unknown or expired
+void RevokeSession(const SessionToken* token); // Ends a session (sign-out)
+int FindSessionSlot(const SessionToken* token); // Slot holding 'token', or the first empty slot of its probe
+bool ResizeSessionTable(int slotCount); // Rehashes live sessions into 'slotCount' slots, dropping expired ones
+void FreeSessions(); // Releases the session table and forgets cached credentials
+void CompleteSignIn(const char* username); // Issues a session and opens the item list
+bool PrepareCredentialCache(); // Draws the cache key on first use; false if no randomness is available
+void CredentialDigest(const char* password, const PasswordHash* hash, uint8_t out[32]); // Keyed HMAC of a password and its stored hash
+bool CheckCachedCredentials(const char* username, const char* password, const PasswordHash* hash); // True if the sign-in was verified recently
+void CacheCredentials(const char* username, const uint8_t digest[32]); // Remembers a verified sign-in
+
+// Password KDF Functions
+bool Scrypt(const char* password, const uint8_t* salt, int saltLength, int logN, int r, int p, uint8_t* key, int keyLength); // scrypt (RFC 7914)
+void ScryptBlockMix(uint32_t* block, uint32_t* scratch, int r); // scrypt BlockMix over 2r Salsa20/8 blocks
+void Salsa208(uint32_t state[16]); // Salsa20/8 core, in place
+void Pbkdf2Sha256(const uint8_t* password, size_t passwordLength, const uint8_t* salt, size_t saltLength, uint8_t* out, size_t outLength); // PBKDF2-HMAC-SHA256, one iteration
+void HmacSha256(const uint8_t* key, size_t keyLength, const uint8_t* data1, size_t length1, const uint8_t* data2, size_t length2, uint8_t out[32]); // HMAC over data1 || data2
+void Sha256Init(Sha256* sha); // Starts a SHA-256 hash
+void Sha256Update(Sha256* sha, const uint8_t* data, size_t length); // Hashes more input
+void Sha256Final(Sha256* sha, uint8_t out[32]); // Finishes the hash
+void Sha256Transform(uint32_t state[8], const uint8_t block[64]); // Compresses one 64-byte block
+bool FillRandom(uint8_t* buffer, int length); // Cryptographically secure random bytes from the OS
+void SecureZero(void* buffer, size_t length); // Clears secrets in a way the compiler cannot skip
+
+// I/O Worker Functions
+void StartIoWorker(); // Starts the background I/O thread
+void StopIoWorker(); // Finishes queued jobs and joins the thread
+bool PostIoJob(const IoJob* job); // Hands a job to the worker, false if too many are in flight
+void PollIoResults(); // Applies finished jobs on the UI thread (called every frame)
+int ApplyIoResults(int maxJobs); // Applies up to 'maxJobs' finished jobs, returns how many
+void ExecuteIoJob(IoJob* job); // Does the actual I/O for one job (worker thread)
+void* IoWorkerThread(void* arg); // Worker thread body
+bool IoRingPush(IoRing* ring, const IoJob* job); // Producer side, false if full
+bool IoRingPop(IoRing* ring, IoJob* job); // Consumer side, false if empty
+
+// Bid Ledger Functions
+bool OpenBidLedger(int segmentCount); // Replays every ledger segment into the item store and opens 'segmentCount' for new bids
+bool OpenLedgerSegment(LedgerSegment* segment, int index, int* replayed); // Replays and repairs one segment, then starts its flush thread
+void CloseBidLedger(); // Commits outstanding bids and stops the flush threads
+void RecordBid(int itemIndex, int64_t amount, uint32_t bidderId); // Queues an accepted bid for durable storage
+bool WriteBidRecords(FILE* file, const PendingBid* bids, int count, uint32_t* firstChecksum); // Encodes bids as BidRecords and writes them
+int64_t LedgerReplayStart(FILE* file, int index, const char* fileName, uint32_t* identity); // Where replay of segment 'index' starts: the snapshot's offset if it is the same file, else 0
+int ReplayBidLedger(FILE* file, int64_t start, int64_t* validBytes); // Collects the intact ledger records after 'start', returns how many (-1 if out of memory)
+void ApplyLedgerToItem(int index); // Restores an item's bid state from the replayed ledger
+void* BidLedgerFlushThread(void* arg); // Background loop that group-commits one segment's queued bids
+uint32_t HashBytes(const void* data, size_t length); // 32-bit FNV-1a over a byte range
+uint32_t HashBytesFrom(uint32_t hash, const void* data, size_t length); // Continues a HashBytes over more bytes
+
+// Checkpoint Functions
+bool LoadCheckpoint(); // Restores the item store from CHECKPOINT_FILE and points ledger replay at its tail
+bool WriteCheckpoint(const int64_t* ledgerOffsets, const uint32_t* ledgerIdentities); // Snapshots the item store to CHECKPOINT_FILE atomically
+bool CheckpointIfChanged(); // Writes a snapshot if bids were committed since the last one
+void StartCheckpointer(); // Starts the background snapshot thread
+void StopCheckpointer(); // Stops the thread and takes a last snapshot
+void* CheckpointThread(void* arg); // Background loop that snapshots every CHECKPOINT_INTERVAL_SECONDS
+void LedgerCommittedOffsets(int64_t* offsets, uint32_t* identities); // Fsynced length and identity of every ledger segment
+void CatalogFingerprint(int64_t* size, int64_t* modified); // Size and modification time of CATALOG_FILE, -1 if there is none
 
+// Bid Functions
+BidStatus ValidateBid(int itemIndex, int64_t amount, const char* bidder); // Checks a bid against the item's current state
+BidStatus CheckBidAgainst(int itemIndex, int64_t amount, uint64_t bidState); // Acceptance rules against one bid word
+BidStatus SubmitBid(int itemIndex, int64_t amount, const char* bidder); // Validates and, if valid, applies and records a bid
+BidStatus SubmitBidAs(int itemIndex, int64_t amount, uint32_t bidderId); // SubmitBid for an already interned bidder
+uint64_t PackBid(int64_t amount, uint32_t bidderId); // Builds a bid word
+int64_t BidAmount(uint64_t bidState); // Amount (cents) stored in a bid word
+uint32_t BidBidder(uint64_t bidState); // Bidder id stored in a bid word
+uint64_t LoadBidState(int itemIndex); // Atomically reads an item's bid word
+void StoreBidState(int itemIndex, uint64_t bidState); // Atomically replaces an item's bid word (loading, server updates)
+int64_t GetCurrentBid(int itemIndex); // Current high bid of an item, in cents
+const char* GetHighestBidder(int itemIndex); // Name of an item's highest bidder
+uint32_t InternBidder(const char* name); // Id for a bidder name, adding it if new; BIDDER_NONE on failure
+const char* GetBidderName(uint32_t bidderId); // Name for a bidder id (lock-free)
+uint32_t FindBidderLocked(const char* name, unsigned int hash); // Registry lookup, caller holds the lock
+uint32_t AddBidderLocked(const char* name, unsigned int hash); // Registry insert, caller holds the write lock
+void FreeBidders(); // Releases the bidder registry
+const char* BidStatusMessage(BidStatus status, int64_t amount, int64_t currentBid); // UI text for a bid outcome
+int64_t ParseCents(const char* text); // Parses a decimal dollar amount into cents, -1 if it is not one
+const char* FormatCents(int64_t cents, char* buffer, int capacity); // Writes cents as "1234.56", returns 'buffer'
+
+// Close Scheduler Functions
+int64_t WallClockMs(); // Unix time in milliseconds (the clock deadlines are measured on)
+void EnableCloseScheduler(); // Schedules the deadlines of the items loaded so far and of every later one
+void FreeCloseScheduler(CloseScheduler* scheduler); // Drops every deadline in a heap
+CloseScheduler* SchedulerFor(int index); // Heap an item's deadline belongs to (its shard's on the server)
+void ScheduleClose(int index); // Adds an open item's deadline to its heap
+int CloseNextDueAuction(CloseScheduler* scheduler, int64_t now); // Closes the next auction whose deadline has passed, returns it or -1
+int64_t NextCloseDeadline(CloseScheduler* scheduler); // Earliest scheduled deadline, 0 if none
+bool PushDeadline(CloseScheduler* scheduler, Deadline deadline); // Min-heap insert
+Deadline PopDeadline(CloseScheduler* scheduler); // Min-heap removal of the earliest deadline
+int64_t LoadEndTime(int itemIndex); // Atomic read of an item's deadline
+void StoreEndTime(int itemIndex, int64_t endTime); // Atomic write of an item's deadline
+void ExtendDeadline(int itemIndex, int64_t bidTime); // Anti-sniping extension after a late bid
+void FormatTimeLeft(int64_t milliseconds, char* text, int capacity); // Countdown text for the details screen
+
+// Networking Functions
+int RunBidServer(const char* port, int shardCount); // Headless server loop (--server [port] [shards]); 0 shards picks one per core
+bool ConnectToServer(const char* address); // Connects the UI to a bid server (--connect host[:port])
+void PollNetClient(); // Sends queued bids and applies messages from the server
+void SendBid(int itemIndex, int64_t amount, const char* bidder); // Queues a bid for the server
+void DisconnectFromServer(); // Closes the link to the server
+void HandleServerMessage(BidServer* server, int clientIndex, int type, NetReader* reader); // Processes one client message on the server
+void HandleClientMessage(int type, NetReader* reader); // Processes one server message on the client
+uint32_t LocalBidderId(uint32_t serverId); // Maps a server bidder id to ours, BIDDER_NONE if unnamed
+void UpdateSubscriptions(const uint32_t* ids, int count); // Sends the changes to the set of items the client follows
+void SendItemIds(int type, const uint32_t* ids, int count); // Queues ids as subscribe/unsubscribe messages
+void HandleSubscription(ServerClient* client, int type, NetReader* reader); // Applies a subscribe/unsubscribe on the server
+void MarkItemDirty(BidServer* server, int itemIndex, uint8_t flags); // Queues an item change for the end of the pass
+void FlushItemUpdates(BidServer* server); // Sends the pass's changes to the clients subscribed to them
+void FlushClientUpdates(BidServer* server, ServerClient* client); // Queues the pass's changes one client follows
+void RunFlushSlices(BidServer* server, int own); // Flushes clients from slice 'own', then steals from the other slices
+bool StartShards(BidServer* server, int shardCount); // Creates the shards (threads start in RunShards)
+bool RunShards(BidServer* server); // Starts the shard threads
+void StopShards(BidServer* server); // Lets every shard finish its queued bids, joins and frees them
+void* ShardThread(void* arg); // Body of one shard: closes its due auctions and applies its bids in order
+void ProcessShardRequest(BidShard* shard, const ShardMessage* request); // Applies one bid and posts the outcome
+void PostShardResult(BidServer* server, BidShard* shard, const ShardMessage* result); // Queues a result, waiting while the ring is full
+void JoinFlushBatch(BidServer* server, BidShard* shard); // Takes part in a started flush batch if it has not yet
+void WakeNetworkThread(BidServer* server); // Makes the network thread's poll() return
+void ApplyShardResults(BidServer* server); // Sends bid results and marks changed items (network thread)
+ServerClient* FindServerClient(BidServer* server, uint32_t id); // Client by id, NULL if it has gone
+bool ShardRingPush(ShardRing* ring, const ShardMessage* message); // Producer side, false if full
+bool ShardRingPop(ShardRing* ring, ShardMessage* message); // Consumer side, false if empty
+bool QueueBidderName(ServerClient* client, uint32_t bidderId); // Sends a bidder name the client has not seen yet
+void CloseServerClient(ServerClient* client); // Closes a client's connection and frees its state
+int CompareItemIds(const void* a, const void* b); // qsort/bsearch comparator for ascending u32 ids
+bool PumpConnection(NetConnection* connection, bool canRead); // Moves bytes between a socket and its queues, false if it closed
+int NextMessage(NetBuffer* in, int* type, NetReader* reader, int* consumed); // Extracts one complete message from 'in'
+void BeginMessage(NetBuffer* out, int type); // Starts a new message on 'out'
+void EndMessage(NetBuffer* out, int start); // Patches the payload length of the message started at 'start'
+void PutU8(NetBuffer* out, uint8_t value); // Appends one byte
+void PutU32(NetBuffer* out, uint32_t value); // Appends a little-endian u32
+void PutU64(NetBuffer* out, uint64_t value); // Appends a little-endian u64
+void PutString(NetBuffer* out, const char* text, int maxLength); // Appends a length-prefixed string
+uint8_t GetU8(NetReader* reader); // Reads one byte
+uint32_t GetU32(NetReader* reader); // Reads a little-endian u32
+uint64_t GetU64(NetReader* reader); // Reads a little-endian u64
+void GetString(NetReader* reader, char* text, int capacity); // Reads a length-prefixed string
+bool ReserveNetBuffer(NetBuffer* buffer, int extra); // Makes room for 'extra' more bytes
+void CloseConnection(NetConnection* connection); // Closes the socket and frees the queues
+
+// Profiler Functions
+void InitProfiler(); // Sets the profiler epoch and remembers the UI thread
+double ProfileBegin(); // Returns the start time of a timed scope
+void ProfileEnd(const char* name, double start); // Records a timed scope that began at 'start'
+void RecordFrameTime(double seconds); // Adds one drawn frame to the frame time history
+float FrameTimePercentile(float percentile); // Frame time (seconds) at 'percentile' over the history
+void DrawProfilerOverlay(); // Draws frame time statistics in the corner of the screen
+bool ExportChromeTrace(const char* fileName); // Writes recorded scopes as Chrome trace JSON
+double ProfilerClock(); // Monotonic clock in seconds
+int CompareFloats(const void* a, const void* b); // qsort comparator for ascending floats
+
+// Frame Arena Functions
+void* FrameAlloc(size_t size); // Scratch memory valid until the end of the frame, NULL if the arena is full
+const char* FrameFormat(const char* format, ...); // printf into the frame arena; the string lasts the whole frame
+void ResetFrameArena(); // Releases everything allocated this frame
+
+// Benchmark Functions
+int RunBenchmark(int argc, char** argv); // Synthetic load on the auction core (--bench [users] [items] [threads])
+bool BenchUserDirectory(int userTotal); // AddUser, FindUser, SaveUsers and LoadUsers over a large directory
+bool BenchUserRequests(); // RegisterUser and AuthenticateUser round trips through the I/O worker
+bool BenchItems(int itemTotal); // AddAuctionItem into an empty store
+bool BenchBids(int itemTotal, int threadCount); // Concurrent bursts of SubmitBid
+void* BenchBidThread(void* arg); // Body of one bid-submitting thread
+void WaitForUserRequest(); // Polls I/O results until the pending user request is answered
+void ReportBench(const char* name, double* samples, int count, double seconds); // Prints ops/sec and latency percentiles (sorts 'samples')
+uint64_t BenchRandom(uint64_t* state); // xorshift64 step
+int CompareDoubles(const void* a, const void* b); // qsort comparator for ascending doubles
+
+#if defined(AUCTION_HEADLESS)
+// Headless Platform Functions (raylib provides these in windowed builds)
+void TraceLog(int logLevel, const char* text, ...); // Writes a log line to stderr
+void SetTraceLogLevel(int logLevel); // Drops log messages below 'logLevel'
+bool FileExists(const char* fileName); // True if the file can be opened
+#endif
 
 // --- Main Program Entry Point ---
-int main(void) {
-    // Initialization
+int main(int argc, char** argv) {
+    InitProfiler(); // Start the clock first so startup I/O shows up in traces
+
+    // Command-line tools (run without opening a window)
     //--------------------------------------------------------------------------------------
-    const int screenWidth = 800;  // Width of the application window
-    const int screenHeight = 600; // Height of the application window
+    if (argc > 1 && strcmp(argv[1], "--convert-users") == 0) {
+        return ConvertUsersToBinary() ? 0 : 1; // Convert the text user database to the binary format
+    }
+    if (argc > 1 && strcmp(argv[1], "--server") == 0) {
+        int shardCount = (argc > 3) ? atoi(argv[3]) : 0; // Bid worker threads; 0 picks one per spare core
+        return RunBidServer((argc > 2) ? argv[2] : DEFAULT_SERVER_PORT, shardCount); // Headless authoritative bid server
+    }
+    if (argc > 1 && strcmp(argv[1], "--bench") == 0) {
+        return RunBenchmark(argc - 2, argv + 2); // Throughput and latency of the auction core
+    }
+#if defined(AUCTION_HEADLESS)
+    TraceLog(LOG_ERROR, "This build has no window. Use --server [port] [shards], --bench [users] [items] [threads] or --convert-users.");
+    return 1;
+#else
+    const char* serverAddress = NULL; // Set with --connect host[:port] to bid through a server
+    const char* recordFile = NULL;    // Set with --record file to capture the session's input
+    const char* replayFile = NULL;    // Set with --replay file [--no-render] to play a capture back
+    bool replayRender = true;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--connect") == 0 && i + 1 < argc) serverAddress = argv[++i];
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) recordFile = argv[++i];
+        else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) replayFile = argv[++i];
+        else if (strcmp(argv[i], "--no-render") == 0) replayRender = false;
+    }
+    bool capturedSession = recordFile != NULL || replayFile != NULL; // Both ends must start from the same state
+    if (capturedSession && (serverAddress != NULL || (recordFile != NULL && replayFile != NULL))) {
+        TraceLog(LOG_ERROR, "--record and --replay cannot be combined with each other or with --connect.");
+        return 1;
+    }
 
-    // Initialize the Raylib window
-    InitWindow(screenWidth, screenHeight, "Raylib Public Auction App");
-    SetTargetFPS(60); // Set the application to run at 60 frames-per-second for smooth animation
+    // Initialization
+    //--------------------------------------------------------------------------------------
+    // Initialize the Raylib window at the design size. Every screen scales with it (see
+    // UpdateUiScale); a captured session keeps it fixed so recorded clicks land where they did.
+    if (!capturedSession) SetConfigFlags(FLAG_WINDOW_RESIZABLE);
+    InitWindow(UI_DESIGN_WIDTH, UI_DESIGN_HEIGHT, "Raylib Public Auction App");
+    SetTargetFPS(60); // Cap repaints at 60 frames-per-second while something is changing
+    if ((recordFile != NULL && !StartInputRecording(recordFile)) || (replayFile != NULL && !StartInputReplay(replayFile, replayRender))) {
+        CloseWindow();
+        return 1;
+    }
+    if (inputRecording.replaying) SetTargetFPS(0); // Replayed frames run back to back, as fast as they take
+    if (capturedSession && !EnterCaptureDirectory()) { // After the recording is opened: its path is relative to where we started
+        StopInputRecording();
+        CloseWindow();
+        return 1;
+    }
+    InitThumbnails(); // Item images are decoded in the background once rows show them
 
-    InitAuctionData(); // Populate the initial set of auction items
+    InitAuctionData(!capturedSession && serverAddress == NULL); // Populate the initial set of auction items (a server or a capture decides it otherwise)
+    if (capturedSession) {
+        while (catalogLoader.active) PumpCatalogLoader(1.0); // Every row must be where it was when the session was recorded
+    }
+    EnableItemViews(); // Sorted/filtered list views follow every change from here on
+    EnableItemSearch(); // So does the search box's trigram index
+    if (serverAddress != NULL) {
+        // The server owns the item state and the ledger; it sends every item's state on connect
+        if (!ConnectToServer(serverAddress)) TraceLog(LOG_WARNING, "Unable to reach %s. Bidding locally.", serverAddress);
+    }
+    if (!netClient.connected) {
+        EnableCloseScheduler(); // Close auctions at their deadlines (a server does this for its clients)
+        if (!capturedSession) OpenBidLedger(1); // Restore bids placed in earlier sessions and start recording new ones
+    }
     LoadUsers();       // Load existing users from the file (if any)
+    if (capturedSession) AddCaptureUser(); // The one account a recording can sign in to without signing up
+    StartIoWorker();   // From here on registrations are written in the background
 
-    // Initialize the properties of all input boxes
+    // Initialize the properties of all input boxes (LayoutInputBoxes places them)
     // Bid screen inputs
-    bidAmountInput = (InputBox){(Rectangle){ screenWidth / 2 - 100, 300, 200, 40 }, "", 0, false, DARKGRAY_CUSTOM, false};
-    bidderNameInput = (InputBox){(Rectangle){ screenWidth / 2 - 100, 380, 200, 40 }, "", 0, false, DARKGRAY_CUSTOM, false};
+    bidAmountInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, false};
 
     // Sign In screen inputs
-    signInUsernameInput = (InputBox){(Rectangle){ screenWidth / 2 - 120, 250, 240, 40 }, "", 0, false, DARKGRAY_CUSTOM, false};
-    signInPasswordInput = (InputBox){(Rectangle){ screenWidth / 2 - 120, 320, 240, 40 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true for masking
+    signInUsernameInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, false};
+    signInPasswordInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true for masking
 
     // Sign Up screen inputs
-    signUpUsernameInput = (InputBox){(Rectangle){ screenWidth / 2 - 120, 200, 240, 40 }, "", 0, false, DARKGRAY_CUSTOM, false};
-    signUpPasswordInput = (InputBox){(Rectangle){ screenWidth / 2 - 120, 270, 240, 40 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true
-    signUpConfirmPasswordInput = (InputBox){(Rectangle){ screenWidth / 2 - 120, 340, 240, 40 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true
+    signUpUsernameInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, false};
+    signUpPasswordInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true
+    signUpConfirmPasswordInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, true}; // isPassword = true
+
+    // Item list search box
+    searchInput = (InputBox){(Rectangle){ 0 }, "", 0, false, DARKGRAY_CUSTOM, false};
+    UpdateUiScale(); // Bake the font atlases once and place the boxes for the initial window
     //--------------------------------------------------------------------------------------
 
     // Main application loop
     // This loop continues as long as the window is not closed (e.g., by clicking the close button or pressing ESC)
+    double lastUpdateTime = inputRecording.replaying ? inputRecording.startTime : GetTime(); // Frames can be skipped while idle, so dt is measured here rather than by GetFrameTime()
     while (!WindowShouldClose()) {
         // Update Logic (handles user input and changes in application state)
         //----------------------------------------------------------------------------------
-        float dt = GetFrameTime(); // Get time elapsed since last frame for timer updates
-        Vector2 mousePoint = GetMousePosition(); // Get current mouse cursor position
+        double frameStart = ProfileBegin(); // CPU time of this frame, excluding idle waits and vsync
+        if (!SampleInput(GetTime())) break; // The only input query of the frame; a replay ends with its last frame
+        double now = frameInput.time;
+        float dt = (float)(now - lastUpdateTime); // Time elapsed since the last update for timer updates
+        lastUpdateTime = now;
+        UpdateUiScale(); // A resized window rescales everything before it is hit-tested or drawn
+        SamplePointer(); // Cursor and click for the widget tables
+
+        // Any input may change what is shown, so it always triggers a repaint
+        if (frameInput.activity) RequestRedraw();
+
+        // The input box cursor toggles every half second while a box is focused
+        if (IsAnyInputBoxActive()) {
+            int blinkPhase = (int)(now * 2.0);
+            if (blinkPhase != lastCursorBlinkPhase) RequestRedraw();
+        }
 
         // Update the UI message timer
         if (uiMessageTimer > 0) {
             uiMessageTimer -= dt;
             if (uiMessageTimer <= 0) {
                 strcpy(uiMessage, ""); // Clear message when timer expires
+                RequestRedraw(); // The message bar has to disappear
             }
         }
 
+        // Keep streaming the catalog in small time slices; the list grows as items arrive
+        if (catalogLoader.active && PumpCatalogLoader(CATALOG_LOAD_BUDGET)) RequestRedraw();
+        if (!catalogLoader.active && !checkpointer.attempted && bidLedger.segments[0].open) StartCheckpointer(); // The store is complete: snapshot it from now on
+
+        // Follow the items on screen and exchange messages with the bid server; bid updates
+        // repaint the affected rows
+        if (netClient.connected) {
+            uint32_t shown[NET_MAX_SUBSCRIPTIONS];
+            UpdateSubscriptions(shown, CollectShownItems(shown, NET_MAX_SUBSCRIPTIONS));
+            PollNetClient();
+        }
+
+        // Pick up finished background I/O (registrations, compaction). A replay applies results on
+        // the frames the recording did, waiting for the worker if it is slower this time.
+        if (inputRecording.replaying) {
+            if (frameInput.ioResults > 0) WaitForIoResults(frameInput.ioResults);
+        } else if (ioWorker.outstanding > 0) {
+            frameInput.ioResults = ApplyIoResults(IO_QUEUE_CAPACITY);
+        }
+
+        // Move a few decoded thumbnails into the atlas; each upload repaints
+        if (thumbnails.outstanding > 0) PumpThumbnails();
+
+        // Close the auctions whose deadline has passed (O(log n) each, nothing while none is due)
+        if (closeScheduler.enabled) {
+            int64_t nowMs = WallClockMs();
+            int closedIndex;
+            while ((closedIndex = CloseNextDueAuction(&closeScheduler, nowMs)) >= 0) InvalidateItemRender(closedIndex);
+        }
+
+        // The countdown on the details screen changes every second
+        if (currentScreen == SCREEN_ITEM_DETAILS && selectedItemIndex != -1 && LoadEndTime(selectedItemIndex) > 0) {
+            if (WallClockMs() / 1000 != lastCountdownSecond) RequestRedraw();
+        }
+
+        // Profiler controls: F3 toggles the overlay, F12 exports a Chrome trace
+        if (FrameKeyPressed(INPUT_KEY_F3)) profiler.overlayVisible = !profiler.overlayVisible;
+        if (FrameKeyPressed(INPUT_KEY_F12)) {
+            SetUIMessage(ExportChromeTrace(PROFILER_TRACE_FILE) ? "Trace written to " PROFILER_TRACE_FILE : "Unable to write trace.");
+        }
+
         // State machine: Logic changes based on the current screen
+        double updateStart = ProfileBegin();
+        ResolvePointer(currentScreen); // Once every state change above has been applied
         switch (currentScreen) {
             case SCREEN_AUTH_MENU: {
-                // Define buttons for Sign In and Sign Up
-                Rectangle signInButton = { screenWidth / 2 - 100, screenHeight / 2 - 50, 200, 50 };
-                Rectangle signUpButton = { screenWidth / 2 - 100, screenHeight / 2 + 20, 200, 50 };
-
                 // Check for button clicks
-                if (IsMouseOver(signInButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_OPEN_SIGN_IN) {
                     currentScreen = SCREEN_SIGN_IN; // Transition to Sign In screen
                     ResetInputBoxes(); // Clear input fields
                     SetUIMessage("Enter your credentials."); // Provide user feedback
                 }
-                if (IsMouseOver(signUpButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_OPEN_SIGN_UP) {
                     currentScreen = SCREEN_SIGN_UP; // Transition to Sign Up screen
                     ResetInputBoxes(); // Clear input fields
                     SetUIMessage("Choose a username and password."); // Provide user feedback
@@ -177,23 +1631,16 @@ int main(void) {
                 UpdateInputBox(&signInUsernameInput);
                 UpdateInputBox(&signInPasswordInput);
 
-                // Define Login and Back buttons
-                Rectangle loginButton = { screenWidth / 2 - 80, 400, 160, 50 };
-                Rectangle backButton = { screenWidth / 2 - 80, 470, 160, 50 };
-
                 // Handle Login button click
-                if (IsMouseOver(loginButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    if (AuthenticateUser(signInUsernameInput.text, signInPasswordInput.text)) {
-                        strcpy(loggedInUsername, signInUsernameInput.text); // Set the logged-in user
-                        currentScreen = SCREEN_ITEM_LIST; // Go to item list screen
-                        SetUIMessage(TextFormat("Welcome, %s!", loggedInUsername)); // Welcome message
-                        ResetInputBoxes(); // Clear login fields
-                    } else {
-                        SetUIMessage("Login failed. Check username/password."); // Error message
+                if (pointer.clicked == ACTION_LOGIN) {
+                    // The password check runs on the I/O worker (PollIoResults signs the user in), or
+                    // finishes right here for a recently verified password
+                    if (AuthenticateUser(signInUsernameInput.text, signInPasswordInput.text) == USER_REQUEST_PENDING) {
+                        SetUIMessage("Signing in...");
                     }
                 }
                 // Handle Back button click
-                if (IsMouseOver(backButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_BACK) {
                     currentScreen = SCREEN_AUTH_MENU; // Go back to authentication menu
                     ResetInputBoxes(); // Clear input fields
                     SetUIMessage(""); // Clear message
@@ -206,12 +1653,8 @@ int main(void) {
                 UpdateInputBox(&signUpPasswordInput);
                 UpdateInputBox(&signUpConfirmPasswordInput);
 
-                // Define Register and Back buttons
-                Rectangle registerButton = { screenWidth / 2 - 80, 410, 160, 50 };
-                Rectangle backButton = { screenWidth / 2 - 80, 480, 160, 50 };
-
                 // Handle Register button click
-                if (IsMouseOver(registerButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_REGISTER) {
                     // Basic validation for username and password length
                     if (strlen(signUpUsernameInput.text) < 3 || strlen(signUpPasswordInput.text) < 5) {
                         SetUIMessage("Username (min 3 chars) / Password (min 5 chars) too short.");
@@ -220,18 +1663,14 @@ int main(void) {
                     } else if (UsernameExists(signUpUsernameInput.text)) {
                         SetUIMessage("Username already taken."); // Check for duplicate username
                     } else {
-                        // Attempt to register the user
-                        if (RegisterUser(signUpUsernameInput.text, signUpPasswordInput.text)) {
-                            SetUIMessage("Registration successful! Please sign in."); // Success message
-                            currentScreen = SCREEN_SIGN_IN; // Go to Sign In screen
-                            ResetInputBoxes(); // Clear sign-up fields
-                        } else {
-                            SetUIMessage("Registration failed. Try again."); // Generic failure (shouldn't happen if checks are good)
+                        // Attempt to register the user; PollIoResults reports the outcome
+                        if (RegisterUser(signUpUsernameInput.text, signUpPasswordInput.text) == USER_REQUEST_PENDING) {
+                            SetUIMessage("Registering..."); // Replaced once the registration is on disk
                         }
                     }
                 }
                 // Handle Back button click
-                if (IsMouseOver(backButton) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_BACK) {
                     currentScreen = SCREEN_AUTH_MENU; // Go back to authentication menu
                     ResetInputBoxes(); // Clear input fields
                     SetUIMessage(""); // Clear message
@@ -239,316 +1678,715 @@ int main(void) {
             } break; // End of SCREEN_SIGN_UP case
 
             case SCREEN_ITEM_LIST: {
-                if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    // Check if any auction item in the list was clicked
-                    for (int i = 0; i < itemCount; i++) {
-                        Rectangle itemRect = { 50, 100 + i * 60, screenWidth - 100, 50 };
-                        if (CheckCollisionPointRec(mousePoint, itemRect)) {
-                            selectedItemIndex = i;      // Set the clicked item as selected
-                            currentScreen = SCREEN_ITEM_DETAILS; // Transition to the item details screen
-                            SetUIMessage(""); // Clear any previous message
-                            break; // Exit loop once an item is found
-                        }
-                    }
+                // Filter the list as the user types into the search box
+                UpdateInputBox(&searchInput);
+                if (strcmp(searchInput.text, itemSearch.query) != 0) SetSearchQuery(searchInput.text);
+
+                // Scroll with the mouse wheel and Page Up/Page Down
+                if (frameInput.wheel != 0.0f) ScrollItemList(-frameInput.wheel * LIST_SCROLL_SPEED * UiPx(LIST_ROW_STRIDE));
+                if (FrameKeyPressed(INPUT_KEY_PAGE_DOWN)) ScrollItemList(GetScreenHeight() - UiPx(LIST_TOP) - UiPx(LIST_BOTTOM_MARGIN));
+                if (FrameKeyPressed(INPUT_KEY_PAGE_UP)) ScrollItemList(-(GetScreenHeight() - UiPx(LIST_TOP) - UiPx(LIST_BOTTOM_MARGIN)));
+
+                // Switch between the list views (the indexes are always current, so this is free)
+                if (pointer.clicked == ACTION_CYCLE_SORT) {
+                    SetItemViewMode((itemViews.sort + 1) % SORT_ORDER_COUNT, itemViews.openOnly);
+                }
+                if (pointer.clicked == ACTION_TOGGLE_FILTER) {
+                    SetItemViewMode(itemViews.sort, !itemViews.openOnly);
+                }
+
+                // The row under the cursor was mapped straight from its position by ResolvePointer
+                int clickedIndex = (pointer.pressed && pointer.hoveredRow != -1) ? ViewItemAt(pointer.hoveredRow) : -1;
+                if (clickedIndex != -1) {
+                    selectedItemIndex = clickedIndex; // Set the clicked item as selected
+                    currentScreen = SCREEN_ITEM_DETAILS; // Transition to the item details screen
+                    SetUIMessage(""); // Clear any previous message
                 }
                 // Handle Logout button click
-                Rectangle logoutButtonRect = { screenWidth - 150, 20, 120, 40 };
-                if (IsMouseOver(logoutButtonRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    strcpy(loggedInUsername, ""); // Clear logged in user
+                if (pointer.clicked == ACTION_LOGOUT) {
+                    RevokeSession(&currentSession); // The token is refused from now on
+                    loggedInUserId = BIDDER_NONE; // Clear logged in user
+                    strcpy(searchInput.text, ""); // The next user starts with the full list
+                    searchInput.letterCount = 0;
+                    SetSearchQuery("");
                     currentScreen = SCREEN_AUTH_MENU; // Go back to authentication menu
                     SetUIMessage("Logged out successfully."); // Confirmation message
                 }
             } break; // End of SCREEN_ITEM_LIST case
 
             case SCREEN_ITEM_DETAILS: {
-                // Define the "Back" button area
-                Rectangle backButtonRect = { 50, screenHeight - 60, 120, 40 };
-                if (IsMouseOver(backButtonRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                // Handle "Back" button click
+                if (pointer.clicked == ACTION_BACK) {
                     currentScreen = SCREEN_ITEM_LIST; // Go back to the item list
                     selectedItemIndex = -1; // Deselect the item
                     SetUIMessage(""); // Clear message
                 }
 
-                // Define the "Place Bid" button area
-                // Only show and enable this button if an item is selected and its auction is still open
-                if (selectedItemIndex != -1 && !items[selectedItemIndex].auctionClosed) {
-                    Rectangle placeBidButtonRect = { screenWidth - 170, screenHeight - 60, 120, 40 };
-                    if (IsMouseOver(placeBidButtonRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                        currentScreen = SCREEN_PLACE_BID; // Transition to the place bid screen
-                        ResetInputBoxes(); // Clear any previous input from the bid fields
-                        SetUIMessage("Enter your bid and name."); // Prompt user
-                    }
+                // Handle "Place Bid" button click (the widget only exists while the auction is open)
+                if (pointer.clicked == ACTION_OPEN_BID) {
+                    currentScreen = SCREEN_PLACE_BID; // Transition to the place bid screen
+                    ResetInputBoxes(); // Clear any previous input from the bid fields
+                    SetUIMessage("Enter your bid."); // Prompt user
                 }
             } break; // End of SCREEN_ITEM_DETAILS case
 
             case SCREEN_PLACE_BID: {
-                // Update logic for both input boxes (handling typing, focus)
+                // Update logic for the amount box (handling typing, focus)
                 UpdateInputBox(&bidAmountInput);
-                UpdateInputBox(&bidderNameInput);
-
-                // Define the "BID!" and "Cancel" button areas
-                Rectangle bidButtonRect = { screenWidth / 2 - 120, 480, 100, 40 };
-                Rectangle cancelButtonRect = { screenWidth / 2 + 20, 480, 100, 40 };
 
                 // Handle "BID!" button click
-                if (IsMouseOver(bidButtonRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-                    float newBid = strtof(bidAmountInput.text, NULL); // Convert string to float
-
-                    // Validate bidder name and bid amount
-                    if (strlen(bidderNameInput.text) == 0) {
-                        SetUIMessage("Please enter your name to bid."); // Prompt for name
-                    } else if (newBid <= items[selectedItemIndex].currentBid) {
-                        SetUIMessage(TextFormat("Bid failed: $%.2f is not higher than current bid $%.2f", newBid, items[selectedItemIndex].currentBid)); // Bid too low
-                    } else if (newBid > 999999999.0f) { // Prevent excessively large bids
-                        SetUIMessage("Bid amount too large!");
-                    }
-                    else {
-                        items[selectedItemIndex].currentBid = newBid; // Update current bid
-                        strcpy(items[selectedItemIndex].highestBidder, bidderNameInput.text); // Update highest bidder
-                        TraceLog(LOG_INFO, "BID PLACED: %s for %.2f by %s", items[selectedItemIndex].name, newBid, bidderNameInput.text);
+                if (pointer.clicked == ACTION_SUBMIT_BID) {
+                    int64_t newBid = ParseCents(bidAmountInput.text); // Exact cents, -1 if not an amount
+                    const Session* session = FindSession(&currentSession); // The bidder is whoever signed in
+
+                    // Validate the bid amount (the server repeats these checks)
+                    BidStatus status = BID_ACCEPTED;
+                    if (session == NULL) {
+                        loggedInUserId = BIDDER_NONE; // Expired: sign in again
+                        currentScreen = SCREEN_SIGN_IN;
+                        selectedItemIndex = -1;
+                        ResetInputBoxes();
+                        SetUIMessage("Your session has expired. Please sign in again.");
+                    } else if ((status = CheckBidAgainst(selectedItemIndex, newBid, LoadBidState(selectedItemIndex))) != BID_ACCEPTED) {
+                        SetUIMessage(BidStatusMessage(status, newBid, GetCurrentBid(selectedItemIndex)));
+                    } else if (netClient.connected) {
+                        SendBid(selectedItemIndex, newBid, GetBidderName(session->userId)); // The server has the final say; it keeps its own ids
+                        currentScreen = SCREEN_ITEM_DETAILS; // The result arrives as a UI message
+                        SetUIMessage("Bid sent. Waiting for the auction server...");
+                    } else {
+                        SubmitBidAs(selectedItemIndex, newBid, session->userId); // Apply and record the bid
+                        InvalidateItemRender(selectedItemIndex); // Refile it in the sorted list views
                         currentScreen = SCREEN_ITEM_DETAILS; // Go back to item details after successful bid
-                        SetUIMessage(TextFormat("Bid of $%.2f placed successfully by %s!", newBid, bidderNameInput.text)); // Success message
+                        SetUIMessage(BidStatusMessage(BID_ACCEPTED, newBid, newBid)); // Success message
                     }
                 }
                 // Handle "Cancel" button click
-                if (IsMouseOver(cancelButtonRect) && IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
+                if (pointer.clicked == ACTION_CANCEL_BID) {
                     currentScreen = SCREEN_ITEM_DETAILS; // Go back to item details without placing a bid
                     SetUIMessage(""); // Clear message
                 }
             } break; // End of SCREEN_PLACE_BID case
         }
+        ProfileEnd("Update", updateStart);
+        if (inputRecording.recording) WriteRecordedFrame(); // After the update, so the frame's I/O results are known
         //----------------------------------------------------------------------------------
 
         // Drawing Logic (renders elements on the screen)
         //----------------------------------------------------------------------------------
+        // A replay with --no-render measures the update path alone
+        if (inputRecording.replaying && !inputRecording.render) {
+            redrawRequested = false;
+            ResetFrameArena();
+            RecordReplayFrame(ProfileBegin() - frameStart);
+            continue;
+        }
+
+        // Nothing changed since the last repaint: keep the current frame and sleep instead
+        if (!redrawRequested) {
+            ResetFrameArena(); // Nothing formatted during this update is going to be drawn
+            if (inputRecording.replaying) RecordReplayFrame(ProfileBegin() - frameStart); // Replays never sleep
+            else WaitForRedrawTrigger();
+            continue;
+        }
+        redrawRequested = false;
+        lastCursorBlinkPhase = (int)(now * 2.0); // Remember which cursor phase this frame shows
+        lastCountdownSecond = WallClockMs() / 1000; // And which second the countdown shows
+        thumbnails.frame++; // Thumbnails drawn from here on count as used in this frame
+
         BeginDrawing(); // Start drawing operations
 
             ClearBackground(RAYWHITE); // Clear the background with a light white color
 
-            // Drawing changes based on the current screen
+            // Drawing changes based on the current screen; hover follows a screen change or scroll made this frame
+            if (pointer.screen != currentScreen || pointer.scrollOffset != listScrollOffset) ResolvePointer(currentScreen);
+            AppScreen drawnScreen = currentScreen;
+            double drawStart = ProfileBegin();
             switch (currentScreen) {
                 case SCREEN_AUTH_MENU: {
-                    DrawText("Welcome to the Auction!", GetScreenWidth() / 2 - MeasureText("Welcome to the Auction!", 40) / 2, 100, 40, DARKGRAY_CUSTOM);
-
-                    // Draw Sign In button
-                    Rectangle signInButton = { GetScreenWidth() / 2 - 100, GetScreenHeight() / 2 - 50, 200, 50 };
-                    DrawRectangleRec(signInButton, BLUE_HIGHLIGHT);
-                    DrawRectangleLinesEx(signInButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Sign In", signInButton.x + signInButton.width / 2 - MeasureText("Sign In", 30) / 2, signInButton.y + 10, 30, RAYWHITE);
-
-                    // Draw Sign Up button
-                    Rectangle signUpButton = { GetScreenWidth() / 2 - 100, GetScreenHeight() / 2 + 20, 200, 50 };
-                    DrawRectangleRec(signUpButton, GREEN_ACCEPT);
-                    DrawRectangleLinesEx(signUpButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Sign Up", signUpButton.x + signUpButton.width / 2 - MeasureText("Sign Up", 30) / 2, signUpButton.y + 10, 30, RAYWHITE);
+                    SubmitScreenLayout(SCREEN_AUTH_MENU); // Title and buttons
                 } break; // End of SCREEN_AUTH_MENU drawing
 
                 case SCREEN_SIGN_IN: {
-                    DrawText("Sign In", GetScreenWidth() / 2 - MeasureText("Sign In", 40) / 2, 100, 40, DARKGRAY_CUSTOM);
+                    SubmitScreenLayout(SCREEN_SIGN_IN); // Title and buttons
                     DrawInputBox(&signInUsernameInput, "Username:");
                     DrawInputBox(&signInPasswordInput, "Password:");
-
-                    // Draw Login button
-                    Rectangle loginButton = { GetScreenWidth() / 2 - 80, 400, 160, 50 };
-                    DrawRectangleRec(loginButton, GREEN_ACCEPT);
-                    DrawRectangleLinesEx(loginButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Login", loginButton.x + loginButton.width / 2 - MeasureText("Login", 25) / 2, loginButton.y + 13, 25, RAYWHITE);
-
-                    // Draw Back button
-                    Rectangle backButton = { GetScreenWidth() / 2 - 80, 470, 160, 50 };
-                    DrawRectangleRec(backButton, LIGHTGRAY_CUSTOM);
-                    DrawRectangleLinesEx(backButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Back", backButton.x + backButton.width / 2 - MeasureText("Back", 25) / 2, backButton.y + 13, 25, DARKGRAY_CUSTOM);
                 } break; // End of SCREEN_SIGN_IN drawing
 
                 case SCREEN_SIGN_UP: {
-                    DrawText("Sign Up", GetScreenWidth() / 2 - MeasureText("Sign Up", 40) / 2, 100, 40, DARKGRAY_CUSTOM);
+                    SubmitScreenLayout(SCREEN_SIGN_UP); // Title and buttons
                     DrawInputBox(&signUpUsernameInput, "Username:");
                     DrawInputBox(&signUpPasswordInput, "Password:");
                     DrawInputBox(&signUpConfirmPasswordInput, "Confirm Password:");
-
-                    // Draw Register button
-                    Rectangle registerButton = { GetScreenWidth() / 2 - 80, 410, 160, 50 };
-                    DrawRectangleRec(registerButton, GREEN_ACCEPT);
-                    DrawRectangleLinesEx(registerButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Register", registerButton.x + registerButton.width / 2 - MeasureText("Register", 25) / 2, registerButton.y + 13, 25, RAYWHITE);
-
-                    // Draw Back button
-                    Rectangle backButton = { GetScreenWidth() / 2 - 80, 480, 160, 50 };
-                    DrawRectangleRec(backButton, LIGHTGRAY_CUSTOM);
-                    DrawRectangleLinesEx(backButton, 2, DARKGRAY_CUSTOM);
-                    DrawText("Back", backButton.x + backButton.width / 2 - MeasureText("Back", 25) / 2, backButton.y + 13, 25, DARKGRAY_CUSTOM);
                 } break; // End of SCREEN_SIGN_UP drawing
 
                 case SCREEN_ITEM_LIST: {
-                    DrawText("Auction Items", GetScreenWidth() / 2 - MeasureText("Auction Items", 40) / 2, 30, 40, DARKGRAY_CUSTOM);
+                    SubmitScreenLayout(SCREEN_ITEM_LIST); // Title, view switches and Logout button
                     // Display logged-in username
-                    DrawText(TextFormat("Logged in as: %s", loggedInUsername), 20, 20, 20, DARKGRAY_CUSTOM);
+                    DrawUiText(FrameFormat("Logged in as: %s", GetBidderName(loggedInUserId)), UiPx(20), UiPx(20), 20, DARKGRAY_CUSTOM);
+                    if (catalogLoader.active) {
+                        DrawUiText(FrameFormat("Loading catalog... %d items", items.count), UiPx(20), UiPx(42), 15, DARKGRAY_CUSTOM);
+                    }
+
+                    // Draw the search box, with a hint while it is empty
+                    DrawInputBox(&searchInput, "");
+                    if (searchInput.letterCount == 0 && !searchInput.active) {
+                        DrawUiText("Search items...", (int)searchInput.rect.x + UiPx(5), (int)searchInput.rect.y + UiPx(10), 20, LIGHTGRAY_CUSTOM);
+                    }
+                    if (itemSearch.active && ViewItemCount() == 0) {
+                        DrawUiText("No matching items.", UiPx(LIST_SIDE_MARGIN), UiPx(LIST_TOP + 15), 20, DARKGRAY_CUSTOM);
+                    }
+
+                    // Draw only the rows that fall inside the list viewport
+                    int firstRow, lastRow;
+                    GetVisibleItemRange(&firstRow, &lastRow);
+                    int* rowItems = FrameAlloc((lastRow > firstRow ? lastRow - firstRow : 0) * sizeof(int)); // Item of each visible row, shared by both passes
+                    int drawnRows = 0;
+                    int listTop = UiPx(LIST_TOP), sideMargin = UiPx(LIST_SIDE_MARGIN), rowStride = UiPx(LIST_ROW_STRIDE), rowHeight = UiPx(LIST_ROW_HEIGHT);
+                    BeginScissorMode(0, listTop, GetScreenWidth(), GetScreenHeight() - listTop - UiPx(LIST_BOTTOM_MARGIN)); // Clip partially visible rows
+                    for (int row = firstRow; row < lastRow; row++) {
+                        int index = ViewItemAt(row); // O(log n) lookup in the current view
+                        if (index < 0) break;
+                        if (rowItems != NULL) rowItems[drawnRows] = index;
+                        drawnRows++;
+                        DrawItemListItem(index, row, sideMargin, listTop + row * rowStride - (int)listScrollOffset, GetScreenWidth() - 2 * sideMargin, rowHeight);
+                    }
+                    // Thumbnails go in a second pass: they all sample the atlas, so the page is one draw call
+                    int thumbSize = UiPx(LIST_THUMB_SIZE);
+                    for (int row = firstRow; row < firstRow + drawnRows; row++) {
+                        int index = (rowItems != NULL) ? rowItems[row - firstRow] : ViewItemAt(row);
+                        int rowY = listTop + row * rowStride - (int)listScrollOffset;
+                        DrawThumbnail(index, (Rectangle){ sideMargin + UiPx(5), rowY + (rowHeight - thumbSize) / 2, thumbSize, thumbSize });
+                    }
+                    EndScissorMode();
 
-                    // Draw each auction item in the list
-                    for (int i = 0; i < itemCount; i++) {
-                        DrawItemListItem(i, 50, 100 + i * 60, GetScreenWidth() - 100, 50);
+                    // Draw a scrollbar when the list is taller than the viewport
+                    float viewportHeight = (float)(GetScreenHeight() - listTop - UiPx(LIST_BOTTOM_MARGIN));
+                    float contentHeight = (float)ViewItemCount() * rowStride;
+                    if (contentHeight > viewportHeight) {
+                        float thumbHeight = viewportHeight * viewportHeight / contentHeight;
+                        if (thumbHeight < UiPx(20)) thumbHeight = (float)UiPx(20); // Keep the thumb grabbable on huge catalogs
+                        float thumbY = listTop + (viewportHeight - thumbHeight) * listScrollOffset / (contentHeight - viewportHeight);
+                        DrawRectangle(GetScreenWidth() - sideMargin + UiPx(10), listTop, UiPx(8), (int)viewportHeight, LIGHTGRAY_CUSTOM);
+                        DrawRectangle(GetScreenWidth() - sideMargin + UiPx(10), (int)thumbY, UiPx(8), (int)thumbHeight, DARKGRAY_CUSTOM);
                     }
-                    // Draw Logout button
-                    Rectangle logoutButtonRect = { GetScreenWidth() - 150, 20, 120, 40 };
-                    DrawRectangleRec(logoutButtonRect, RED_DECLINE);
-                    DrawRectangleLinesEx(logoutButtonRect, 2, DARKGRAY_CUSTOM);
-                    DrawText("Logout", logoutButtonRect.x + logoutButtonRect.width / 2 - MeasureText("Logout", 20) / 2, logoutButtonRect.y + 10, 20, RAYWHITE);
 
                 } break; // End of SCREEN_ITEM_LIST drawing
 
                 case SCREEN_ITEM_DETAILS: {
                     if (selectedItemIndex != -1) {
-                        AuctionItem currentItem = items[selectedItemIndex];
-
-                        DrawText(currentItem.name, GetScreenWidth() / 2 - MeasureText(currentItem.name, 40) / 2, 30, 40, DARKBLUE);
-                        DrawText(TextFormat("Description: %s", currentItem.description), 50, 100, 20, BLACK);
-                        DrawText(TextFormat("Current Bid: $%.2f", currentItem.currentBid), 50, 140, 25, GREEN);
-                        DrawText(TextFormat("Highest Bidder: %s", currentItem.highestBidder), 50, 170, 25, BLUE);
-                        DrawText(TextFormat("Status: %s", currentItem.auctionClosed ? "CLOSED" : "OPEN"), 50, 210, 25, currentItem.auctionClosed ? RED : GREEN);
-
-                        // Draw "Back" button
-                        Rectangle backButtonRect = { 50, GetScreenHeight() - 60, 120, 40 };
-                        DrawRectangleRec(backButtonRect, LIGHTGRAY_CUSTOM);
-                        DrawRectangleLinesEx(backButtonRect, 2, DARKGRAY_CUSTOM);
-                        DrawText("Back", backButtonRect.x + backButtonRect.width / 2 - MeasureText("Back", 20) / 2, backButtonRect.y + 10, 20, DARKGRAY_CUSTOM);
-
-                        // Draw "Place Bid" button (only if auction is open)
-                        if (!currentItem.auctionClosed) {
-                            Rectangle placeBidButtonRect = { GetScreenWidth() - 170, GetScreenHeight() - 60, 120, 40 };
-                            DrawRectangleRec(placeBidButtonRect, GREEN_ACCEPT);
-                            DrawRectangleLinesEx(placeBidButtonRect, 2, DARKGRAY_CUSTOM);
-                            DrawText("Place Bid", placeBidButtonRect.x + placeBidButtonRect.width / 2 - MeasureText("Place Bid", 20) / 2, placeBidButtonRect.y + 10, 20, RAYWHITE);
+                        const char* itemName = GetItemName(selectedItemIndex);
+                        bool itemClosed = items.auctionClosed[selectedItemIndex];
+                        const ItemRenderCache* cache = GetItemRenderCache(selectedItemIndex);
+
+                        DrawUiText(itemName, GetScreenWidth() / 2 - cache->titleWidth / 2, UiPx(30), 40, DARKBLUE);
+                        DrawUiText(FrameFormat("Description: %s", GetItemDescription(selectedItemIndex)), UiPx(50), UiPx(100), 20, BLACK);
+                        DrawUiText(cache->bidLabel, UiPx(50), UiPx(140), 25, GREEN);
+                        DrawUiText(FrameFormat("Highest Bidder: %s", GetHighestBidder(selectedItemIndex)), UiPx(50), UiPx(170), 25, BLUE);
+                        DrawUiText(itemClosed ? "Status: CLOSED" : "Status: OPEN", UiPx(50), UiPx(210), 25, itemClosed ? RED : GREEN);
+                        int64_t endTime = LoadEndTime(selectedItemIndex);
+                        if (!itemClosed && endTime > 0) {
+                            char timeLeft[32];
+                            FormatTimeLeft(endTime - WallClockMs(), timeLeft, sizeof(timeLeft));
+                            DrawUiText(FrameFormat("Ends in: %s", timeLeft), UiPx(50), UiPx(250), 25, DARKGRAY_CUSTOM);
                         }
+                        DrawThumbnail(selectedItemIndex, (Rectangle){ GetScreenWidth() - UiPx(50 + THUMBNAIL_SIZE), UiPx(140), UiPx(THUMBNAIL_SIZE), UiPx(THUMBNAIL_SIZE) });
+
+                        SubmitScreenLayout(SCREEN_ITEM_DETAILS); // Back and (while open) Place Bid buttons
                     } else {
-                        DrawText("No item selected. This shouldn't happen!", 50, 100, 20, RED);
+                        DrawUiText("No item selected. This shouldn't happen!", UiPx(50), UiPx(100), 20, RED);
                     }
                 } break; // End of SCREEN_ITEM_DETAILS drawing
 
                 case SCREEN_PLACE_BID: {
-                    DrawText("Place Your Bid", GetScreenWidth() / 2 - MeasureText("Place Your Bid", 40) / 2, 30, 40, DARKGRAY_CUSTOM);
-                    DrawText(TextFormat("Item: %s", items[selectedItemIndex].name), GetScreenWidth() / 2 - MeasureText(TextFormat("Item: %s", items[selectedItemIndex].name), 25) / 2, 100, 25, BLACK);
-                    DrawText(TextFormat("Current Bid: $%.2f", items[selectedItemIndex].currentBid), GetScreenWidth() / 2 - MeasureText(TextFormat("Current Bid: $%.2f", items[selectedItemIndex].currentBid), 25) / 2, 140, 25, GREEN);
+                    SubmitScreenLayout(SCREEN_PLACE_BID); // Title and buttons
+                    const ItemRenderCache* cache = GetItemRenderCache(selectedItemIndex);
+                    DrawUiText(FrameFormat("Item: %s", GetItemName(selectedItemIndex)), GetScreenWidth() / 2 - cache->itemLabelWidth / 2, UiPx(100), 25, BLACK);
+                    DrawUiText(cache->bidLabel, GetScreenWidth() / 2 - cache->bidLabelWidthLarge / 2, UiPx(140), 25, GREEN);
 
                     DrawInputBox(&bidAmountInput, "Bid Amount:");
-                    DrawInputBox(&bidderNameInput, "Your Name:");
-
-                    // Draw "BID!" button
-                    Rectangle bidButtonRect = { GetScreenWidth() / 2 - 120, 480, 100, 40 };
-                    DrawRectangleRec(bidButtonRect, GREEN_ACCEPT);
-                    DrawRectangleLinesEx(bidButtonRect, 2, DARKGRAY_CUSTOM);
-                    DrawText("BID!", bidButtonRect.x + bidButtonRect.width / 2 - MeasureText("BID!", 20) / 2, bidButtonRect.y + 10, 20, RAYWHITE);
+                    DrawUiText(FrameFormat("Bidding as: %s", GetBidderName(loggedInUserId)), GetScreenWidth() / 2 - UiPx(100), UiPx(390), 20, DARKGRAY_CUSTOM);
 
-                    // Draw "Cancel" button
-                    Rectangle cancelButtonRect = { GetScreenWidth() / 2 + 20, 480, 100, 40 };
-                    DrawRectangleRec(cancelButtonRect, RED_DECLINE);
-                    DrawRectangleLinesEx(cancelButtonRect, 2, DARKGRAY_CUSTOM);
-                    DrawText("Cancel", cancelButtonRect.x + cancelButtonRect.width / 2 - MeasureText("Cancel", 20) / 2, cancelButtonRect.y + 10, 20, RAYWHITE);
 
                 } break; // End of SCREEN_PLACE_BID drawing
             }
+            ProfileEnd(SCREEN_DRAW_SCOPES[drawnScreen], drawStart);
 
             // Always draw temporary UI messages on top of everything else
             if (strlen(uiMessage) > 0) {
-                DrawRectangle(0, GetScreenHeight() - 30, GetScreenWidth(), 30, YELLOW_WARNING);
-                DrawText(uiMessage, GetScreenWidth() / 2 - MeasureText(uiMessage, 20) / 2, GetScreenHeight() - 25, 20, DARKGRAY);
+                DrawRectangle(0, GetScreenHeight() - UiPx(30), GetScreenWidth(), UiPx(30), YELLOW_WARNING);
+                DrawUiText(uiMessage, GetScreenWidth() / 2 - MeasureUiText(uiMessage, 20) / 2, GetScreenHeight() - UiPx(25), 20, DARKGRAY);
             }
 
+            if (profiler.overlayVisible) DrawProfilerOverlay();
+            RecordFrameTime(ProfileBegin() - frameStart);
+
         EndDrawing(); // End drawing operations
+        ResetFrameArena(); // Strings formatted for this frame are no longer referenced
+        if (inputRecording.replaying) RecordReplayFrame(ProfileBegin() - frameStart);
         //----------------------------------------------------------------------------------
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    StopInputRecording(); // Finish the recording, or report the replay's frame times
+    StopCheckpointer(); // Last snapshot, so the next start replays almost nothing
+    CloseBidLedger();  // Commit any bids still waiting for the flush thread
+    DisconnectFromServer(); // Close the link to the bid server (if any)
+    CloseCatalog();    // Stop loading if the catalog was still streaming
+    FreeAuctionData(); // Release the item store
+    StopIoWorker();    // Let queued registrations reach the disk
+    PollIoResults();   // Release what the finished jobs handed back
+    CloseUserLog();    // Flush and close the registration log
+    FreeUsers();       // Release the user directory
+    FreeSessions();    // End every session and forget cached credentials
+    FreeScreenLayouts(); // Release the retained screen layouts
+    ShutdownThumbnails(); // Stop the decoder and release the atlas while the GL context still exists
+    UnloadUiFonts(); // So do the font atlases
     CloseWindow(); // Close window and release OpenGL context and Raylib resources
     //--------------------------------------------------------------------------------------
 
     return 0; // Indicate successful program execution
+#endif
 }
 
 // --- Function Implementations ---
 
-// InitAuctionData: Populates the 'items' array with some predefined auction data.
-void InitAuctionData() {
-    itemCount = 3; // We'll start with 3 items for demonstration purposes
+// InitAuctionData: With 'restore', first tries the newest snapshot in CHECKPOINT_FILE, which
+// holds the whole store at once. Otherwise starts loading CATALOG_FILE into the item store: the
+// first chunk is loaded right away so the first page of the list is ready, and the rest streams
+// in frame by frame. Without a catalog file the store is populated with some predefined
+// auction data.
+void InitAuctionData(bool restore) {
+    CatalogFingerprint(&checkpointer.catalogSize, &checkpointer.catalogModified); // Snapshots record which catalog the items came from
+    if (restore && LoadCheckpoint()) return; // OpenBidLedger replays only the ledger after the snapshot
+    ReserveItems(INITIAL_ITEM_CAPACITY); // Allocate the columns up front
+
+    if (OpenCatalog(CATALOG_FILE)) {
+        PumpCatalogLoader(0.0); // A zero budget still loads one chunk
+        return;
+    }
+
+    // No catalog: we'll start with 3 items for demonstration purposes
+    int64_t now = WallClockMs();
+    int vase = AddAuctionItem("Antique Vase", "A beautiful ceramic vase from the Ming Dynasty.", 150000, "No Bids Yet", false, now + 30 * 60 * 1000); // Auction is open for 30 minutes
+    int comic = AddAuctionItem("Rare Comic Book", "First edition of 'The Amazing Spider-Man #1'.", 500000, "Peter P.", false, now + 5 * 60 * 1000); // Auction is open for 5 minutes
+    int guitar = AddAuctionItem("Vintage Guitar", "1960s electric guitar, well-preserved.", 250000, "Mary J.", true, 0); // Example of a closed auction
+    if (vase >= 0) SetItemImage(vase, "images/vase.png"); // Shown only if the file exists
+    if (comic >= 0) SetItemImage(comic, "images/comic.png");
+    if (guitar >= 0) SetItemImage(guitar, "images/guitar.png");
+}
+
+// --- Catalog Loader Function Implementations ---
+
+// OpenCatalog: Opens a catalog for streaming. The file is CSV with a header row and the columns
+// name,description,current_bid,highest_bidder,closed,ends_at,image. Fields may be "quoted" (with ""
+// for a literal quote); an empty highest_bidder means no bids, closed is 1/true/yes for closed lots,
+// ends_at is the Unix time in seconds the auction closes at (empty or 0 for no deadline), and image
+// is the path of the lot's picture (empty for none).
+bool OpenCatalog(const char* fileName) {
+    catalogLoader.file = fopen(fileName, "rb");
+    if (catalogLoader.file == NULL) return false;
+
+    catalogLoader.fieldIndex = 0;
+    memset(catalogLoader.fieldLengths, 0, sizeof(catalogLoader.fieldLengths));
+    catalogLoader.state = CSV_FIELD_START;
+    catalogLoader.recordsSeen = 0;
+    catalogLoader.skipped = 0;
+    catalogLoader.active = true;
+    TraceLog(LOG_INFO, "Streaming auction catalog from %s.", fileName);
+    return true;
+}
+
+// PumpCatalogLoader: Reads and parses catalog chunks until 'budgetSeconds' have passed (always
+// at least one chunk). Returns true if any items were added.
+bool PumpCatalogLoader(double budgetSeconds) {
+    if (!catalogLoader.active) return false;
+
+    int countBefore = items.count;
+    double deadline = ProfilerClock() + budgetSeconds; // Not GetTime(): the server loads without a window
+    do {
+        size_t length = fread(catalogLoader.chunk, 1, CATALOG_CHUNK_SIZE, catalogLoader.file);
+        if (length == 0) {
+            // End of file: a last record without a trailing newline still counts
+            if (catalogLoader.fieldIndex > 0 || catalogLoader.fieldLengths[0] > 0) FinishCatalogRecord();
+            TraceLog(LOG_INFO, "Catalog loaded: %d items (%d malformed records skipped).", items.count, catalogLoader.skipped);
+            CloseCatalog();
+            break;
+        }
+        ParseCatalogChunk(catalogLoader.chunk, (int)length);
+    } while (ProfilerClock() < deadline);
+
+    return items.count != countBefore;
+}
+
+// ParseCatalogChunk: Runs the CSV state machine over one chunk. Characters are copied directly
+// into the current field buffer (overlong fields are truncated); record ends are dispatched to
+// FinishCatalogRecord.
+void ParseCatalogChunk(const char* data, int length) {
+    CatalogLoader* loader = &catalogLoader;
+    for (int i = 0; i < length; i++) {
+        char c = data[i];
+        switch (loader->state) {
+            case CSV_QUOTE_IN_QUOTED:
+                if (c == '"') { // "" is an escaped quote, stay inside the field
+                    loader->state = CSV_QUOTED;
+                    break;
+                }
+                loader->state = CSV_UNQUOTED; // Closing quote; handle 'c' as in a plain field
+                // fall through
+            case CSV_FIELD_START:
+            case CSV_UNQUOTED:
+                if (c == '"' && loader->state == CSV_FIELD_START) {
+                    loader->state = CSV_QUOTED;
+                    continue;
+                }
+                if (c == ',') {
+                    if (loader->fieldIndex < CATALOG_FIELD_COUNT - 1) loader->fieldIndex++; // Extra columns are folded into the last one
+                    loader->state = CSV_FIELD_START;
+                    continue;
+                }
+                if (c == '\n') {
+                    FinishCatalogRecord();
+                    loader->state = CSV_FIELD_START;
+                    continue;
+                }
+                if (c == '\r') continue; // Windows line endings
+                loader->state = CSV_UNQUOTED;
+                break;
+            case CSV_QUOTED:
+                if (c == '"') {
+                    loader->state = CSV_QUOTE_IN_QUOTED;
+                    continue;
+                }
+                break;
+        }
+
+        // Append the character to the current field if there is room
+        int* fieldLength = &loader->fieldLengths[loader->fieldIndex];
+        if (*fieldLength < MAX_DESC_LENGTH - 1) loader->fields[loader->fieldIndex][(*fieldLength)++] = c;
+    }
+}
+
+// FinishCatalogRecord: Validates the fields of the record that just ended and appends it to
+// the item store. The header row and records without a usable bid are skipped.
+void FinishCatalogRecord() {
+    CatalogLoader* loader = &catalogLoader;
+    int fieldCount = loader->fieldIndex + 1;
+    for (int f = 0; f < CATALOG_FIELD_COUNT; f++) loader->fields[f][loader->fieldLengths[f]] = '\0';
+
+    loader->recordsSeen++;
+    bool isHeader = (loader->recordsSeen == 1);
+    bool isBlank = (fieldCount == 1 && loader->fieldLengths[0] == 0);
+    if (!isHeader && !isBlank) {
+        int64_t currentBid = ParseCents(loader->fields[2]);
+        if (fieldCount < 3 || loader->fieldLengths[0] == 0 || currentBid < 0 || currentBid > MAX_BID_CENTS) {
+            loader->skipped++;
+        } else {
+            loader->fields[0][MAX_NAME_LENGTH - 1] = '\0'; // Names are shorter than descriptions
+            const char* bidder = (loader->fieldLengths[3] > 0) ? loader->fields[3] : "No Bids Yet";
+            const char* closed = loader->fields[4];
+            bool auctionClosed = (closed[0] == '1' || closed[0] == 't' || closed[0] == 'T' || closed[0] == 'y' || closed[0] == 'Y');
+            long long endsAt = strtoll(loader->fields[5], NULL, 10); // 0 if the column is missing or empty
+            int64_t endTime = (endsAt > 0) ? (int64_t)endsAt * 1000 : 0;
+            int index = AddAuctionItem(loader->fields[0], loader->fields[1], currentBid, bidder, auctionClosed, endTime);
+            if (index >= 0) SetItemImage(index, loader->fields[6]);
+            if (index >= 0) ApplyLedgerToItem(index); // Restore bids placed in earlier sessions
+        }
+    }
+
+    // Reset for the next record
+    loader->fieldIndex = 0;
+    memset(loader->fieldLengths, 0, sizeof(loader->fieldLengths));
+}
+
+// CloseCatalog: Stops streaming and releases the catalog file.
+void CloseCatalog() {
+    if (catalogLoader.file != NULL) {
+        fclose(catalogLoader.file);
+        catalogLoader.file = NULL;
+    }
+    catalogLoader.active = false;
+}
+
+// FreeAuctionData: Releases every column and string pool owned by the item store.
+void FreeAuctionData() {
+    free(items.bidState);
+    free(items.auctionClosed);
+    free(items.endTime);
+    free(items.nameOffset);
+    free(items.descriptionOffset);
+    free(items.imageOffset);
+    free(items.renderCache);
+    free(items.names.data);
+    free(items.descriptions.data);
+    free(items.imagePaths.data);
+    items = (ItemStore){ 0 }; // Leave the store empty but reusable
+    FreeItemViews(); // Indexes refer to the old items
+    FreeItemSearch();
+    FreeBidders(); // Bid words referencing the old ids are gone
+    FreeCloseScheduler(&closeScheduler); // Deadlines refer to the old items
+    ForgetThumbnails(); // Cached images belong to the old items
+}
+
+// ReserveItems: Grows every column of the item store to hold at least 'capacity' items.
+// Existing items are preserved. Returns false if memory could not be allocated.
+bool ReserveItems(int capacity) {
+    if (capacity <= items.capacity) return true; // Already big enough
+
+    // Bidding threads must not be running while the store grows; the bid column moves here
+    uint64_t* bidState = realloc(items.bidState, capacity * sizeof(uint64_t));
+    if (bidState == NULL) return false;
+    items.bidState = bidState;
+
+    bool* auctionClosed = realloc(items.auctionClosed, capacity * sizeof(bool));
+    if (auctionClosed == NULL) return false;
+    items.auctionClosed = auctionClosed;
+
+    int64_t* endTime = realloc(items.endTime, capacity * sizeof(int64_t));
+    if (endTime == NULL) return false;
+    items.endTime = endTime;
+
+    int* nameOffset = realloc(items.nameOffset, capacity * sizeof(int));
+    if (nameOffset == NULL) return false;
+    items.nameOffset = nameOffset;
+
+    int* descriptionOffset = realloc(items.descriptionOffset, capacity * sizeof(int));
+    if (descriptionOffset == NULL) return false;
+    items.descriptionOffset = descriptionOffset;
+
+    int* imageOffset = realloc(items.imageOffset, capacity * sizeof(int));
+    if (imageOffset == NULL) return false;
+    items.imageOffset = imageOffset;
+
+    ItemRenderCache* renderCache = realloc(items.renderCache, capacity * sizeof(ItemRenderCache));
+    if (renderCache == NULL) return false;
+    items.renderCache = renderCache;
+
+    items.capacity = capacity; // Only commit the new capacity once every column has grown
+    return true;
+}
+
+// AddAuctionItem: Appends a new item to the item store, growing it if necessary.
+// Returns the index of the new item, or -1 if memory could not be allocated.
+int AddAuctionItem(const char* name, const char* description, int64_t currentBid, const char* highestBidder, bool auctionClosed, int64_t endTime) {
+    if (items.count == items.capacity) {
+        int newCapacity = (items.capacity > 0) ? items.capacity * 2 : INITIAL_ITEM_CAPACITY; // Double to keep appends amortized O(1)
+        if (!ReserveItems(newCapacity)) {
+            TraceLog(LOG_WARNING, "Unable to grow item store to %d items.", newCapacity);
+            return -1;
+        }
+    }
+
+    int nameOffset = StringPoolAdd(&items.names, name);
+    int descriptionOffset = StringPoolAdd(&items.descriptions, description);
+    uint32_t bidderId = InternBidder(highestBidder);
+    if (nameOffset < 0 || descriptionOffset < 0 || bidderId == BIDDER_NONE) {
+        TraceLog(LOG_WARNING, "Unable to store text for item '%s'.", name);
+        return -1;
+    }
+
+    int index = items.count;
+    items.bidState[index] = PackBid(currentBid, bidderId);
+    items.auctionClosed[index] = auctionClosed;
+    items.endTime[index] = endTime;
+    items.nameOffset[index] = nameOffset;
+    items.descriptionOffset[index] = descriptionOffset;
+    items.imageOffset[index] = -1; // See SetItemImage
+    items.renderCache[index].thumbSlot = -1; // Loaded when first drawn
+    items.renderCache[index].valid = false; // Built on first draw
+    items.count++;
+    if (itemViews.enabled) IndexNewItem(index);
+    if (itemSearch.enabled) IndexItemText(index);
+    if (closeScheduler.enabled) ScheduleClose(index);
+    return index;
+}
+
+// GetItemName: Looks up an item's name in the names pool.
+const char* GetItemName(int index) {
+    return items.names.data + items.nameOffset[index];
+}
+
+// GetItemDescription: Looks up an item's description in the descriptions pool.
+const char* GetItemDescription(int index) {
+    return items.descriptions.data + items.descriptionOffset[index];
+}
+
+// InvalidateItemRender: Must be called on the UI thread whenever an item's bid, deadline or
+// auctionClosed changes. Refiles the item in the list views (the render cache would also notice
+// a new bid word by itself) and requests a repaint, so updates from any source show up while
+// the UI is idle.
+void InvalidateItemRender(int index) {
+    items.renderCache[index].valid = false;
+    if (itemViews.enabled) ReindexItem(index);
+    if (itemSearch.active) itemSearch.dirty = true; // The item may have moved in or out of the results
+    RequestRedraw();
+}
+
+// StringPoolAdd: Copies 'text' to the end of the pool.
+// Returns the offset of the stored string, or -1 if memory could not be allocated.
+int StringPoolAdd(StringPool* pool, const char* text) {
+    int length = (int)strlen(text);
+    if (pool->size + length + 1 > pool->capacity) {
+        int newCapacity = (pool->capacity > 0) ? pool->capacity : INITIAL_POOL_CAPACITY;
+        while (pool->size + length + 1 > newCapacity) newCapacity *= 2; // Double until the string fits
+        char* data = realloc(pool->data, newCapacity);
+        if (data == NULL) return -1;
+        pool->data = data;
+        pool->capacity = newCapacity;
+    }
 
-    // Item 1: Antique Vase
-    strcpy(items[0].name, "Antique Vase");
-    strcpy(items[0].description, "A beautiful ceramic vase from the Ming Dynasty.");
-    items[0].currentBid = 1500.00f;
-    strcpy(items[0].highestBidder, "No Bids Yet"); // Initial state
-    items[0].auctionClosed = false; // Auction is open
+    int offset = pool->size;
+    memcpy(pool->data + offset, text, length);
+    pool->data[offset + length] = '\0';
+    pool->size += length + 1;
+    return offset;
+}
 
-    // Item 2: Rare Comic Book
-    strcpy(items[1].name, "Rare Comic Book");
-    strcpy(items[1].description, "First edition of 'The Amazing Spider-Man #1'.");
-    items[1].currentBid = 5000.00f;
-    strcpy(items[1].highestBidder, "Peter P.");
-    items[1].auctionClosed = false; // Auction is open
+#if !defined(AUCTION_HEADLESS) // Drawing and input handling need the window
 
-    // Item 3: Vintage Guitar (example of a closed auction)
-    strcpy(items[2].name, "Vintage Guitar");
-    strcpy(items[2].description, "1960s electric guitar, well-preserved.");
-    items[2].currentBid = 2500.00f;
-    strcpy(items[2].highestBidder, "Mary J.");
-    items[2].auctionClosed = true; // Auction is closed
+// GetItemRenderCache: Returns the cached labels and widths for an item.
+// Formatting and measuring only happen here, the first time a stale entry is drawn.
+const ItemRenderCache* GetItemRenderCache(int index) {
+    ItemRenderCache* cache = &items.renderCache[index];
+    uint64_t bidState = LoadBidState(index);
+    if (!cache->valid || cache->bidState != bidState || cache->uiGeneration != ui.generation) { // A new high bid (from any thread) or UI scale makes the labels stale
+        cache->bidState = bidState;
+        cache->uiGeneration = ui.generation;
+        char amountText[MAX_CENTS_TEXT];
+        snprintf(cache->bidLabel, sizeof(cache->bidLabel), "Current Bid: $%s", FormatCents(BidAmount(bidState), amountText, sizeof(amountText)));
+        cache->bidLabelWidth = MeasureUiText(cache->bidLabel, 20);
+        cache->bidLabelWidthLarge = MeasureUiText(cache->bidLabel, 25);
+        cache->titleWidth = MeasureUiText(GetItemName(index), 40);
+        cache->itemLabelWidth = MeasureUiText(FrameFormat("Item: %s", GetItemName(index)), 25);
+        cache->valid = true;
+    }
+    return cache;
 }
 
 // DrawItemListItem: Renders a single auction item entry in the list view.
-// It displays the item's name, current bid, and status.
-void DrawItemListItem(int index, int x, int y, int width, int height) {
+// It displays the item's name, current bid, and status. 'row' is its position in the view.
+void DrawItemListItem(int index, int row, int x, int y, int width, int height) {
+    double profileStart = ProfileBegin();
     Rectangle itemRect = { (float)x, (float)y, (float)width, (float)height };
     // Alternate row colors for better readability in the list
-    Color bgColor = (index % 2 == 0) ? LIGHTGRAY_CUSTOM : RAYWHITE;
+    Color bgColor = (row % 2 == 0) ? LIGHTGRAY_CUSTOM : RAYWHITE;
 
     // Change background color on mouse hover for visual feedback
-    if (IsMouseOver(itemRect)) {
+    bool hovered = (row == pointer.hoveredRow); // Resolved once per frame, reused for the text color below
+    if (hovered) {
         bgColor = DARKGRAY_CUSTOM; // Darken on hover
     }
 
     DrawRectangleRec(itemRect, bgColor); // Draw the background rectangle
-    DrawRectangleLinesEx(itemRect, 2, DARKGRAY_CUSTOM); // Draw the border
+    DrawRectangleLinesEx(itemRect, (float)UiPx(2), DARKGRAY_CUSTOM); // Draw the border
+
+    // Frame the thumbnail, which is drawn over it in a separate pass (see DrawThumbnail)
+    int thumbSize = UiPx(LIST_THUMB_SIZE);
+    int thumbY = y + (height - thumbSize) / 2;
+    DrawRectangleLines(x + UiPx(5), thumbY, thumbSize, thumbSize, hovered ? RAYWHITE : DARKGRAY_CUSTOM);
+    int textX = x + UiPx(LIST_THUMB_SIZE + 15);
 
     // Draw item name on the left
-    Color textColor = (IsMouseOver(itemRect)) ? RAYWHITE : BLACK; // Text color changes on hover
-    DrawText(items[index].name, x + 10, y + 10, 20, textColor);
-    // Format and draw current bid on the right
-    char bidText[50]; // Buffer for formatted bid string
-    snprintf(bidText, sizeof(bidText), "Current Bid: $%.2f", items[index].currentBid);
-    DrawText(bidText, x + width - MeasureText(bidText, 20) - 10, y + 10, 20, textColor);
+    Color textColor = hovered ? RAYWHITE : BLACK; // Text color changes on hover
+    DrawUiText(GetItemName(index), textX, y + UiPx(10), 20, textColor);
+    // Draw current bid on the right, using the label and width cached for this item
+    const ItemRenderCache* cache = GetItemRenderCache(index);
+    DrawUiText(cache->bidLabel, x + width - cache->bidLabelWidth - UiPx(10), y + UiPx(10), 20, textColor);
 
     // Draw auction status (OPEN/CLOSED) below the name
-    Color statusColor = items[index].auctionClosed ? RED_DECLINE : GREEN_ACCEPT; // Red for closed, green for open
-    DrawText(items[index].auctionClosed ? "CLOSED" : "OPEN", x + 10, y + 35, 15, statusColor);
+    Color statusColor = items.auctionClosed[index] ? RED_DECLINE : GREEN_ACCEPT; // Red for closed, green for open
+    DrawUiText(items.auctionClosed[index] ? "CLOSED" : "OPEN", textX, y + UiPx(35), 15, statusColor);
+    ProfileEnd("DrawItemListItem", profileStart);
+}
+
+// GetVisibleItemRange: Works out which rows intersect the list viewport at the current
+// scroll offset. Writes the half-open range [first, last) so callers never touch off-screen rows.
+void GetVisibleItemRange(int* first, int* last) {
+    int viewportHeight = GetScreenHeight() - UiPx(LIST_TOP) - UiPx(LIST_BOTTOM_MARGIN);
+    int scroll = (int)listScrollOffset;
+    int rowStride = UiPx(LIST_ROW_STRIDE);
+
+    int rowCount = ViewItemCount();
+    *first = scroll / rowStride;
+    *last = (scroll + viewportHeight + rowStride - 1) / rowStride; // Round up to include a partial row
+    if (*first > rowCount) *first = rowCount;
+    if (*last > rowCount) *last = rowCount;
+}
+
+// CollectShownItems: Writes the ids of the items the current screen shows (the visible rows of
+// the list, or the selected item) to 'ids', ascending. Returns how many were written.
+int CollectShownItems(uint32_t* ids, int capacity) {
+    int count = 0;
+    if (currentScreen == SCREEN_ITEM_LIST) {
+        int firstRow, lastRow;
+        GetVisibleItemRange(&firstRow, &lastRow);
+        for (int row = firstRow; row < lastRow && count < capacity; row++) {
+            int index = ViewItemAt(row);
+            if (index < 0) break;
+            ids[count++] = (uint32_t)index;
+        }
+        qsort(ids, count, sizeof(uint32_t), CompareItemIds); // Search views are not in id order
+    } else if ((currentScreen == SCREEN_ITEM_DETAILS || currentScreen == SCREEN_PLACE_BID) && selectedItemIndex >= 0 && capacity > 0) {
+        ids[count++] = (uint32_t)selectedItemIndex;
+    }
+    return count;
+}
+
+// ItemRowAtPoint: Converts a point on the list screen into a row with plain arithmetic.
+// Returns -1 if the point is outside the viewport or in the gap between rows; the row may be
+// past the last item (ViewItemAt then returns -1).
+int ItemRowAtPoint(Vector2 point) {
+    int listTop = UiPx(LIST_TOP), sideMargin = UiPx(LIST_SIDE_MARGIN), rowStride = UiPx(LIST_ROW_STRIDE);
+    int viewportBottom = GetScreenHeight() - UiPx(LIST_BOTTOM_MARGIN);
+    if (point.y < listTop || point.y >= viewportBottom) return -1;
+    if (point.x < sideMargin || point.x >= GetScreenWidth() - sideMargin) return -1;
+
+    int contentY = (int)(point.y - listTop + listScrollOffset); // Y position within the whole list
+    int row = contentY / rowStride;
+    if (contentY % rowStride >= UiPx(LIST_ROW_HEIGHT)) return -1; // Pointing at the gap below a row
+    return row;
+}
+
+// ScrollItemList: Moves the list by 'deltaPixels' and clamps it so the last row stays reachable.
+void ScrollItemList(float deltaPixels) {
+    float viewportHeight = (float)(GetScreenHeight() - UiPx(LIST_TOP) - UiPx(LIST_BOTTOM_MARGIN));
+    float maxScroll = (float)ViewItemCount() * UiPx(LIST_ROW_STRIDE) - viewportHeight;
+    if (maxScroll < 0.0f) maxScroll = 0.0f; // Everything fits, nothing to scroll
+
+    listScrollOffset += deltaPixels;
+    if (listScrollOffset > maxScroll) listScrollOffset = maxScroll;
+    if (listScrollOffset < 0.0f) listScrollOffset = 0.0f;
+    if (pointer.screen == SCREEN_ITEM_LIST) ResolvePointer(SCREEN_ITEM_LIST); // A click in the same frame lands on the row now under the cursor
 }
 
 // DrawInputBox: Renders a text input box on the screen, including its label.
 void DrawInputBox(InputBox* box, const char* label) {
-    DrawText(label, box->rect.x, box->rect.y - 25, 20, DARKGRAY_CUSTOM); // Draw label above the box
+    int textX = (int)box->rect.x + UiPx(5), textY = (int)box->rect.y + UiPx(10);
+    DrawUiText(label, (int)box->rect.x, (int)box->rect.y - UiPx(25), 20, DARKGRAY_CUSTOM); // Draw label above the box
     DrawRectangleRec(box->rect, RAYWHITE); // Draw the input box background
-    DrawRectangleLinesEx(box->rect, 2, box->borderColor); // Draw the border (color changes based on active state)
+    DrawRectangleLinesEx(box->rect, (float)UiPx(2), box->borderColor); // Draw the border (color changes based on active state)
 
     // Draw masked text for passwords if isPassword is true
     if (box->isPassword) {
         char maskedText[MAX_INPUT_CHARS + 1];
         for (int i = 0; i < box->letterCount; i++) maskedText[i] = '*';
         maskedText[box->letterCount] = '\0'; // Null-terminate the masked string
-        DrawText(maskedText, box->rect.x + 5, box->rect.y + 10, 20, BLACK);
+        DrawUiText(maskedText, textX, textY, 20, BLACK);
     } else {
-        DrawText(box->text, box->rect.x + 5, box->rect.y + 10, 20, BLACK); // Draw actual text for non-password fields
+        DrawUiText(box->text, textX, textY, 20, BLACK); // Draw actual text for non-password fields
     }
 
     // Draw a blinking cursor if the input box is active
     if (box->active) {
-        if (((int)(GetTime() * 2.0f) % 2) == 0) { // Simple blinking logic
+        if (((int)(frameInput.time * 2.0) % 2) == 0) { // Simple blinking logic
             // Adjust cursor position for masked input as well
-            float cursorX = box->rect.x + 5 + MeasureText(box->text, 20);
+            int cursorX = textX + MeasureUiText(box->text, 20);
             if (box->isPassword) {
                 char tempMasked[2] = {'*', '\0'};
-                cursorX = box->rect.x + 5 + MeasureText(tempMasked, 20) * box->letterCount;
+                cursorX = textX + MeasureUiText(tempMasked, 20) * box->letterCount;
             }
 
-            DrawText("_", (int)cursorX, (int)box->rect.y + 10, 20, BLACK); // Draw cursor
+            DrawUiText("_", cursorX, textY, 20, BLACK); // Draw cursor
         }
     }
 }
@@ -556,8 +2394,8 @@ void DrawInputBox(InputBox* box, const char* label) {
 // UpdateInputBox: Handles keyboard input for an active input box and manages focus.
 void UpdateInputBox(InputBox* box) {
     // Check if the mouse clicked on this input box to activate/deactivate it
-    if (IsMouseButtonPressed(MOUSE_LEFT_BUTTON)) {
-        if (CheckCollisionPointRec(GetMousePosition(), box->rect)) {
+    if (pointer.pressed) {
+        if (CheckCollisionPointRec(pointer.position, box->rect)) {
             box->active = true;
             box->borderColor = BLUE_HIGHLIGHT; // Highlight when active
         } else {
@@ -568,36 +2406,32 @@ void UpdateInputBox(InputBox* box) {
 
     // Only process keyboard input if this box is active
     if (box->active) {
-        // Get character pressed (unicode)
-        int key = GetCharPressed();
-        while (key > 0) {
+        // Characters typed this frame (unicode)
+        for (int i = 0; i < frameInput.charCount; i++) {
+            int key = frameInput.chars[i];
             // NOTE: Only allow characters in range [32..125] (keyboard)
             if (((key >= 32) && (key <= 125)) && (box->letterCount < MAX_INPUT_CHARS)) {
                 box->text[box->letterCount] = (char)key;
                 box->letterCount++;
             }
-            key = GetCharPressed();  // Get next character if any
         }
 
         // Check for backspace (deletion)
-        if (IsKeyPressed(KEY_BACKSPACE)) {
+        if (FrameKeyPressed(INPUT_KEY_BACKSPACE)) {
             if (box->letterCount > 0) {
                 box->letterCount--;
                 box->text[box->letterCount] = '\0'; // Null-terminate after deletion
             }
         }
         // If Enter is pressed, deactivate the box (often used to submit)
-        if (IsKeyPressed(KEY_ENTER)) {
+        if (FrameKeyPressed(INPUT_KEY_ENTER)) {
              box->active = false;
              box->borderColor = DARKGRAY_CUSTOM;
         }
     }
 }
 
-// IsMouseOver: A simple helper function to check if the mouse is over a rectangle.
-bool IsMouseOver(Rectangle rect) {
-    return CheckCollisionPointRec(GetMousePosition(), rect);
-}
+#endif // !AUCTION_HEADLESS
 
 // ResetInputBoxes: Deactivates and clears all input boxes.
 void ResetInputBoxes() {
@@ -606,11 +2440,6 @@ void ResetInputBoxes() {
     strcpy(bidAmountInput.text, "");
     bidAmountInput.letterCount = 0;
 
-    bidderNameInput.active = false;
-    bidderNameInput.borderColor = DARKGRAY_CUSTOM;
-    strcpy(bidderNameInput.text, "");
-    bidderNameInput.letterCount = 0;
-
     signInUsernameInput.active = false;
     signInUsernameInput.borderColor = DARKGRAY_CUSTOM;
     strcpy(signInUsernameInput.text, "");
@@ -635,101 +2464,5095 @@ void ResetInputBoxes() {
     signUpConfirmPasswordInput.borderColor = DARKGRAY_CUSTOM;
     strcpy(signUpConfirmPasswordInput.text, "");
     signUpConfirmPasswordInput.letterCount = 0;
+
+    // The search query is kept so the list is still filtered when the user comes back to it
+    searchInput.active = false;
+    searchInput.borderColor = DARKGRAY_CUSTOM;
 }
 
 // SetUIMessage: Sets a temporary message to be displayed to the user.
 void SetUIMessage(const char* message) {
     strcpy(uiMessage, message);
     uiMessageTimer = UI_MESSAGE_DURATION; // Start the timer for the message
+    RequestRedraw(); // Show the new message even if no input arrives
 }
 
-// --- User Management Function Implementations ---
+// --- Redraw Scheduling Function Implementations ---
 
-// HashPassword: A very simple (non-cryptographic) hash function for passwords.
-// DO NOT use this for real-world applications! It's purely for demonstration.
-unsigned int HashPassword(const char* password) {
-    unsigned int hash = 5381; // djb2 hash algorithm initial value
-    int c;
-    while ((c = *password++)) {
-        hash = ((hash << 5) + hash) + c; // hash * 33 + c
-    }
-    return hash;
+// RequestRedraw: Marks the screen dirty. Anything that changes what is visible must call this.
+void RequestRedraw() {
+    redrawRequested = true;
 }
 
-// LoadUsers: Reads user data from the USERS_FILE.
-bool LoadUsers() {
-    FILE* file = fopen(USERS_FILE, "r");
-    if (file == NULL) {
-        TraceLog(LOG_INFO, "USERS_FILE not found or unable to open for reading. Starting with no users.");
-        return false; // File doesn't exist yet, or cannot be opened. No users loaded.
-    }
+#if !defined(AUCTION_HEADLESS) // Input polling and screen layouts need the window
 
-    userCount = 0;
-    while (userCount < MAX_USERS && fscanf(file, "%s %u", users[userCount].username, &users[userCount].hashedPassword) == 2) {
-        userCount++;
+// HasInputActivity: Checks the input gathered by the last event poll.
+// GetKeyPressed() drains raylib's key queue, which nothing else reads; GetCharPressed() and
+// IsKeyPressed() used by UpdateInputBox are unaffected.
+bool HasInputActivity() {
+    Vector2 mouseDelta = GetMouseDelta();
+    if (mouseDelta.x != 0.0f || mouseDelta.y != 0.0f) return true;
+    if (GetMouseWheelMove() != 0.0f) return true;
+    for (int button = MOUSE_BUTTON_LEFT; button <= MOUSE_BUTTON_MIDDLE; button++) {
+        if (IsMouseButtonPressed(button) || IsMouseButtonReleased(button)) return true;
     }
+    bool keyPressed = false;
+    while (GetKeyPressed() != 0) keyPressed = true; // Drain the whole queue
+    return keyPressed || IsWindowResized();
+}
 
-    fclose(file);
-    TraceLog(LOG_INFO, "Loaded %d users from %s.", userCount, USERS_FILE);
-    return true;
+// IsAnyInputBoxActive: True if one of the input boxes has focus and shows a blinking cursor.
+bool IsAnyInputBoxActive() {
+    return bidAmountInput.active ||
+           signInUsernameInput.active || signInPasswordInput.active ||
+           signUpUsernameInput.active || signUpPasswordInput.active || signUpConfirmPasswordInput.active ||
+           searchInput.active;
 }
 
-// SaveUsers: Writes current user data to the USERS_FILE.
-bool SaveUsers() {
-    FILE* file = fopen(USERS_FILE, "w"); // "w" truncates (clears) the file if it exists, then writes
-    if (file == NULL) {
-        TraceLog(LOG_WARNING, "Unable to open %s for writing. User data not saved.", USERS_FILE);
-        return false;
-    }
+// IsPasswordBoxActive: True if typed characters may be going into a password box.
+bool IsPasswordBoxActive() {
+    return signInPasswordInput.active || signUpPasswordInput.active || signUpConfirmPasswordInput.active;
+}
 
-    for (int i = 0; i < userCount; i++) {
-        fprintf(file, "%s %u\n", users[i].username, users[i].hashedPassword);
+// WaitForRedrawTrigger: Called instead of drawing when nothing is dirty.
+// With no timed change pending (message timer, cursor blink, catalog loading, server
+// messages, background I/O, auction deadlines, image decoding) it blocks in raylib's
+// event-waiting mode until input arrives. Otherwise it sleeps in short steps so the
+// timer or blink still repaints on time.
+void WaitForRedrawTrigger() {
+    if (uiMessageTimer > 0 || IsAnyInputBoxActive() || catalogLoader.active || netClient.connected || ioWorker.outstanding > 0 || closeScheduler.count > 0 || thumbnails.outstanding > 0) {
+        WaitTime(IDLE_POLL_INTERVAL);
+        PollInputEvents();
+    } else {
+        EnableEventWaiting();
+        PollInputEvents(); // Blocks until the OS delivers an input or window event
+        DisableEventWaiting(); // Drawn frames must not block in EndDrawing
+    }
+}
+
+// --- Screen Layout Function Implementations ---
+
+// SubmitScreenLayout: Draws the static part of a screen (titles and buttons).
+void SubmitScreenLayout(AppScreen screen) {
+    const DrawList* list = PrepareScreenLayout(screen);
+    double profileStart = ProfileBegin();
+    for (int i = 0; i < list->count; i++) {
+        const DrawCommand* command = &list->commands[i];
+        switch (command->type) {
+            case DRAW_FILL: DrawRectangleRec(command->rect, command->color); break;
+            case DRAW_OUTLINE: DrawRectangleLinesEx(command->rect, (float)UiPx(2), command->color); break;
+            case DRAW_TEXT: DrawUiText(command->text, (int)command->rect.x, (int)command->rect.y, command->fontSize, command->color); break;
+            default: break;
+        }
+    }
+    ProfileEnd("SubmitScreenLayout", profileStart);
+}
+
+// PrepareScreenLayout: Returns a screen's draw list and widget table, rebuilding both first if
+// the window was resized or the screen's state 'key' changed.
+DrawList* PrepareScreenLayout(AppScreen screen) {
+    DrawList* list = &screenLayouts[screen];
+    int key = ScreenLayoutKey(screen);
+    if (!list->built || list->width != GetScreenWidth() || list->height != GetScreenHeight() || list->key != key) {
+        list->count = 0;
+        list->widgetCount = 0;
+        memset(list->widgetGrid, 0, sizeof(list->widgetGrid));
+        list->width = GetScreenWidth();
+        list->height = GetScreenHeight();
+        list->key = key;
+        BuildScreenLayout(screen, list, key);
+        SortDrawList(list);
+        list->built = true;
+    }
+    return list;
+}
+
+// ScreenLayoutKey: The state a screen's static layout depends on besides the window size.
+// A different key rebuilds the draw list (a view switch on the list, an item closing).
+int ScreenLayoutKey(AppScreen screen) {
+    switch (screen) {
+        case SCREEN_ITEM_LIST: return (int)itemViews.sort * 2 + (itemViews.openOnly ? 1 : 0); // Button labels
+        case SCREEN_ITEM_DETAILS: return (selectedItemIndex != -1 && !items.auctionClosed[selectedItemIndex]) ? 1 : 0; // "Place Bid" shown
+        default: return 0;
+    }
+}
+
+// BuildScreenLayout: Records the titles and buttons of a screen for the current window size.
+// This is the only place a button's rectangle is written down: the update pass finds clicks
+// through the widgets declared here. Lengths are design pixels (UiPx); positions follow the
+// window's center and edges.
+void BuildScreenLayout(AppScreen screen, DrawList* list, int key) {
+    int width = GetScreenWidth(), height = GetScreenHeight();
+    switch (screen) {
+        case SCREEN_AUTH_MENU: {
+            AddCenteredText(list, "Welcome to the Auction!", width / 2, UiPx(100), 40, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_OPEN_SIGN_IN, (Rectangle){ width / 2 - UiPx(100), height / 2 - UiPx(50), UiPx(200), UiPx(50) }, "Sign In", 30, BLUE_HIGHLIGHT, RAYWHITE);
+            AddButton(list, ACTION_OPEN_SIGN_UP, (Rectangle){ width / 2 - UiPx(100), height / 2 + UiPx(20), UiPx(200), UiPx(50) }, "Sign Up", 30, GREEN_ACCEPT, RAYWHITE);
+        } break;
+
+        case SCREEN_SIGN_IN: {
+            AddCenteredText(list, "Sign In", width / 2, UiPx(100), 40, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_LOGIN, (Rectangle){ width / 2 - UiPx(80), UiPx(400), UiPx(160), UiPx(50) }, "Login", 25, GREEN_ACCEPT, RAYWHITE);
+            AddButton(list, ACTION_BACK, (Rectangle){ width / 2 - UiPx(80), UiPx(470), UiPx(160), UiPx(50) }, "Back", 25, LIGHTGRAY_CUSTOM, DARKGRAY_CUSTOM);
+        } break;
+
+        case SCREEN_SIGN_UP: {
+            AddCenteredText(list, "Sign Up", width / 2, UiPx(100), 40, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_REGISTER, (Rectangle){ width / 2 - UiPx(80), UiPx(410), UiPx(160), UiPx(50) }, "Register", 25, GREEN_ACCEPT, RAYWHITE);
+            AddButton(list, ACTION_BACK, (Rectangle){ width / 2 - UiPx(80), UiPx(480), UiPx(160), UiPx(50) }, "Back", 25, LIGHTGRAY_CUSTOM, DARKGRAY_CUSTOM);
+        } break;
+
+        case SCREEN_ITEM_LIST: {
+            ItemSortOrder sort = (ItemSortOrder)(key / 2);
+            const char* sortLabel = (sort == SORT_HIGHEST_BID) ? "Sort: Highest Bid" : (sort == SORT_ENDING_SOON) ? "Sort: Ending Soon" : "Sort: Listed";
+            const char* filterLabel = (key % 2) ? "Showing: Open" : "Showing: All";
+            AddCenteredText(list, "Auction Items", width / 2, UiPx(30), 40, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_CYCLE_SORT, (Rectangle){ width - UiPx(400), UiPx(68), UiPx(180), UiPx(26) }, sortLabel, 15, LIGHTGRAY_CUSTOM, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_TOGGLE_FILTER, (Rectangle){ width - UiPx(210), UiPx(68), UiPx(160), UiPx(26) }, filterLabel, 15, LIGHTGRAY_CUSTOM, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_LOGOUT, (Rectangle){ width - UiPx(150), UiPx(20), UiPx(120), UiPx(40) }, "Logout", 20, RED_DECLINE, RAYWHITE);
+        } break;
+
+        case SCREEN_ITEM_DETAILS: {
+            AddButton(list, ACTION_BACK, (Rectangle){ UiPx(50), height - UiPx(60), UiPx(120), UiPx(40) }, "Back", 20, LIGHTGRAY_CUSTOM, DARKGRAY_CUSTOM);
+            if (key) AddButton(list, ACTION_OPEN_BID, (Rectangle){ width - UiPx(170), height - UiPx(60), UiPx(120), UiPx(40) }, "Place Bid", 20, GREEN_ACCEPT, RAYWHITE); // Only while the auction is open
+        } break;
+
+        case SCREEN_PLACE_BID: {
+            AddCenteredText(list, "Place Your Bid", width / 2, UiPx(30), 40, DARKGRAY_CUSTOM);
+            AddButton(list, ACTION_SUBMIT_BID, (Rectangle){ width / 2 - UiPx(120), UiPx(480), UiPx(100), UiPx(40) }, "BID!", 20, GREEN_ACCEPT, RAYWHITE);
+            AddButton(list, ACTION_CANCEL_BID, (Rectangle){ width / 2 + UiPx(20), UiPx(480), UiPx(100), UiPx(40) }, "Cancel", 20, RED_DECLINE, RAYWHITE);
+        } break;
+    }
+}
+
+// AddButton: Records a filled, outlined button with its label centered in it, and declares
+// the button as a widget carrying out 'action'.
+void AddButton(DrawList* list, WidgetAction action, Rectangle rect, const char* label, int fontSize, Color fill, Color textColor) {
+    AddWidget(list, action, rect);
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_FILL, .rect = rect, .color = fill });
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_OUTLINE, .rect = rect, .color = DARKGRAY_CUSTOM });
+    int textY = (int)rect.y + ((int)rect.height - UiPx(fontSize) + 1) / 2; // Vertically centered, half a pixel lower when uneven
+    AddCenteredText(list, label, (int)(rect.x + rect.width / 2), textY, fontSize, textColor);
+}
+
+// AddCenteredText: Records a label centered horizontally on 'centerX'. The text is measured here,
+// once per rebuild, instead of every frame. 'text' must outlive the draw list (a literal);
+// 'fontSize' is a design size (see UI_FONT_SIZES).
+void AddCenteredText(DrawList* list, const char* text, int centerX, int y, int fontSize, Color color) {
+    Rectangle position = { (float)(centerX - MeasureUiText(text, fontSize) / 2), (float)y, 0, 0 };
+    PushDrawCommand(list, (DrawCommand){ .type = DRAW_TEXT, .rect = position, .color = color, .text = text, .fontSize = fontSize });
+}
+
+// AddWidget: Appends a widget to the screen's table and sets its bit in every grid cell its
+// rectangle overlaps.
+void AddWidget(DrawList* list, WidgetAction action, Rectangle rect) {
+    if (list->widgetCount == MAX_SCREEN_WIDGETS) {
+        TraceLog(LOG_WARNING, "Too many widgets on one screen; ignoring the rest.");
+        return;
+    }
+    int widget = list->widgetCount++;
+    list->widgets[widget] = (Widget){ rect, action };
+
+    int firstColumn = (int)rect.x * WIDGET_GRID_SIZE / list->width, lastColumn = (int)(rect.x + rect.width) * WIDGET_GRID_SIZE / list->width;
+    int firstRow = (int)rect.y * WIDGET_GRID_SIZE / list->height, lastRow = (int)(rect.y + rect.height) * WIDGET_GRID_SIZE / list->height;
+    if (firstColumn < 0) firstColumn = 0;
+    if (firstRow < 0) firstRow = 0;
+    if (lastColumn >= WIDGET_GRID_SIZE) lastColumn = WIDGET_GRID_SIZE - 1;
+    if (lastRow >= WIDGET_GRID_SIZE) lastRow = WIDGET_GRID_SIZE - 1;
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int column = firstColumn; column <= lastColumn; column++) list->widgetGrid[row * WIDGET_GRID_SIZE + column] |= 1u << widget;
+    }
+}
+
+// WidgetAtPoint: Looks up the grid cell under 'point' and tests only the widgets filed in it.
+// Returns the widget's index in the table, -1 if none contains the point.
+int WidgetAtPoint(const DrawList* list, Vector2 point) {
+    if (point.x < 0 || point.y < 0 || point.x >= list->width || point.y >= list->height) return -1;
+    int column = (int)point.x * WIDGET_GRID_SIZE / list->width;
+    int row = (int)point.y * WIDGET_GRID_SIZE / list->height;
+    uint32_t candidates = list->widgetGrid[row * WIDGET_GRID_SIZE + column];
+    while (candidates != 0) {
+        int widget = __builtin_ctz(candidates);
+        if (CheckCollisionPointRec(point, list->widgets[widget].rect)) return widget;
+        candidates &= candidates - 1; // Next candidate
+    }
+    return -1;
+}
+
+// SamplePointer: Copies the frame's cursor and left button into 'pointer'. Everything that
+// reacts to the mouse afterwards uses 'pointer' instead of asking again.
+void SamplePointer() {
+    pointer.position = frameInput.mouse;
+    pointer.pressed = frameInput.leftPressed;
+}
+
+// ResolvePointer: Resolves the sampled cursor against a screen: the widget under it (and the
+// action clicked, if the button went down) and, on the list screen, the row under it. A row
+// rather than an item is kept so the hover stays right when the rows are refiled or filtered.
+void ResolvePointer(AppScreen screen) {
+    const DrawList* list = PrepareScreenLayout(screen);
+    pointer.screen = screen;
+    pointer.hoveredWidget = WidgetAtPoint(list, pointer.position);
+    pointer.clicked = (pointer.pressed && pointer.hoveredWidget >= 0) ? list->widgets[pointer.hoveredWidget].action : ACTION_NONE;
+    pointer.scrollOffset = listScrollOffset;
+    pointer.hoveredRow = (screen == SCREEN_ITEM_LIST) ? ItemRowAtPoint(pointer.position) : -1;
+}
+
+// PushDrawCommand: Appends a command to a draw list, growing it if needed. A command that
+// cannot be stored is dropped (the screen then misses a widget until the next rebuild).
+void PushDrawCommand(DrawList* list, DrawCommand command) {
+    if (list->count == list->capacity) {
+        int newCapacity = (list->capacity > 0) ? list->capacity * 2 : 16;
+        DrawCommand* commands = realloc(list->commands, newCapacity * sizeof(DrawCommand));
+        if (commands == NULL) {
+            TraceLog(LOG_WARNING, "Unable to grow a screen draw list to %d commands.", newCapacity);
+            return;
+        }
+        list->commands = commands;
+        list->capacity = newCapacity;
+    }
+    list->commands[list->count++] = command;
+}
+
+// SortDrawList: Reorders a draw list so all fills come first, then all outlines, then all
+// text, keeping the recorded order within each group. Shapes and glyphs then reach raylib's
+// batch in long runs of the same texture instead of alternating per button. This is only
+// correct because static widgets do not overlap each other.
+void SortDrawList(DrawList* list) {
+    if (list->count < 2) return;
+    DrawCommand* sorted = malloc(list->count * sizeof(DrawCommand));
+    if (sorted == NULL) return; // Recorded order draws the same picture, just in more batches
+    int next = 0;
+    for (int type = 0; type < DRAW_COMMAND_TYPES; type++) {
+        for (int i = 0; i < list->count; i++) {
+            if (list->commands[i].type == (DrawCommandType)type) sorted[next++] = list->commands[i];
+        }
+    }
+    memcpy(list->commands, sorted, list->count * sizeof(DrawCommand));
+    free(sorted);
+}
+
+// FreeScreenLayouts: Releases the draw lists of every screen.
+void FreeScreenLayouts() {
+    for (int screen = 0; screen < SCREEN_COUNT; screen++) {
+        free(screenLayouts[screen].commands);
+        screenLayouts[screen] = (DrawList){ 0 };
+    }
+}
+
+// --- UI Scaling Function Implementations ---
+
+// UpdateUiScale: Called before anything is hit-tested or drawn. The scale is the largest
+// multiple of UI_SCALE_STEP at which the design fits the window, so a 4K window shows the same
+// screens 3.5 times as large instead of a small 800x600 corner. A new window size moves the
+// input boxes (the screen layouts notice it on their own, see PrepareScreenLayout); a new scale
+// also re-bakes the fonts and stales every measured text width.
+void UpdateUiScale() {
+    int width = GetScreenWidth(), height = GetScreenHeight();
+    if (ui.ready && width == ui.width && height == ui.height) return;
+    float fit = (float)width / UI_DESIGN_WIDTH;
+    if ((float)height / UI_DESIGN_HEIGHT < fit) fit = (float)height / UI_DESIGN_HEIGHT;
+    float scale = (int)(fit / UI_SCALE_STEP) * UI_SCALE_STEP;
+    if (scale < UI_MIN_SCALE) scale = UI_MIN_SCALE;
+
+    ui.width = width;
+    ui.height = height;
+    if (!ui.ready || scale != ui.scale) {
+        if (ui.ready) listScrollOffset *= scale / ui.scale; // The same row stays at the top of the list
+        ui.scale = scale;
+        UnloadUiFonts();
+        LoadUiFonts(scale);
+        ui.generation++; // Item render caches re-measure their labels when next drawn
+        ui.ready = true;
+    }
+    LayoutInputBoxes();
+    ScrollItemList(0.0f); // Clamp to the new viewport height
+}
+
+// LayoutInputBoxes: Places every input box for the current window size and scale. Only the
+// rectangles change; text and focus are kept.
+void LayoutInputBoxes() {
+    int centerX = GetScreenWidth() / 2;
+    bidAmountInput.rect = (Rectangle){ centerX - UiPx(100), UiPx(300), UiPx(200), UiPx(40) };
+    signInUsernameInput.rect = (Rectangle){ centerX - UiPx(120), UiPx(250), UiPx(240), UiPx(40) };
+    signInPasswordInput.rect = (Rectangle){ centerX - UiPx(120), UiPx(320), UiPx(240), UiPx(40) };
+    signUpUsernameInput.rect = (Rectangle){ centerX - UiPx(120), UiPx(200), UiPx(240), UiPx(40) };
+    signUpPasswordInput.rect = (Rectangle){ centerX - UiPx(120), UiPx(270), UiPx(240), UiPx(40) };
+    signUpConfirmPasswordInput.rect = (Rectangle){ centerX - UiPx(120), UiPx(340), UiPx(240), UiPx(40) };
+    searchInput.rect = (Rectangle){ UiPx(20), UiPx(60), UiPx(230), UiPx(34) };
+}
+
+// LoadUiFonts: Bakes each UI text size into its own atlas at 'scale' from UI_FONT_FILE, so
+// glyphs are rasterized at the size they are drawn at instead of being stretched on every
+// call, and caches each printable glyph's advance. Without the file, raylib's default font is
+// drawn at the scaled size the way DrawText draws it (and looks as blocky as DrawText does).
+void LoadUiFonts(float scale) {
+    bool haveFontFile = FileExists(UI_FONT_FILE);
+    int fileSize = 0;
+    unsigned char* fileData = haveFontFile ? LoadFileData(UI_FONT_FILE, &fileSize) : NULL; // Read once for all sizes
+    for (int i = 0; i < UI_FONT_SIZE_COUNT; i++) {
+        UiFont* uiFont = &ui.fonts[i];
+        uiFont->pixelSize = (float)(int)(UI_FONT_SIZES[i] * scale + 0.5f);
+        uiFont->baked = false;
+        if (fileData != NULL) {
+            uiFont->font = LoadFontFromMemory(GetFileExtension(UI_FONT_FILE), fileData, fileSize, (int)uiFont->pixelSize, NULL, 0); // Printable ASCII
+            uiFont->baked = uiFont->font.texture.id != GetFontDefault().texture.id; // raylib hands back the default font on failure
+        }
+        if (uiFont->baked) {
+            uiFont->spacing = 0.0f; // TrueType advances already include the gap
+        } else {
+            uiFont->font = GetFontDefault();
+            uiFont->spacing = (float)((int)uiFont->pixelSize / 10); // DrawText's spacing for the 10 pixel default font
+        }
+
+        float glyphScale = uiFont->pixelSize / uiFont->font.baseSize;
+        for (int glyph = 0; glyph < UI_FONT_GLYPH_COUNT; glyph++) {
+            int index = GetGlyphIndex(uiFont->font, UI_FONT_FIRST_GLYPH + glyph);
+            float advance = (uiFont->font.glyphs[index].advanceX != 0) ? (float)uiFont->font.glyphs[index].advanceX : uiFont->font.recs[index].width; // As DrawTextEx advances
+            uiFont->advance[glyph] = advance * glyphScale;
+        }
+    }
+    if (fileData != NULL) UnloadFileData(fileData); // The atlases keep no reference to it
+    if (haveFontFile && !ui.fonts[0].baked) TraceLog(LOG_WARNING, "Unable to load %s. Using the default font.", UI_FONT_FILE);
+}
+
+// UnloadUiFonts: Releases the atlases baked from UI_FONT_FILE. The default font belongs to raylib.
+void UnloadUiFonts() {
+    for (int i = 0; i < UI_FONT_SIZE_COUNT; i++) {
+        if (ui.fonts[i].baked) UnloadFont(ui.fonts[i].font);
+        ui.fonts[i].baked = false;
+    }
+}
+
+// UiPx: Converts a length in design pixels to window pixels, rounded to the nearest pixel.
+int UiPx(int designPixels) {
+    return (int)(designPixels * ui.scale + 0.5f);
+}
+
+// UiFontFor: Returns the atlas baked for 'designSize', or for the closest size in UI_FONT_SIZES.
+const UiFont* UiFontFor(int designSize) {
+    int best = 0;
+    for (int i = 1; i < UI_FONT_SIZE_COUNT; i++) {
+        if (abs(UI_FONT_SIZES[i] - designSize) < abs(UI_FONT_SIZES[best] - designSize)) best = i;
+    }
+    return &ui.fonts[best];
+}
+
+// MeasureUiText: Width in window pixels of 'text' drawn by DrawUiText at 'designSize'.
+// Printable ASCII is summed from the cached advances; anything else (UTF-8 item names) is left
+// to raylib, which decodes it the way DrawTextEx does.
+int MeasureUiText(const char* text, int designSize) {
+    const UiFont* uiFont = UiFontFor(designSize);
+    float width = 0.0f;
+    int length = 0;
+    for (const unsigned char* c = (const unsigned char*)text; *c != '\0'; c++, length++) {
+        if (*c < UI_FONT_FIRST_GLYPH || *c >= UI_FONT_FIRST_GLYPH + UI_FONT_GLYPH_COUNT) {
+            return (int)MeasureTextEx(uiFont->font, text, uiFont->pixelSize, uiFont->spacing).x;
+        }
+        width += uiFont->advance[*c - UI_FONT_FIRST_GLYPH];
+    }
+    if (length > 1) width += (length - 1) * uiFont->spacing;
+    return (int)width;
+}
+
+// DrawUiText: Draws 'text' at window position (x, y) with the atlas of 'designSize', at the
+// pixel size the atlas was baked for.
+void DrawUiText(const char* text, int x, int y, int designSize, Color color) {
+    const UiFont* uiFont = UiFontFor(designSize);
+    DrawTextEx(uiFont->font, text, (Vector2){ (float)x, (float)y }, uiFont->pixelSize, uiFont->spacing, color);
+}
+
+// --- Input Recording Function Implementations ---
+
+// SampleInput: Fills frameInput for the frame starting at 'now'. A live session reads raylib
+// (and --record appends what it read after the update); a replay decodes the next recorded
+// frame and runs it at a fixed timestep. Returns false when a replay has no frames left.
+bool SampleInput(double now) {
+    frameInput.ioResults = 0;
+    if (inputRecording.replaying) return ReadRecordedFrame();
+    SampleLiveInput(now);
+    return true;
+}
+
+// SampleLiveInput: Reads the mouse and the keys the application uses from raylib. The cursor is
+// rounded to whole pixels so a recorded session sees exactly what its replay will.
+void SampleLiveInput(double now) {
+    static const int keyCodes[INPUT_KEY_COUNT] = { KEY_BACKSPACE, KEY_ENTER, KEY_PAGE_UP, KEY_PAGE_DOWN, KEY_F3, KEY_F12 };
+    Vector2 mouse = GetMousePosition();
+    frameInput.time = now;
+    frameInput.mouse = (Vector2){ (float)(int16_t)(mouse.x + (mouse.x < 0.0f ? -0.5f : 0.5f)), (float)(int16_t)(mouse.y + (mouse.y < 0.0f ? -0.5f : 0.5f)) };
+    frameInput.leftPressed = IsMouseButtonPressed(MOUSE_LEFT_BUTTON);
+    frameInput.wheel = GetMouseWheelMove();
+    frameInput.keys = 0;
+    for (int key = 0; key < INPUT_KEY_COUNT; key++) {
+        if (IsKeyPressed(keyCodes[key])) frameInput.keys |= (uint8_t)(1u << key);
+    }
+    frameInput.charCount = 0;
+    for (int codepoint = GetCharPressed(); codepoint > 0; codepoint = GetCharPressed()) {
+        if (frameInput.charCount < INPUT_MAX_CHARS) frameInput.chars[frameInput.charCount++] = codepoint;
+    }
+    frameInput.activity = HasInputActivity() || frameInput.charCount > 0;
+    frameInput.passwordFocus = IsPasswordBoxActive();
+}
+
+// FrameKeyPressed: True if 'key' was pressed during this frame.
+bool FrameKeyPressed(InputKey key) {
+    return (frameInput.keys & (1u << key)) != 0;
+}
+
+// StartInputRecording: Creates 'fileName' and writes the header: magic, version and the window
+// size the session starts at.
+bool StartInputRecording(const char* fileName) {
+    inputRecording.file = fopen(fileName, "wb");
+    if (inputRecording.file == NULL) {
+        TraceLog(LOG_ERROR, "Unable to create input recording %s.", fileName);
+        return false;
+    }
+    NetBuffer* out = &inputRecording.encoded;
+    out->size = 0;
+    PutU32(out, INPUT_RECORD_MAGIC);
+    PutU32(out, INPUT_RECORD_VERSION);
+    PutU32(out, (uint32_t)GetScreenWidth());
+    PutU32(out, (uint32_t)GetScreenHeight());
+    if (out->size != 16 || fwrite(out->data, 1, (size_t)out->size, inputRecording.file) != (size_t)out->size) {
+        TraceLog(LOG_ERROR, "Unable to write input recording %s.", fileName);
+        fclose(inputRecording.file);
+        inputRecording.file = NULL;
+        return false;
+    }
+    inputRecording.recording = true;
+    inputRecording.lastMouse = (Vector2){ 0.0f, 0.0f };
+    inputRecording.frames = 0;
+    TraceLog(LOG_INFO, "Recording input to %s.", fileName);
+    return true;
+}
+
+// StartInputReplay: Maps a recording made with --record and checks its header. A window of a
+// different size still replays, but clicks may land on different widgets.
+bool StartInputReplay(const char* fileName, bool render) {
+    size_t size = 0;
+    void* data = MapFileReadOnly(fileName, &size);
+    if (data == NULL) {
+        TraceLog(LOG_ERROR, "Unable to open input recording %s.", fileName);
+        return false;
+    }
+    if (size > INT32_MAX) { // NetReader counts in ints
+        TraceLog(LOG_ERROR, "Input recording %s is too large.", fileName);
+        UnmapFile(data, size);
+        return false;
+    }
+    NetReader reader = { .data = data, .remaining = (int)size, .ok = true };
+    uint32_t magic = GetU32(&reader);
+    uint32_t version = GetU32(&reader);
+    uint32_t width = GetU32(&reader);
+    uint32_t height = GetU32(&reader);
+    if (!reader.ok || magic != INPUT_RECORD_MAGIC || version != INPUT_RECORD_VERSION) {
+        TraceLog(LOG_ERROR, "%s is not an input recording of this version.", fileName);
+        UnmapFile(data, size);
+        return false;
+    }
+    if (width != (uint32_t)GetScreenWidth() || height != (uint32_t)GetScreenHeight()) {
+        TraceLog(LOG_WARNING, "Input recording %s was made at %ux%u, replaying at %dx%d.", fileName, width, height, GetScreenWidth(), GetScreenHeight());
+    }
+    inputRecording.data = data;
+    inputRecording.size = size;
+    inputRecording.reader = reader;
+    inputRecording.replaying = true;
+    inputRecording.render = render;
+    inputRecording.lastMouse = (Vector2){ 0.0f, 0.0f };
+    inputRecording.startTime = GetTime();
+    inputRecording.frames = 0;
+    inputRecording.frameTimeCount = 0;
+    TraceLog(LOG_INFO, "Replaying input from %s%s.", fileName, render ? "" : " without rendering");
+    return true;
+}
+
+// StopInputRecording: Closes a recording, or unmaps a replay and logs its frame time
+// percentiles; a replay also writes the profiler's trace so runs can be compared scope by scope.
+void StopInputRecording() {
+    if (inputRecording.recording) {
+        if (fclose(inputRecording.file) != 0) TraceLog(LOG_WARNING, "Input recording may be incomplete.");
+        else TraceLog(LOG_INFO, "Recorded %lld frames of input.", inputRecording.frames);
+        inputRecording.file = NULL;
+        inputRecording.recording = false;
+    }
+    if (inputRecording.replaying) {
+        int count = inputRecording.frameTimeCount;
+        if (count > 0) {
+            float* times = inputRecording.frameTimes;
+            qsort(times, (size_t)count, sizeof(float), CompareFloats);
+            TraceLog(LOG_INFO, "Replayed %lld frames: p50 %.3f ms, p90 %.3f ms, p99 %.3f ms, max %.3f ms.",
+                     inputRecording.frames, times[count / 2] * 1000.0f, times[count * 9 / 10] * 1000.0f,
+                     times[count * 99 / 100] * 1000.0f, times[count - 1] * 1000.0f);
+        }
+        if (ExportChromeTrace(PROFILER_TRACE_FILE)) TraceLog(LOG_INFO, "Replay trace written to %s.", PROFILER_TRACE_FILE);
+        UnmapFile(inputRecording.data, inputRecording.size);
+        inputRecording.data = NULL;
+        inputRecording.replaying = false;
+    }
+    free(inputRecording.encoded.data);
+    free(inputRecording.frameTimes);
+    inputRecording.encoded = (NetBuffer){ 0 };
+    inputRecording.frameTimes = NULL;
+    inputRecording.frameTimeCount = inputRecording.frameTimeCapacity = 0;
+}
+
+// WriteRecordedFrame: Appends frameInput as a flags byte followed by the fields it selects.
+// Idle frames cost one byte. Recording stops (with a warning) if the file cannot be written.
+// Passwords never reach the file: while a password box has focus, before or after the update
+// (a click or Enter can move the focus in the frame the characters arrive), each character is
+// recorded as INPUT_PASSWORD_PLACEHOLDER. A replay types as many placeholders, so the screens
+// see the same keystrokes and its sign-ins and sign-ups use the placeholder password. Captures
+// run in CAPTURE_DIRECTORY, which starts every session with CAPTURE_USER only: signing in to it
+// (its password is placeholders) or to an account signed up earlier in the same session
+// behaves the same when replayed.
+void WriteRecordedFrame() {
+    NetBuffer* out = &inputRecording.encoded;
+    bool moved = frameInput.mouse.x != inputRecording.lastMouse.x || frameInput.mouse.y != inputRecording.lastMouse.y;
+    int ioResults = frameInput.ioResults > UINT8_MAX ? UINT8_MAX : frameInput.ioResults; // IO_QUEUE_CAPACITY keeps this in range
+    uint8_t flags = 0;
+    if (frameInput.activity) flags |= INPUT_FRAME_ACTIVITY;
+    if (frameInput.leftPressed) flags |= INPUT_FRAME_LEFT_PRESSED;
+    if (moved) flags |= INPUT_FRAME_MOUSE;
+    if (frameInput.wheel != 0.0f) flags |= INPUT_FRAME_WHEEL;
+    if (frameInput.keys != 0) flags |= INPUT_FRAME_KEYS;
+    if (frameInput.charCount > 0) flags |= INPUT_FRAME_CHARS;
+    if (ioResults > 0) flags |= INPUT_FRAME_IO;
+
+    out->size = 0;
+    PutU8(out, flags);
+    if (moved) {
+        PutU32(out, (uint32_t)(uint16_t)(int16_t)frameInput.mouse.x | (uint32_t)(uint16_t)(int16_t)frameInput.mouse.y << 16);
+        inputRecording.lastMouse = frameInput.mouse;
+    }
+    if (flags & INPUT_FRAME_WHEEL) {
+        uint32_t bits;
+        memcpy(&bits, &frameInput.wheel, sizeof(bits));
+        PutU32(out, bits);
+    }
+    if (flags & INPUT_FRAME_KEYS) PutU8(out, frameInput.keys);
+    if (flags & INPUT_FRAME_CHARS) {
+        PutU8(out, (uint8_t)frameInput.charCount);
+        bool secret = frameInput.passwordFocus || IsPasswordBoxActive();
+        for (int i = 0; i < frameInput.charCount; i++) PutU32(out, secret ? (uint32_t)INPUT_PASSWORD_PLACEHOLDER : (uint32_t)frameInput.chars[i]);
+    }
+    if (flags & INPUT_FRAME_IO) PutU8(out, (uint8_t)ioResults);
+
+    if (out->size == 0 || fwrite(out->data, 1, (size_t)out->size, inputRecording.file) != (size_t)out->size) {
+        TraceLog(LOG_WARNING, "Unable to write input recording, recording stopped.");
+        fclose(inputRecording.file);
+        inputRecording.file = NULL;
+        inputRecording.recording = false;
+        return;
+    }
+    inputRecording.frames++;
+}
+
+// ReadRecordedFrame: Decodes the next frame into frameInput. Fields a frame does not carry keep
+// their idle value, except the cursor, which stays where the last frame left it.
+bool ReadRecordedFrame() {
+    NetReader* reader = &inputRecording.reader;
+    if (reader->remaining == 0) return false; // Clean end of the recording
+    uint8_t flags = GetU8(reader);
+    frameInput.time = inputRecording.startTime + (double)inputRecording.frames * INPUT_REPLAY_TIMESTEP;
+    frameInput.activity = (flags & INPUT_FRAME_ACTIVITY) != 0;
+    frameInput.leftPressed = (flags & INPUT_FRAME_LEFT_PRESSED) != 0;
+    if (flags & INPUT_FRAME_MOUSE) {
+        uint32_t packed = GetU32(reader);
+        inputRecording.lastMouse = (Vector2){ (float)(int16_t)(packed & 0xFFFF), (float)(int16_t)(packed >> 16) };
+    }
+    frameInput.mouse = inputRecording.lastMouse;
+    frameInput.wheel = 0.0f;
+    if (flags & INPUT_FRAME_WHEEL) {
+        uint32_t bits = GetU32(reader);
+        memcpy(&frameInput.wheel, &bits, sizeof(bits));
+    }
+    frameInput.keys = (flags & INPUT_FRAME_KEYS) ? GetU8(reader) : 0;
+    frameInput.charCount = 0;
+    if (flags & INPUT_FRAME_CHARS) {
+        int count = GetU8(reader);
+        for (int i = 0; i < count; i++) {
+            uint32_t codepoint = GetU32(reader);
+            if (frameInput.charCount < INPUT_MAX_CHARS) frameInput.chars[frameInput.charCount++] = (int)codepoint;
+        }
+    }
+    frameInput.ioResults = (flags & INPUT_FRAME_IO) ? GetU8(reader) : 0;
+    if (!reader->ok) {
+        TraceLog(LOG_WARNING, "Input recording is truncated after %lld frames.", inputRecording.frames);
+        return false;
+    }
+    inputRecording.frames++;
+    inputRecording.frameWait = 0.0;
+    return true;
+}
+
+// WaitForIoResults: Applies the I/O results the recorded frame applied, waiting for the worker
+// if it has not finished them yet. The waiting is left out of the frame's replay time.
+void WaitForIoResults(int count) {
+    double waitStart = GetTime();
+    while (count > 0) {
+        count -= ApplyIoResults(count);
+        if (count == 0) break;
+        if (ioWorker.outstanding == 0 || GetTime() - waitStart > INPUT_REPLAY_IO_TIMEOUT) {
+            TraceLog(LOG_WARNING, "Replay frame %lld expected %d more I/O results; the replay may diverge.", inputRecording.frames, count);
+            break;
+        }
+        WaitTime(0.001);
+    }
+    inputRecording.frameWait += GetTime() - waitStart;
+}
+
+// RecordReplayFrame: Keeps the CPU time of one replayed frame for the summary.
+void RecordReplayFrame(double seconds) {
+    if (inputRecording.frameTimeCount == inputRecording.frameTimeCapacity) {
+        int capacity = inputRecording.frameTimeCapacity > 0 ? inputRecording.frameTimeCapacity * 2 : 1024;
+        float* grown = realloc(inputRecording.frameTimes, (size_t)capacity * sizeof(float));
+        if (grown == NULL) return; // The summary just misses this frame
+        inputRecording.frameTimes = grown;
+        inputRecording.frameTimeCapacity = capacity;
+    }
+    seconds -= inputRecording.frameWait;
+    inputRecording.frameTimes[inputRecording.frameTimeCount++] = (float)(seconds > 0.0 ? seconds : 0.0);
+}
+
+// EnterCaptureDirectory: Makes CAPTURE_DIRECTORY the working directory and removes the user
+// files an earlier capture left there, so a recording and its replay start from the same users
+// and neither touches the real ones. The catalog, images and font are read from there too.
+bool EnterCaptureDirectory() {
+    mkdir(CAPTURE_DIRECTORY, 0755); // Fails harmlessly if it already exists
+    if (chdir(CAPTURE_DIRECTORY) != 0) {
+        TraceLog(LOG_ERROR, "Unable to enter %s.", CAPTURE_DIRECTORY);
+        return false;
+    }
+    const char* staleFiles[] = { USERS_FILE, USERS_TEMP_FILE, USERS_LOG_FILE, USERS_DB_FILE, USERS_DB_TEMP_FILE };
+    for (int i = 0; i < (int)(sizeof(staleFiles) / sizeof(staleFiles[0])); i++) remove(staleFiles[i]);
+    return true;
+}
+
+// AddCaptureUser: Adds CAPTURE_USER with CAPTURE_PASSWORD to the (empty) user directory. It is
+// not logged, so it only exists for the session, like everything else in CAPTURE_DIRECTORY.
+bool AddCaptureUser() {
+    PasswordHash hash;
+    bool added = HashPassword(CAPTURE_PASSWORD, &hash) && AddUser(CAPTURE_USER, &hash);
+    if (!added) TraceLog(LOG_WARNING, "Unable to add the %s account.", CAPTURE_USER);
+    return added;
+}
+
+#endif // !AUCTION_HEADLESS
+
+// --- Item View Function Implementations ---
+
+// EnableItemViews: Indexes every item loaded so far; AddAuctionItem and InvalidateItemRender
+// keep the indexes current afterwards. Only the UI thread may call these functions.
+void EnableItemViews() {
+    itemViews.enabled = true;
+    for (int i = 0; i < items.count; i++) IndexNewItem(i);
+}
+
+// FreeItemViews: Releases the indexes. The current view mode is kept.
+void FreeItemViews() {
+    ItemTreap* trees[] = { &itemViews.byBid, &itemViews.byEnd };
+    for (int t = 0; t < 2; t++) {
+        free(trees[t]->left);
+        free(trees[t]->right);
+        free(trees[t]->size);
+        free(trees[t]->openSize);
+    }
+    free(itemViews.key);
+    free(itemViews.endKey);
+    free(itemViews.keyClosed);
+    free(itemViews.closedBits);
+    free(itemViews.openFenwick);
+    itemViews = (ItemViews){ .enabled = itemViews.enabled, .sort = itemViews.sort, .openOnly = itemViews.openOnly,
+                             .byBid = { .order = SORT_HIGHEST_BID, .root = -1 }, .byEnd = { .order = SORT_ENDING_SOON, .root = -1 } };
+}
+
+// ReserveItemTreap: Grows one treap's per-node arrays to 'capacity' nodes.
+bool ReserveItemTreap(ItemTreap* tree, int capacity) {
+    int* left = realloc(tree->left, capacity * sizeof(int));
+    if (left != NULL) tree->left = left;
+    int* right = realloc(tree->right, capacity * sizeof(int));
+    if (right != NULL) tree->right = right;
+    int* size = realloc(tree->size, capacity * sizeof(int));
+    if (size != NULL) tree->size = size;
+    int* openSize = realloc(tree->openSize, capacity * sizeof(int));
+    if (openSize != NULL) tree->openSize = openSize;
+    return left != NULL && right != NULL && size != NULL && openSize != NULL;
+}
+
+// ReserveItemViews: Grows the per-item arrays (doubling) and, when the bitmap needs more words,
+// rebuilds the Fenwick tree over the larger bitmap in O(words).
+bool ReserveItemViews(int capacity) {
+    if (capacity <= itemViews.capacity) return true;
+    int newCapacity = (itemViews.capacity > 0) ? itemViews.capacity : INITIAL_ITEM_CAPACITY;
+    while (newCapacity < capacity) newCapacity *= 2;
+
+    if (!ReserveItemTreap(&itemViews.byBid, newCapacity) || !ReserveItemTreap(&itemViews.byEnd, newCapacity)) return false;
+    int64_t* key = realloc(itemViews.key, newCapacity * sizeof(int64_t));
+    if (key != NULL) itemViews.key = key;
+    int64_t* endKey = realloc(itemViews.endKey, newCapacity * sizeof(int64_t));
+    if (endKey != NULL) itemViews.endKey = endKey;
+    bool* keyClosed = realloc(itemViews.keyClosed, newCapacity * sizeof(bool));
+    if (keyClosed != NULL) itemViews.keyClosed = keyClosed;
+    if (key == NULL || endKey == NULL || keyClosed == NULL) return false;
+
+    int wordCapacity = (newCapacity + 63) / 64;
+    uint64_t* closedBits = realloc(itemViews.closedBits, wordCapacity * sizeof(uint64_t));
+    if (closedBits == NULL) return false;
+    itemViews.closedBits = closedBits;
+    for (int w = itemViews.wordCapacity; w < wordCapacity; w++) closedBits[w] = ~(uint64_t)0; // No items yet
+    int* fenwick = calloc(wordCapacity + 1, sizeof(int));
+    if (fenwick == NULL) return false;
+    for (int w = 0; w < wordCapacity; w++) { // O(n) Fenwick build
+        int at = w + 1;
+        fenwick[at] += 64 - __builtin_popcountll(closedBits[w]);
+        int parent = at + (at & -at);
+        if (parent <= wordCapacity) fenwick[parent] += fenwick[at];
+    }
+    free(itemViews.openFenwick);
+    itemViews.openFenwick = fenwick;
+    itemViews.wordCapacity = wordCapacity;
+    itemViews.capacity = newCapacity;
+    return true;
+}
+
+// IndexNewItem: Files a newly appended item in every index (O(log n)).
+void IndexNewItem(int index) {
+    if (!ReserveItemViews(index + 1)) {
+        TraceLog(LOG_WARNING, "Unable to grow the list views. Sorting is disabled.");
+        FreeItemViews();
+        itemViews.enabled = false;
+        itemViews.sort = SORT_LISTED;
+        itemViews.openOnly = false;
+        return;
+    }
+    itemViews.key[index] = GetCurrentBid(index);
+    itemViews.endKey[index] = LoadEndTime(index);
+    itemViews.keyClosed[index] = items.auctionClosed[index];
+    TreapInsert(&itemViews.byBid, index);
+    TreapInsert(&itemViews.byEnd, index);
+    SetViewClosedBit(index, items.auctionClosed[index]);
+}
+
+// ReindexItem: Moves an item to its new place after a bid, a deadline extension or a close
+// (O(log n)). Items whose sort keys did not change are left alone.
+void ReindexItem(int index) {
+    if (index >= itemViews.capacity) return; // Not indexed (views were disabled after a failure)
+    int64_t bid = GetCurrentBid(index);
+    int64_t endTime = LoadEndTime(index);
+    bool closed = items.auctionClosed[index];
+    if (itemViews.key[index] == bid && itemViews.endKey[index] == endTime && itemViews.keyClosed[index] == closed) return;
+
+    // Both trees find the node by its old keys, so unlink it from both before changing them
+    itemViews.byBid.root = TreapErase(&itemViews.byBid, itemViews.byBid.root, index);
+    itemViews.byEnd.root = TreapErase(&itemViews.byEnd, itemViews.byEnd.root, index);
+    itemViews.key[index] = bid;
+    itemViews.endKey[index] = endTime;
+    itemViews.keyClosed[index] = closed;
+    TreapInsert(&itemViews.byBid, index);
+    TreapInsert(&itemViews.byEnd, index);
+
+    SetViewClosedBit(index, closed); // No-op unless the item was opened or closed
+}
+
+// SetViewClosedBit: Sets an item's bit to 'closed' and applies the change to the Fenwick tree.
+// A fresh item arrives with its bit set, so indexing an open item adds one open item.
+void SetViewClosedBit(int index, bool closed) {
+    uint64_t mask = (uint64_t)1 << (index % 64);
+    bool wasClosed = (itemViews.closedBits[index / 64] & mask) != 0;
+    if (closed) itemViews.closedBits[index / 64] |= mask;
+    else itemViews.closedBits[index / 64] &= ~mask;
+    int delta = (wasClosed && !closed) ? 1 : 0;
+    if (!wasClosed && closed) delta = -1;
+    if (delta == 0) return;
+    itemViews.openCount += delta;
+    for (int at = index / 64 + 1; at <= itemViews.wordCapacity; at += at & -at) itemViews.openFenwick[at] += delta;
+}
+
+// SetItemViewMode: Switches the list view and scrolls back to the top.
+void SetItemViewMode(ItemSortOrder sort, bool openOnly) {
+    if (!itemViews.enabled) return;
+    itemViews.sort = sort;
+    itemViews.openOnly = openOnly;
+    itemSearch.dirty = true; // Search results follow the view's filter and order
+    listScrollOffset = 0.0f;
+    RequestRedraw();
+}
+
+// ViewItemCount: Rows in the current view.
+int ViewItemCount() {
+    if (itemSearch.active) {
+        if (itemSearch.dirty) RefreshSearchResults();
+        return itemSearch.resultCount;
+    }
+    return itemViews.openOnly ? itemViews.openCount : items.count;
+}
+
+// ViewItemAt: Item shown in 'row' of the current view, or -1 past the end.
+int ViewItemAt(int row) {
+    if (row < 0 || row >= ViewItemCount()) return -1;
+    if (itemSearch.active) return itemSearch.results[row];
+    if (itemViews.sort == SORT_HIGHEST_BID) return TreapSelect(&itemViews.byBid, row, itemViews.openOnly);
+    if (itemViews.sort == SORT_ENDING_SOON) return TreapSelect(&itemViews.byEnd, row, itemViews.openOnly);
+    return itemViews.openOnly ? SelectOpenListed(row) : row;
+}
+
+// ItemOrderBefore: Row order of a sorted view, using the keys the items are filed under.
+// "Ending soonest" lists open auctions by deadline, then open auctions without one, then
+// closed auctions; ties are broken by catalog order.
+bool ItemOrderBefore(ItemSortOrder order, int a, int b) {
+    if (order == SORT_ENDING_SOON) {
+        if (itemViews.keyClosed[a] != itemViews.keyClosed[b]) return itemViews.keyClosed[b];
+        int64_t endA = (itemViews.endKey[a] > 0) ? itemViews.endKey[a] : INT64_MAX;
+        int64_t endB = (itemViews.endKey[b] > 0) ? itemViews.endKey[b] : INT64_MAX;
+        if (endA != endB) return endA < endB;
+    } else if (itemViews.key[a] != itemViews.key[b]) {
+        return itemViews.key[a] > itemViews.key[b];
+    }
+    return a < b;
+}
+
+// TreapPriority: Pseudo-random heap priority derived from the node's item index, so no
+// random state has to be stored (integer hash from the "lowbias32" family).
+unsigned int TreapPriority(int node) {
+    uint32_t x = (uint32_t)node;
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+// TreapUpdate: Recomputes a node's item and open-item counts from its children.
+void TreapUpdate(ItemTreap* tree, int node) {
+    int l = tree->left[node], r = tree->right[node];
+    tree->size[node] = 1 + ((l >= 0) ? tree->size[l] : 0) + ((r >= 0) ? tree->size[r] : 0);
+    tree->openSize[node] = (itemViews.keyClosed[node] ? 0 : 1) + ((l >= 0) ? tree->openSize[l] : 0) + ((r >= 0) ? tree->openSize[r] : 0);
+}
+
+// TreapInsert: Files 'node' (an unlinked item whose keys are set) at its place in the order.
+void TreapInsert(ItemTreap* tree, int node) {
+    tree->left[node] = -1;
+    tree->right[node] = -1;
+    TreapUpdate(tree, node);
+    int before, rest;
+    TreapSplit(tree, tree->root, node, &before, &rest);
+    tree->root = TreapMerge(tree, TreapMerge(tree, before, node), rest);
+}
+
+// TreapSplit: Splits the subtree at 'node' into the nodes ordered before 'pivot' and the rest.
+void TreapSplit(ItemTreap* tree, int node, int pivot, int* before, int* rest) {
+    if (node < 0) {
+        *before = -1;
+        *rest = -1;
+        return;
+    }
+    if (ItemOrderBefore(tree->order, node, pivot)) {
+        TreapSplit(tree, tree->right[node], pivot, &tree->right[node], rest);
+        *before = node;
+    } else {
+        TreapSplit(tree, tree->left[node], pivot, before, &tree->left[node]);
+        *rest = node;
+    }
+    TreapUpdate(tree, node);
+}
+
+// TreapMerge: Joins two treaps; every node of 'first' is ordered before every node of 'second'.
+int TreapMerge(ItemTreap* tree, int first, int second) {
+    if (first < 0) return second;
+    if (second < 0) return first;
+    if (TreapPriority(first) > TreapPriority(second)) {
+        tree->right[first] = TreapMerge(tree, tree->right[first], second);
+        TreapUpdate(tree, first);
+        return first;
+    }
+    tree->left[second] = TreapMerge(tree, first, tree->left[second]);
+    TreapUpdate(tree, second);
+    return second;
+}
+
+// TreapErase: Unlinks 'target' from the subtree at 'node' and returns the new subtree root.
+int TreapErase(ItemTreap* tree, int node, int target) {
+    if (node < 0) return -1; // Not found (cannot happen while keys are consistent)
+    if (node == target) return TreapMerge(tree, tree->left[node], tree->right[node]);
+    if (ItemOrderBefore(tree->order, target, node)) tree->left[node] = TreapErase(tree, tree->left[node], target);
+    else tree->right[node] = TreapErase(tree, tree->right[node], target);
+    TreapUpdate(tree, node);
+    return node;
+}
+
+// TreapSelect: Walks down from the root using the subtree counts to find the node at 'rank'.
+int TreapSelect(const ItemTreap* tree, int rank, bool openOnly) {
+    int node = tree->root;
+    while (node >= 0) {
+        int l = tree->left[node];
+        int leftCount = (l < 0) ? 0 : (openOnly ? tree->openSize[l] : tree->size[l]);
+        int selfCount = (openOnly && itemViews.keyClosed[node]) ? 0 : 1;
+        if (rank < leftCount) {
+            node = l;
+        } else if (rank < leftCount + selfCount) {
+            return node;
+        } else {
+            rank -= leftCount + selfCount;
+            node = tree->right[node];
+        }
+    }
+    return -1;
+}
+
+// SelectOpenListed: Finds the word holding the rank-th open item by descending the Fenwick
+// tree, then the item within the word by clearing lower open bits.
+int SelectOpenListed(int rank) {
+    int word = 0; // Number of whole words skipped so far
+    int step = 1;
+    while (step * 2 <= itemViews.wordCapacity) step *= 2;
+    for (; step > 0; step /= 2) {
+        if (word + step <= itemViews.wordCapacity && itemViews.openFenwick[word + step] <= rank) {
+            word += step;
+            rank -= itemViews.openFenwick[word];
+        }
+    }
+    if (word >= itemViews.wordCapacity) return -1;
+
+    uint64_t open = ~itemViews.closedBits[word];
+    for (int i = 0; i < rank && open != 0; i++) open &= open - 1; // Drop the lower open items
+    return (open != 0) ? word * 64 + __builtin_ctzll(open) : -1;
+}
+
+// --- Item Search Function Implementations ---
+
+// EnableItemSearch: Indexes every item loaded so far; AddAuctionItem keeps the index current
+// afterwards. Only the UI thread may call these functions.
+void EnableItemSearch() {
+    itemSearch.enabled = true;
+    for (int i = 0; i < items.count && itemSearch.enabled; i++) IndexItemText(i);
+}
+
+// FreeItemSearch: Releases the index and the results. The query is kept.
+void FreeItemSearch() {
+    for (int slot = 0; slot < itemSearch.slotCount; slot++) {
+        if (itemSearch.slotCodes[slot] != 0) free(itemSearch.lists[slot].items); // Empty slots are uninitialized
+    }
+    free(itemSearch.slotCodes);
+    free(itemSearch.lists);
+    free(itemSearch.results);
+    ItemSearch kept = { .enabled = itemSearch.enabled, .active = itemSearch.active, .dirty = true };
+    strcpy(kept.query, itemSearch.query);
+    itemSearch = kept;
+}
+
+// IndexItemText: Files an item's name and description. On allocation failure the search box
+// stops filtering instead of showing incomplete results.
+void IndexItemText(int index) {
+    if (!IndexTextTrigrams(index, GetItemName(index)) || !IndexTextTrigrams(index, GetItemDescription(index))) {
+        TraceLog(LOG_WARNING, "Unable to grow the search index. Search is disabled.");
+        FreeItemSearch();
+        itemSearch.enabled = false;
+        itemSearch.active = false;
+        return;
+    }
+    if (itemSearch.active) itemSearch.dirty = true; // A streamed-in item may match the query
+}
+
+// IndexTextTrigrams: Files the trigrams of each word of 'text' padded as "  word ", so the
+// leading windows also serve one- and two-character prefix queries.
+bool IndexTextTrigrams(int index, const char* text) {
+    char normalized[MAX_SEARCH_TEXT];
+    int length = NormalizeSearchText(text, normalized, sizeof(normalized));
+    for (int start = 0; start < length; ) {
+        int end = start;
+        while (end < length && normalized[end] != ' ') end++;
+
+        unsigned char padded[MAX_SEARCH_TEXT + 3];
+        int wordLength = end - start;
+        padded[0] = ' ';
+        padded[1] = ' ';
+        memcpy(padded + 2, normalized + start, wordLength);
+        padded[wordLength + 2] = ' ';
+        for (int i = 0; i <= wordLength; i++) {
+            uint32_t code = ((uint32_t)padded[i] << 16) | ((uint32_t)padded[i + 1] << 8) | padded[i + 2];
+            if (!AddTrigramPosting(code, index)) return false;
+        }
+        start = end + 1; // Skip the single separating space
+    }
+    return true;
+}
+
+// AddTrigramPosting: Appends 'index' to the trigram's list, creating the list if needed.
+// Items are indexed in ascending order, so a repeat can only be the list's last entry.
+bool AddTrigramPosting(uint32_t code, int index) {
+    if (itemSearch.slotsUsed * 2 >= itemSearch.slotCount && !GrowTrigramTable()) return false; // Keep the load factor at or below one half
+
+    unsigned int mask = (unsigned int)itemSearch.slotCount - 1;
+    unsigned int slot = HashBytes(&code, sizeof(code)) & mask;
+    while (itemSearch.slotCodes[slot] != 0 && itemSearch.slotCodes[slot] != code + 1) slot = (slot + 1) & mask; // Linear probing
+    if (itemSearch.slotCodes[slot] == 0) {
+        itemSearch.slotCodes[slot] = code + 1;
+        itemSearch.lists[slot] = (PostingList){ 0 };
+        itemSearch.slotsUsed++;
+    }
+
+    PostingList* list = &itemSearch.lists[slot];
+    if (list->count > 0 && list->items[list->count - 1] == index) return true; // Trigram seen earlier in this item
+    if (list->count == list->capacity) {
+        int newCapacity = (list->capacity > 0) ? list->capacity * 2 : 4;
+        int* grown = realloc(list->items, newCapacity * sizeof(int));
+        if (grown == NULL) return false;
+        list->items = grown;
+        list->capacity = newCapacity;
+    }
+    list->items[list->count++] = index;
+    return true;
+}
+
+// FindTrigram: Looks up a trigram's posting list.
+PostingList* FindTrigram(uint32_t code) {
+    if (itemSearch.slotCount == 0) return NULL;
+    unsigned int mask = (unsigned int)itemSearch.slotCount - 1;
+    unsigned int slot = HashBytes(&code, sizeof(code)) & mask;
+    while (itemSearch.slotCodes[slot] != 0) {
+        if (itemSearch.slotCodes[slot] == code + 1) return &itemSearch.lists[slot];
+        slot = (slot + 1) & mask;
+    }
+    return NULL;
+}
+
+// GrowTrigramTable: Doubles the slot count and moves every posting list to its new slot.
+bool GrowTrigramTable() {
+    int slotCount = (itemSearch.slotCount > 0) ? itemSearch.slotCount * 2 : INITIAL_SEARCH_SLOTS;
+    uint32_t* slotCodes = calloc(slotCount, sizeof(uint32_t));
+    PostingList* lists = malloc(slotCount * sizeof(PostingList));
+    if (slotCodes == NULL || lists == NULL) {
+        free(slotCodes);
+        free(lists);
+        return false;
+    }
+
+    unsigned int mask = (unsigned int)slotCount - 1;
+    for (int old = 0; old < itemSearch.slotCount; old++) {
+        uint32_t stored = itemSearch.slotCodes[old];
+        if (stored == 0) continue;
+        uint32_t code = stored - 1;
+        unsigned int slot = HashBytes(&code, sizeof(code)) & mask;
+        while (slotCodes[slot] != 0) slot = (slot + 1) & mask;
+        slotCodes[slot] = stored;
+        lists[slot] = itemSearch.lists[old];
+    }
+    free(itemSearch.slotCodes);
+    free(itemSearch.lists);
+    itemSearch.slotCodes = slotCodes;
+    itemSearch.lists = lists;
+    itemSearch.slotCount = slotCount;
+    return true;
+}
+
+// NormalizeSearchText: Writes 'text' lowercased, with every run of ASCII punctuation and
+// whitespace turned into one space and no leading or trailing space. Bytes of multi-byte
+// UTF-8 characters count as letters. Returns the length written (truncated to 'capacity').
+int NormalizeSearchText(const char* text, char* normalized, int capacity) {
+    int length = 0;
+    bool pendingSpace = false;
+    for (const unsigned char* c = (const unsigned char*)text; *c != '\0'; c++) {
+        unsigned char ch = *c;
+        if (ch >= 'A' && ch <= 'Z') ch = (unsigned char)(ch - 'A' + 'a');
+        bool wordChar = (ch >= 'a' && ch <= 'z') || (ch >= '0' && ch <= '9') || ch >= 0x80;
+        if (!wordChar) {
+            pendingSpace = (length > 0);
+            continue;
+        }
+        if (length + (pendingSpace ? 2 : 1) >= capacity) break; // Keep room for the terminator
+        if (pendingSpace) normalized[length++] = ' ';
+        normalized[length++] = (char)ch;
+        pendingSpace = false;
+    }
+    normalized[length] = '\0';
+    return length;
+}
+
+// SetSearchQuery: Filters the list screen by 'query' and scrolls back to the top. The
+// results are computed lazily by the next ViewItemCount.
+void SetSearchQuery(const char* query) {
+    char terms[MAX_INPUT_CHARS + 1];
+    snprintf(itemSearch.query, sizeof(itemSearch.query), "%s", query);
+    itemSearch.active = itemSearch.enabled && NormalizeSearchText(query, terms, sizeof(terms)) > 0;
+    itemSearch.dirty = true;
+    listScrollOffset = 0.0f;
+    RequestRedraw();
+}
+
+// RefreshSearchResults: Looks up the trigrams of every query word, walks the shortest posting
+// list and keeps the items found in all the others that pass the view's filter and the text
+// check. Costs O(k log n) for k entries in the rarest list, plus a sort in the bid view.
+void RefreshSearchResults() {
+    itemSearch.dirty = false;
+    itemSearch.resultCount = 0;
+
+    char terms[MAX_INPUT_CHARS + 1];
+    int length = NormalizeSearchText(itemSearch.query, terms, sizeof(terms));
+    const PostingList* lists[MAX_INPUT_CHARS];
+    int listCount = 0;
+    for (int start = 0; start < length; ) {
+        int end = start;
+        while (end < length && terms[end] != ' ') end++;
+        const unsigned char* word = (const unsigned char*)terms + start;
+        int wordLength = end - start;
+
+        if (wordLength >= 3) { // Every window of the word occurs inside a matching word
+            for (int i = 0; i + 3 <= wordLength; i++) {
+                const PostingList* list = FindTrigram(((uint32_t)word[i] << 16) | ((uint32_t)word[i + 1] << 8) | word[i + 2]);
+                if (list == NULL) return; // No item contains this part of the query
+                lists[listCount++] = list;
+            }
+        } else { // "  a" or " ab": the start of a matching word
+            uint32_t code = (wordLength == 1) ? (((uint32_t)' ' << 16) | ((uint32_t)' ' << 8) | word[0]) : (((uint32_t)' ' << 16) | ((uint32_t)word[0] << 8) | word[1]);
+            const PostingList* list = FindTrigram(code);
+            if (list == NULL) return;
+            lists[listCount++] = list;
+        }
+        start = end + 1;
+    }
+    if (listCount == 0) return;
+
+    int rarest = 0;
+    for (int i = 1; i < listCount; i++) {
+        if (lists[i]->count < lists[rarest]->count) rarest = i;
+    }
+    const PostingList* candidates = lists[rarest];
+    if (candidates->count > itemSearch.resultCapacity) {
+        int* results = realloc(itemSearch.results, candidates->count * sizeof(int));
+        if (results == NULL) {
+            TraceLog(LOG_WARNING, "Unable to allocate %d search results.", candidates->count);
+            return;
+        }
+        itemSearch.results = results;
+        itemSearch.resultCapacity = candidates->count;
+    }
+
+    for (int c = 0; c < candidates->count; c++) {
+        int index = candidates->items[c];
+        if (itemViews.openOnly && items.auctionClosed[index]) continue;
+        bool inAll = true;
+        for (int i = 0; i < listCount && inAll; i++) {
+            if (i != rarest) inAll = PostingContains(lists[i], index);
+        }
+        if (inAll && ItemMatchesQuery(index, terms)) itemSearch.results[itemSearch.resultCount++] = index;
+    }
+    // Posting lists are in catalog order already; only the sorted views need sorting
+    if (itemViews.sort != SORT_LISTED) qsort(itemSearch.results, itemSearch.resultCount, sizeof(int), CompareSearchResults);
+}
+
+// ItemMatchesQuery: The trigrams only show that the pieces of each word occur somewhere in the
+// item, so the words are checked against the item's text: a word of three or more characters
+// must occur inside one of its words, a shorter word must start one of them.
+bool ItemMatchesQuery(int index, const char* terms) {
+    char text[2 * MAX_SEARCH_TEXT + 2];
+    text[0] = ' ';
+    int length = 1 + NormalizeSearchText(GetItemName(index), text + 1, MAX_SEARCH_TEXT);
+    text[length++] = ' ';
+    length += NormalizeSearchText(GetItemDescription(index), text + length, MAX_SEARCH_TEXT);
+    text[length++] = ' ';
+    text[length] = '\0';
+
+    for (const char* word = terms; *word != '\0'; ) {
+        int wordLength = 0;
+        while (word[wordLength] != '\0' && word[wordLength] != ' ') wordLength++;
+        char needle[MAX_INPUT_CHARS + 2];
+        int offset = (wordLength >= 3) ? 0 : 1; // Short words are matched with the preceding space
+        needle[0] = ' ';
+        memcpy(needle + offset, word, wordLength);
+        needle[offset + wordLength] = '\0';
+        if (strstr(text, needle) == NULL) return false;
+        word += wordLength;
+        if (*word == ' ') word++;
+    }
+    return true;
+}
+
+// PostingContains: Binary search for 'index' in an ascending posting list.
+bool PostingContains(const PostingList* list, int index) {
+    int low = 0, high = list->count;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        if (list->items[middle] < index) low = middle + 1;
+        else high = middle;
+    }
+    return low < list->count && list->items[low] == index;
+}
+
+// CompareSearchResults: Orders matches like the rows of the current sorted view.
+int CompareSearchResults(const void* a, const void* b) {
+    int first = *(const int*)a, second = *(const int*)b;
+    if (first == second) return 0;
+    return ItemOrderBefore(itemViews.sort, first, second) ? -1 : 1;
+}
+
+// --- Thumbnail Function Implementations ---
+
+#if !defined(AUCTION_HEADLESS) // Textures and image decoding need raylib
+
+// InitThumbnails: Starts the decode thread. Must run on the UI thread after InitWindow; the
+// atlas texture itself is only created once the first image has been decoded.
+void InitThumbnails() {
+    for (int slot = 0; slot < THUMBNAIL_SLOT_COUNT; slot++) thumbnails.slots[slot] = (ThumbnailSlot){ .itemIndex = -1 };
+    thumbnails.running = true;
+    thumbnails.started = (pthread_create(&thumbnails.thread, NULL, ThumbnailDecodeThread, NULL) == 0);
+    if (!thumbnails.started) TraceLog(LOG_WARNING, "Unable to start the image decoder. Thumbnails are disabled.");
+}
+
+// ShutdownThumbnails: Stops the decode thread, drops queued and unuploaded images and
+// releases the atlas. Must run before CloseWindow.
+void ShutdownThumbnails() {
+    if (thumbnails.started) {
+        pthread_mutex_lock(&thumbnails.lock);
+        thumbnails.running = false;
+        thumbnails.requestCount = 0; // Nobody will look at them any more
+        pthread_cond_signal(&thumbnails.wake);
+        pthread_mutex_unlock(&thumbnails.lock);
+        pthread_join(thumbnails.thread, NULL);
+        thumbnails.started = false;
+    }
+    for (int i = 0; i < thumbnails.resultCount; i++) UnloadImage(thumbnails.results[i].image);
+    thumbnails.resultCount = 0;
+    if (thumbnails.atlasReady) UnloadTexture(thumbnails.atlas);
+    thumbnails.atlasReady = false;
+}
+
+// DrawThumbnail: Draws an item's image scaled to fit 'bounds' (keeping its aspect ratio),
+// requesting it first if it is not cached. Draws nothing while it loads or if it has none.
+// Every thumbnail comes from the one atlas texture, so consecutive calls share a draw call.
+void DrawThumbnail(int index, Rectangle bounds) {
+    const ThumbnailSlot* slot = RequestThumbnail(index);
+    if (slot == NULL) return;
+    int slotIndex = (int)(slot - thumbnails.slots);
+    int perRow = THUMBNAIL_ATLAS_SIZE / THUMBNAIL_SIZE;
+    Rectangle source = { (float)(slotIndex % perRow * THUMBNAIL_SIZE), (float)(slotIndex / perRow * THUMBNAIL_SIZE), (float)slot->width, (float)slot->height };
+    float scale = bounds.width / slot->width;
+    if (bounds.height / slot->height < scale) scale = bounds.height / slot->height;
+    Rectangle dest = { bounds.x + (bounds.width - slot->width * scale) / 2, bounds.y + (bounds.height - slot->height * scale) / 2, slot->width * scale, slot->height * scale };
+    DrawTexturePro(thumbnails.atlas, source, dest, (Vector2){ 0, 0 }, 0.0f, WHITE);
+}
+
+// RequestThumbnail: Marks an item's cached thumbnail as used this frame and returns its slot
+// once it is in the atlas. An item that is not cached gets a slot (evicting the least
+// recently used one if needed) and a decode request; NULL is returned until it is uploaded.
+const ThumbnailSlot* RequestThumbnail(int index) {
+    if (!thumbnails.started || items.imageOffset[index] < 0) return NULL;
+    int slotIndex = items.renderCache[index].thumbSlot;
+    if (slotIndex < 0) {
+        slotIndex = AcquireThumbnailSlot();
+        if (slotIndex < 0) return NULL; // Every slot is on screen or decoding; try again next frame
+
+        DecodeJob job = { .slot = slotIndex, .itemIndex = index };
+        snprintf(job.path, sizeof(job.path), "%s", GetItemImage(index));
+        pthread_mutex_lock(&thumbnails.lock);
+        thumbnails.requests[thumbnails.requestCount++] = job; // Cannot overflow: one job per slot
+        pthread_cond_signal(&thumbnails.wake);
+        pthread_mutex_unlock(&thumbnails.lock);
+
+        thumbnails.slots[slotIndex] = (ThumbnailSlot){ .itemIndex = index, .state = THUMB_LOADING };
+        items.renderCache[index].thumbSlot = slotIndex;
+        thumbnails.outstanding++;
+    }
+    ThumbnailSlot* slot = &thumbnails.slots[slotIndex];
+    slot->lastUsed = thumbnails.frame;
+    return (slot->state == THUMB_READY) ? slot : NULL;
+}
+
+// AcquireThumbnailSlot: Finds a free slot, or evicts the least recently used one that is not
+// drawn this frame. A slot whose decode has not started yet can be evicted too (its request is
+// withdrawn), so scrolling past rows does not keep the decoder busy with them. Returns -1 if
+// every slot is in use.
+int AcquireThumbnailSlot() {
+    int victim = -1;
+    for (int slot = 0; slot < THUMBNAIL_SLOT_COUNT; slot++) {
+        const ThumbnailSlot* candidate = &thumbnails.slots[slot];
+        if (candidate->itemIndex < 0 && candidate->state == THUMB_EMPTY) return slot;
+        if (candidate->state == THUMB_LOADING || candidate->lastUsed == thumbnails.frame) continue;
+        if (victim < 0 || candidate->lastUsed < thumbnails.slots[victim].lastUsed) victim = slot;
+    }
+    if (victim < 0) {
+        // Withdraw the least recently used request the decoder has not picked up yet
+        pthread_mutex_lock(&thumbnails.lock);
+        int withdrawn = -1;
+        for (int i = 0; i < thumbnails.requestCount; i++) {
+            const ThumbnailSlot* candidate = &thumbnails.slots[thumbnails.requests[i].slot];
+            if (candidate->lastUsed == thumbnails.frame) continue;
+            if (withdrawn < 0 || candidate->lastUsed < thumbnails.slots[thumbnails.requests[withdrawn].slot].lastUsed) withdrawn = i;
+        }
+        if (withdrawn >= 0) {
+            victim = thumbnails.requests[withdrawn].slot;
+            memmove(&thumbnails.requests[withdrawn], &thumbnails.requests[withdrawn + 1], (thumbnails.requestCount - withdrawn - 1) * sizeof(DecodeJob));
+            thumbnails.requestCount--;
+            thumbnails.outstanding--;
+        }
+        pthread_mutex_unlock(&thumbnails.lock);
+        if (victim < 0) return -1;
+    }
+
+    int owner = thumbnails.slots[victim].itemIndex;
+    if (owner >= 0) items.renderCache[owner].thumbSlot = -1; // It is requested again when next drawn
+    thumbnails.slots[victim] = (ThumbnailSlot){ .itemIndex = -1 };
+    return victim;
+}
+
+// PumpThumbnails: Called once per frame on the UI thread. Copies up to
+// THUMBNAIL_UPLOADS_PER_FRAME decoded images into their atlas slots, so a burst of finished
+// decodes never stalls a frame.
+void PumpThumbnails() {
+    DecodeJob done[THUMBNAIL_UPLOADS_PER_FRAME];
+    pthread_mutex_lock(&thumbnails.lock);
+    int count = (thumbnails.resultCount < THUMBNAIL_UPLOADS_PER_FRAME) ? thumbnails.resultCount : THUMBNAIL_UPLOADS_PER_FRAME;
+    memcpy(done, thumbnails.results, count * sizeof(DecodeJob));
+    memmove(thumbnails.results, thumbnails.results + count, (thumbnails.resultCount - count) * sizeof(DecodeJob));
+    thumbnails.resultCount -= count;
+    pthread_mutex_unlock(&thumbnails.lock);
+
+    for (int i = 0; i < count; i++) {
+        DecodeJob* job = &done[i];
+        ThumbnailSlot* slot = &thumbnails.slots[job->slot];
+        thumbnails.outstanding--;
+        if (slot->itemIndex != job->itemIndex) { // Item store was freed meanwhile
+            UnloadImage(job->image);
+            *slot = (ThumbnailSlot){ .itemIndex = -1 };
+            continue;
+        }
+        if (job->image.data != NULL && !thumbnails.atlasReady) {
+            Image blank = GenImageColor(THUMBNAIL_ATLAS_SIZE, THUMBNAIL_ATLAS_SIZE, BLANK);
+            thumbnails.atlas = LoadTextureFromImage(blank);
+            UnloadImage(blank);
+            SetTextureFilter(thumbnails.atlas, TEXTURE_FILTER_BILINEAR);
+            thumbnails.atlasReady = (thumbnails.atlas.id != 0);
+        }
+        if (job->image.data == NULL || !thumbnails.atlasReady) {
+            slot->state = THUMB_FAILED; // Cached like an image, so a missing file is not retried every frame
+        } else {
+            int perRow = THUMBNAIL_ATLAS_SIZE / THUMBNAIL_SIZE;
+            Rectangle target = { (float)(job->slot % perRow * THUMBNAIL_SIZE), (float)(job->slot / perRow * THUMBNAIL_SIZE), (float)job->image.width, (float)job->image.height };
+            UpdateTextureRec(thumbnails.atlas, target, job->image.data);
+            slot->width = job->image.width;
+            slot->height = job->image.height;
+            slot->state = THUMB_READY;
+            RequestRedraw();
+        }
+        UnloadImage(job->image);
+    }
+}
+
+// ThumbnailDecodeThread: Takes the newest request first (it is the most likely to still be on
+// screen), decodes the file and shrinks it to fit a THUMBNAIL_SIZE slot. Only CPU-side image
+// functions are used here; the GPU upload happens in PumpThumbnails.
+void* ThumbnailDecodeThread(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&thumbnails.lock);
+    while (thumbnails.running) {
+        if (thumbnails.requestCount == 0) {
+            pthread_cond_wait(&thumbnails.wake, &thumbnails.lock);
+            continue;
+        }
+        DecodeJob job = thumbnails.requests[--thumbnails.requestCount];
+        pthread_mutex_unlock(&thumbnails.lock);
+
+        job.image = (Image){ 0 };
+        if (FileExists(job.path)) job.image = LoadImage(job.path);
+        if (job.image.data != NULL) {
+            ImageFormat(&job.image, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8); // Layout of the atlas
+            float scale = (float)THUMBNAIL_SIZE / ((job.image.width > job.image.height) ? job.image.width : job.image.height);
+            if (scale < 1.0f) {
+                int width = (int)(job.image.width * scale), height = (int)(job.image.height * scale);
+                ImageResize(&job.image, (width > 0) ? width : 1, (height > 0) ? height : 1);
+            }
+        }
+
+        pthread_mutex_lock(&thumbnails.lock);
+        thumbnails.results[thumbnails.resultCount++] = job; // Cannot overflow: one job per slot
+    }
+    pthread_mutex_unlock(&thumbnails.lock);
+    return NULL;
+}
+
+#endif // !AUCTION_HEADLESS
+
+// ForgetThumbnails: Detaches every slot from its item after the item store was freed.
+// Images still being decoded are discarded when they arrive.
+void ForgetThumbnails() {
+    for (int slot = 0; slot < THUMBNAIL_SLOT_COUNT; slot++) {
+        if (thumbnails.slots[slot].state != THUMB_LOADING) thumbnails.slots[slot] = (ThumbnailSlot){ .itemIndex = -1 };
+        else thumbnails.slots[slot].itemIndex = -1; // Freed by PumpThumbnails when the decode comes back
+    }
+}
+
+// SetItemImage: Sets the image file shown for an item ("" for none).
+void SetItemImage(int index, const char* path) {
+    if (path[0] == '\0') {
+        items.imageOffset[index] = -1;
+        return;
+    }
+    items.imageOffset[index] = StringPoolAdd(&items.imagePaths, path); // -1 (no image) if out of memory
+}
+
+// GetItemImage: Path of an item's image, "" if it has none.
+const char* GetItemImage(int index) {
+    return (items.imageOffset[index] >= 0) ? items.imagePaths.data + items.imageOffset[index] : "";
+}
+
+// --- User Management Function Implementations ---
+
+// HashPassword: Derives a salted scrypt hash of 'password' at the current KDF_* cost.
+// Deliberately expensive (about 16 MiB and tens of milliseconds), so it only runs on the
+// I/O worker. Returns false if no salt or memory could be obtained.
+bool HashPassword(const char* password, PasswordHash* hash) {
+    *hash = (PasswordHash){ .scheme = PASSWORD_SCRYPT, .logN = KDF_LOG_N, .r = KDF_R, .p = KDF_P };
+    if (!FillRandom(hash->salt, PASSWORD_SALT_LENGTH)) {
+        TraceLog(LOG_WARNING, "Unable to get random bytes for a password salt.");
+        return false;
+    }
+    return Scrypt(password, hash->salt, PASSWORD_SALT_LENGTH, hash->logN, hash->r, hash->p, hash->key, PASSWORD_KEY_LENGTH);
+}
+
+// VerifyPassword: Recomputes the hash with the record's own salt and cost and compares it in
+// constant time. Also accepts djb2 records written by older versions.
+bool VerifyPassword(const char* password, const PasswordHash* hash) {
+    if (!PasswordHashUsable(hash)) return false; // Unknown scheme or costs no file may ask for
+    if (hash->scheme == PASSWORD_LEGACY_DJB2) return LegacyPasswordHash(password) == hash->legacy;
+
+    uint8_t key[PASSWORD_KEY_LENGTH];
+    if (!Scrypt(password, hash->salt, PASSWORD_SALT_LENGTH, hash->logN, hash->r, hash->p, key, PASSWORD_KEY_LENGTH)) return false;
+    uint8_t difference = 0;
+    for (int i = 0; i < PASSWORD_KEY_LENGTH; i++) difference |= (uint8_t)(key[i] ^ hash->key[i]);
+    SecureZero(key, sizeof(key));
+    return difference == 0;
+}
+
+// PasswordNeedsRehash: True if the record should be replaced at the next successful login.
+bool PasswordNeedsRehash(const PasswordHash* hash) {
+    return hash->scheme != PASSWORD_SCRYPT || hash->logN < KDF_LOG_N || hash->r < KDF_R || hash->p < KDF_P;
+}
+
+// LegacyPasswordHash: The djb2 hash older versions stored. Collides trivially; kept only so
+// existing users can still sign in once and be migrated.
+uint32_t LegacyPasswordHash(const char* password) {
+    uint32_t hash = 5381; // djb2 hash algorithm initial value
+    int c;
+    while ((c = *password++)) {
+        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    }
+    return hash;
+}
+
+// FormatPasswordHash: "scrypt:<logN>:<r>:<p>:<salt hex>:<key hex>", or the plain decimal
+// djb2 value for legacy records (the format older versions wrote).
+void FormatPasswordHash(const PasswordHash* hash, char* text, int capacity) {
+    if (hash->scheme == PASSWORD_LEGACY_DJB2) {
+        snprintf(text, capacity, "%u", (unsigned int)hash->legacy);
+        return;
+    }
+    int length = snprintf(text, capacity, "scrypt:%d:%d:%d:", hash->logN, hash->r, hash->p);
+    for (int i = 0; i < PASSWORD_SALT_LENGTH && length < capacity; i++) length += snprintf(text + length, capacity - length, "%02x", hash->salt[i]);
+    if (length < capacity) length += snprintf(text + length, capacity - length, ":");
+    for (int i = 0; i < PASSWORD_KEY_LENGTH && length < capacity; i++) length += snprintf(text + length, capacity - length, "%02x", hash->key[i]);
+}
+
+// PasswordCostAllowed: True if scrypt costs read from a users file are inside the KDF_MAX_*
+// limits, so a doctored file cannot make a login take forever or exhaust memory (each
+// per-parameter limit alone still allows 128 * r * N = 64 GiB).
+bool PasswordCostAllowed(int logN, int r, int p) {
+    if (logN < 1 || logN > KDF_MAX_LOG_N || r < 1 || r > KDF_MAX_R || p < 1 || p > KDF_MAX_P) return false;
+    uint64_t blockWork = ((uint64_t)1 << logN) * (uint64_t)r; // N * r
+    return 128 * blockWork <= KDF_MAX_MEMORY && (uint64_t)p * blockWork <= KDF_MAX_WORK;
+}
+
+// PasswordHashUsable: True if 'hash' can be verified: a djb2 value, or scrypt with allowed
+// costs. Binary records are used in place, so they are checked with this rather than parsed.
+bool PasswordHashUsable(const PasswordHash* hash) {
+    if (hash->scheme == PASSWORD_LEGACY_DJB2) return true;
+    return hash->scheme == PASSWORD_SCRYPT && PasswordCostAllowed(hash->logN, hash->r, hash->p);
+}
+
+// ParsePasswordHash: Reads the text written by FormatPasswordHash. Costs outside the
+// KDF_MAX_* limits are rejected (see PasswordCostAllowed).
+bool ParsePasswordHash(const char* text, PasswordHash* hash) {
+    *hash = (PasswordHash){ 0 };
+    if (text[0] >= '0' && text[0] <= '9') { // Legacy djb2 value
+        char* end = NULL;
+        unsigned long value = strtoul(text, &end, 10);
+        hash->scheme = PASSWORD_LEGACY_DJB2;
+        hash->legacy = (uint32_t)value;
+        return *end == '\0' && value <= UINT32_MAX;
+    }
+
+    int logN, r, p, consumed = 0;
+    if (sscanf(text, "scrypt:%d:%d:%d:%n", &logN, &r, &p, &consumed) != 3 || consumed == 0) return false;
+    if (!PasswordCostAllowed(logN, r, p)) return false;
+    hash->scheme = PASSWORD_SCRYPT;
+    hash->logN = (uint8_t)logN;
+    hash->r = (uint8_t)r;
+    hash->p = (uint8_t)p;
+
+    const char* cursor = text + consumed;
+    for (int field = 0; field < 2; field++) {
+        uint8_t* bytes = (field == 0) ? hash->salt : hash->key;
+        int count = (field == 0) ? PASSWORD_SALT_LENGTH : PASSWORD_KEY_LENGTH;
+        for (int i = 0; i < count; i++) {
+            unsigned int byte;
+            if (sscanf(cursor, "%2x", &byte) != 1 || cursor[0] == '\0' || cursor[1] == '\0') return false;
+            bytes[i] = (uint8_t)byte;
+            cursor += 2;
+        }
+        if (field == 0 && *cursor++ != ':') return false;
+    }
+    return *cursor == '\0';
+}
+
+// LoadUsers: Rebuilds the user directory from the USERS_FILE snapshot followed by every
+// registration recorded in USERS_LOG_FILE since that snapshot was written.
+bool LoadUsers() {
+    double profileStart = ProfileBegin();
+    FreeUsers(); // Start from an empty directory (this also drops any previous mapping)
+
+    FILE* file = NULL;
+    bool rewriteSnapshot = false; // Set when the binary file is in an older layout
+    if (MapUserDatabase(&rewriteSnapshot)) {
+        binaryUserDatabase = true; // Keep compacting into the binary format
+    } else {
+        RebuildUserIndex(INITIAL_USER_INDEX_SLOTS); // Start from an empty index
+        file = fopen(USERS_FILE, "r");
+        if (file == NULL) {
+            TraceLog(LOG_INFO, "USERS_FILE not found or unable to open for reading. Starting from the log only.");
+        } else {
+            User record;
+            char token[MAX_PASSWORD_TOKEN_LENGTH];
+            while (fscanf(file, "%31s %127s", record.username, token) == 2) {
+                if (!ParsePasswordHash(token, &record.password)) continue; // Garbled hash: skip the record
+                if (!AddUser(record.username, &record.password)) break; // Out of memory, keep what we have
+            }
+            fclose(file);
+        }
+    }
+    int snapshotCount = userCount;
+
+    bool tornTail = false;
+    userLogRecords = ReplayUserLog(&tornTail);
+    TraceLog(LOG_INFO, "Loaded %d users from %s and %d from %s.", snapshotCount, binaryUserDatabase ? USERS_DB_FILE : USERS_FILE, userLogRecords, USERS_LOG_FILE);
+
+    // A torn last record (crash mid-append) would corrupt the next append, and a long log
+    // slows down every startup, so fold the log into the snapshot right away in both cases.
+    // A converted binary file is rewritten in the current layout for the same reason.
+    if (tornTail || rewriteSnapshot || userLogRecords >= USER_LOG_COMPACT_THRESHOLD) CompactUsers();
+    ProfileEnd("LoadUsers", profileStart);
+    return snapshotCount > 0 || userLogRecords > 0;
+}
+
+// ReplayUserLog: Applies each complete record of USERS_LOG_FILE to the user directory
+// (registrations, and rehashed passwords of existing users).
+// A record only counts once its trailing newline is on disk; a partial final line is
+// reported through 'tornTail' and ignored.
+int ReplayUserLog(bool* tornTail) {
+    FILE* file = fopen(USERS_LOG_FILE, "r");
+    if (file == NULL) return 0; // No registrations since the last snapshot
+
+    int applied = 0;
+    char line[MAX_NAME_LENGTH + MAX_PASSWORD_TOKEN_LENGTH + 8];
+    while (fgets(line, sizeof(line), file) != NULL) {
+        User record;
+        char token[MAX_PASSWORD_TOKEN_LENGTH];
+        if (strchr(line, '\n') == NULL || sscanf(line, "%31s %127s", record.username, token) != 2 ||
+            !ParsePasswordHash(token, &record.password)) {
+            *tornTail = true; // Incomplete or garbled record: nothing after it can be trusted
+            break;
+        }
+        // A later record for the same name is a rehashed password and replaces the earlier one
+        if (!UpsertUser(record.username, &record.password)) break; // Out of memory, keep what we have
+        applied++;
+    }
+
+    fclose(file);
+    return applied;
+}
+
+// SaveUsers: Writes the current directory to a new snapshot on the calling thread.
+bool SaveUsers() {
+    double profileStart = ProfileBegin();
+    UserSnapshot snapshot = LiveUserSnapshot();
+    bool saved = WriteUsersSnapshot(&snapshot);
+    ProfileEnd("SaveUsers", profileStart);
+    return saved;
+}
+
+// LiveUserSnapshot: Points a snapshot at the live directory. Only valid on the UI thread.
+UserSnapshot LiveUserSnapshot() {
+    return (UserSnapshot){ users, userCount, userIndex, binaryUserDatabase };
+}
+
+// CopyUserSnapshot: Copies the directory so the worker can write it while the UI keeps
+// registering users. The copy is released by the worker.
+bool CopyUserSnapshot(UserSnapshot* copy) {
+    *copy = LiveUserSnapshot();
+    copy->users = malloc((userCount > 0 ? userCount : 1) * sizeof(User));
+    copy->index.slots = copy->binary ? malloc(userIndex.slotCount * sizeof(int)) : NULL; // Text snapshots have no index
+    if (copy->users == NULL || (copy->binary && copy->index.slots == NULL)) {
+        free(copy->users);
+        free(copy->index.slots);
+        return false;
+    }
+    memcpy(copy->users, users, userCount * sizeof(User));
+    if (copy->binary) memcpy(copy->index.slots, userIndex.slots, userIndex.slotCount * sizeof(int));
+    return true;
+}
+
+// WriteUsersSnapshot: Writes every current user to a new snapshot (USERS_DB_FILE in binary mode,
+// USERS_FILE otherwise). The data goes to a temp file first and is renamed over the old
+// snapshot once it is safely on disk, so a crash at any point leaves either the old or the
+// new snapshot intact.
+bool WriteUsersSnapshot(const UserSnapshot* snapshot) {
+    const char* tempFileName = snapshot->binary ? USERS_DB_TEMP_FILE : USERS_TEMP_FILE;
+    const char* fileName = snapshot->binary ? USERS_DB_FILE : USERS_FILE;
+    FILE* file = fopen(tempFileName, snapshot->binary ? "wb" : "w");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "Unable to open %s for writing. User data not saved.", tempFileName);
+        return false;
+    }
+
+    bool written = true;
+    if (snapshot->binary) {
+        written = WriteUserDatabase(file, snapshot);
+    } else {
+        char token[MAX_PASSWORD_TOKEN_LENGTH];
+        for (int i = 0; i < snapshot->userCount; i++) {
+            FormatPasswordHash(&snapshot->users[i].password, token, sizeof(token));
+            fprintf(file, "%s %s\n", snapshot->users[i].username, token);
+        }
+    }
+
+    written = written && (fflush(file) == 0) && (fsync(fileno(file)) == 0);
+    fclose(file);
+    if (!written) {
+        TraceLog(LOG_WARNING, "Unable to write %s. User data not saved.", tempFileName);
+        return false;
+    }
+#if defined(_WIN32)
+    remove(fileName); // rename() does not replace existing files on Windows
+#endif
+    if (rename(tempFileName, fileName) != 0) {
+        TraceLog(LOG_WARNING, "Unable to replace %s. User data not saved.", fileName);
+        return false;
+    }
+
+    TraceLog(LOG_INFO, "Saved %d users to %s.", snapshot->userCount, fileName);
+    return true;
+}
+
+// WriteUserDatabase: Writes the header, every user record and the username index slots.
+// The index is saved as-is, so loading it back needs no hashing at all.
+bool WriteUserDatabase(FILE* file, const UserSnapshot* snapshot) {
+    UserDatabaseHeader header = { 0 };
+    memcpy(header.magic, USER_DB_MAGIC, 4);
+    header.version = USER_DB_VERSION;
+    header.recordSize = sizeof(User);
+    header.recordCount = (uint32_t)snapshot->userCount;
+    header.slotCount = (uint32_t)snapshot->index.slotCount;
+    header.slotsUsed = (uint32_t)snapshot->index.used;
+
+    return fwrite(&header, sizeof(header), 1, file) == 1 &&
+           fwrite(snapshot->users, sizeof(User), snapshot->userCount, file) == (size_t)snapshot->userCount &&
+           fwrite(snapshot->index.slots, sizeof(int), snapshot->index.slotCount, file) == (size_t)snapshot->index.slotCount;
+}
+
+// MapUserDatabase: Maps USERS_DB_FILE and points 'users' and 'userIndex' straight at it.
+// Startup cost is a header check plus one pass over the records and slots, with no parsing or
+// hashing. Returns false if the file is missing, does not look like a database written by this
+// version, or holds a record or slot that could not have been written by it (a hash with costs
+// beyond the KDF_MAX_* limits, an index entry outside the records).
+bool MapUserDatabase(bool* needsRewrite) {
+    size_t size = 0;
+    unsigned char* data = MapFileReadOnly(USERS_DB_FILE, &size);
+    if (data == NULL) return false; // No binary database
+
+    UserDatabaseHeader header;
+    if (size < sizeof(header)) {
+        UnmapFile(data, size);
+        TraceLog(LOG_WARNING, "%s is truncated. Ignoring it.", USERS_DB_FILE);
+        return false;
+    }
+    memcpy(&header, data, sizeof(header));
+
+    // Version 1 held djb2 hashes in a smaller record. Load them as legacy credentials (each is
+    // upgraded at the user's next login) and have the caller rewrite the file in the current layout.
+    if (memcmp(header.magic, USER_DB_MAGIC, 4) == 0 && header.version == 1 && header.recordSize == sizeof(LegacyUserRecord) &&
+        size >= sizeof(header) + (size_t)header.recordCount * sizeof(LegacyUserRecord)) {
+        bool loaded = RebuildUserIndex(INITIAL_USER_INDEX_SLOTS);
+        for (uint32_t i = 0; loaded && i < header.recordCount; i++) {
+            LegacyUserRecord record;
+            memcpy(&record, data + sizeof(header) + (size_t)i * sizeof(record), sizeof(record));
+            record.username[MAX_NAME_LENGTH - 1] = '\0';
+            PasswordHash hash = { 0 };
+            hash.scheme = PASSWORD_LEGACY_DJB2;
+            hash.legacy = record.hashedPassword;
+            loaded = AddUser(record.username, &hash);
+        }
+        UnmapFile(data, size);
+        if (loaded) {
+            TraceLog(LOG_INFO, "Upgrading %s from version 1.", USERS_DB_FILE);
+            *needsRewrite = true;
+        }
+        return loaded;
+    }
+
+    // The slot count must be a power of two, large enough for every record, and the file
+    // must be exactly as long as the header says
+    bool valid = memcmp(header.magic, USER_DB_MAGIC, 4) == 0 && header.version == USER_DB_VERSION &&
+                 header.recordSize == sizeof(User) && header.slotCount >= INITIAL_USER_INDEX_SLOTS &&
+                 (header.slotCount & (header.slotCount - 1)) == 0 && header.slotsUsed <= header.recordCount &&
+                 header.recordCount < header.slotCount &&
+                 size == sizeof(header) + (size_t)header.recordCount * sizeof(User) + (size_t)header.slotCount * sizeof(int);
+    if (!valid) {
+        UnmapFile(data, size);
+        TraceLog(LOG_WARNING, "%s has an unexpected layout. Ignoring it.", USERS_DB_FILE);
+        return false;
+    }
+
+    // The records are used in place, so check them the way ParsePasswordHash checks text
+    const User* records = (const User*)(data + sizeof(header));
+    const int* slots = (const int*)(data + sizeof(header) + (size_t)header.recordCount * sizeof(User));
+    for (uint32_t i = 0; valid && i < header.recordCount; i++) valid = PasswordHashUsable(&records[i].password);
+    for (uint32_t i = 0; valid && i < header.slotCount; i++) valid = slots[i] >= 0 && (uint32_t)slots[i] <= header.recordCount;
+    if (!valid) {
+        UnmapFile(data, size);
+        TraceLog(LOG_WARNING, "%s is damaged. Ignoring it.", USERS_DB_FILE);
+        return false;
+    }
+
+    userDatabaseMapping = data;
+    userDatabaseMappingSize = size;
+    users = (User*)(data + sizeof(header));
+    userCount = (int)header.recordCount;
+    userCapacity = userCount; // Any append has to detach from the mapping first
+    userIndex.slots = (int*)(data + sizeof(header) + (size_t)header.recordCount * sizeof(User));
+    userIndex.slotCount = (int)header.slotCount;
+    userIndex.used = (int)header.slotsUsed;
+    return true;
+}
+
+// DetachUserDatabase: Moves the users and the index out of the read-only mapping into heap
+// memory. Done once, on the first change after a binary load.
+bool DetachUserDatabase() {
+    if (userDatabaseMapping == NULL) return true; // Already on the heap
+
+    int capacity = (userCount > INITIAL_USER_CAPACITY) ? userCount * 2 : INITIAL_USER_CAPACITY;
+    User* heapUsers = malloc(capacity * sizeof(User));
+    int* heapSlots = malloc(userIndex.slotCount * sizeof(int));
+    if (heapUsers == NULL || heapSlots == NULL) {
+        free(heapUsers);
+        free(heapSlots);
+        return false;
+    }
+    memcpy(heapUsers, users, userCount * sizeof(User));
+    memcpy(heapSlots, userIndex.slots, userIndex.slotCount * sizeof(int));
+
+    UnmapFile(userDatabaseMapping, userDatabaseMappingSize);
+    userDatabaseMapping = NULL;
+    userDatabaseMappingSize = 0;
+    users = heapUsers;
+    userCapacity = capacity;
+    userIndex.slots = heapSlots;
+    return true;
+}
+
+// ConvertUsersToBinary: Loads the text snapshot and the log, then writes them out as
+// USERS_DB_FILE. From then on LoadUsers and compaction use the binary format.
+bool ConvertUsersToBinary() {
+    if (FileExists(USERS_DB_FILE)) {
+        TraceLog(LOG_WARNING, "%s already exists. Nothing to convert.", USERS_DB_FILE);
+        return false;
+    }
+
+    LoadUsers();
+    binaryUserDatabase = true;
+    bool converted = CompactUsers(); // Writes USERS_DB_FILE and empties the log
+    if (converted) TraceLog(LOG_INFO, "Converted %d users from %s to %s.", userCount, USERS_FILE, USERS_DB_FILE);
+    CloseUserLog();
+    FreeUsers();
+    return converted;
+}
+
+// MapFileReadOnly: Makes the whole file readable in memory and stores its length in 'size'.
+// POSIX systems map it lazily; elsewhere the file is read into a heap buffer.
+void* MapFileReadOnly(const char* fileName, size_t* size) {
+#if defined(_WIN32)
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) return NULL;
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    void* data = (length > 0) ? malloc((size_t)length) : NULL;
+    if (data != NULL && fread(data, 1, (size_t)length, file) != (size_t)length) {
+        free(data);
+        data = NULL;
+    }
+    fclose(file);
+    *size = (data != NULL) ? (size_t)length : 0;
+    return data;
+#else
+    int fd = open(fileName, O_RDONLY);
+    if (fd < 0) return NULL;
+    struct stat info;
+    void* data = NULL;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        data = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) data = NULL;
+    }
+    close(fd); // The mapping stays valid after the descriptor is closed
+    *size = (data != NULL) ? (size_t)info.st_size : 0;
+    return data;
+#endif
+}
+
+// UnmapFile: Releases memory returned by MapFileReadOnly.
+void UnmapFile(void* data, size_t size) {
+#if defined(_WIN32)
+    (void)size;
+    free(data);
+#else
+    munmap(data, size);
+#endif
+}
+
+// AppendUserLog: Appends one user record (a registration or a rehash) to USERS_LOG_FILE and
+// forces it to disk.
+// The cost is one short write regardless of how many users exist.
+bool AppendUserLog(const char* username, const PasswordHash* hash) {
+    if (userLogFile == NULL) {
+        userLogFile = fopen(USERS_LOG_FILE, "a"); // "a" always writes at the end of the file
+        if (userLogFile == NULL) {
+            TraceLog(LOG_WARNING, "Unable to open %s for appending. User not saved.", USERS_LOG_FILE);
+            return false;
+        }
+    }
+
+    char token[MAX_PASSWORD_TOKEN_LENGTH];
+    FormatPasswordHash(hash, token, sizeof(token));
+    fprintf(userLogFile, "%s %s\n", username, token);
+    if (fflush(userLogFile) != 0 || fsync(fileno(userLogFile)) != 0) {
+        TraceLog(LOG_WARNING, "Unable to write %s. User not saved.", USERS_LOG_FILE);
+        return false;
+    }
+    userLogRecords++;
+    return true;
+}
+
+// CompactUsers: Writes a snapshot that includes every logged registration, then empties the log.
+// If the snapshot cannot be written the log is kept, so no registration is ever lost.
+bool CompactUsers() {
+    if (!SaveUsers()) return false;
+    return TruncateUserLog();
+}
+
+// TruncateUserLog: Empties USERS_LOG_FILE after a snapshot containing all of its records
+// has been written.
+bool TruncateUserLog() {
+    CloseUserLog();
+    FILE* file = fopen(USERS_LOG_FILE, "w"); // Truncate: every record is now in the snapshot
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "Unable to truncate %s after compaction.", USERS_LOG_FILE);
+        return false; // Harmless: replaying records already in the snapshot just repoints the index
+    }
+    fclose(file);
+    userLogRecords = 0;
+    TraceLog(LOG_INFO, "Compacted %s into %s.", USERS_LOG_FILE, binaryUserDatabase ? USERS_DB_FILE : USERS_FILE);
+    return true;
+}
+
+// CloseUserLog: Closes the registration log so it can be truncated or on shutdown.
+void CloseUserLog() {
+    if (userLogFile != NULL) {
+        fclose(userLogFile);
+        userLogFile = NULL;
+    }
+}
+
+// RegisterUser: Queues a new user for the I/O worker and returns at once. The worker hashes
+// the password and logs the record; PollIoResults adds the user once it is safely on disk.
+// Only one user request is in flight at a time, which also guarantees that a compaction
+// snapshot contains every user already in the log.
+UserRequestStatus RegisterUser(const char* username, const char* password) {
+    if (userRequestPending) {
+        SetUIMessage("Please wait, still working on the previous request.");
+        return USER_REQUEST_FAILED;
+    }
+    if (UsernameExists(username)) {
+        // This check should ideally be done before calling RegisterUser
+        // but included here for robustness.
+        SetUIMessage("Registration failed: Username already exists.");
+        return USER_REQUEST_FAILED;
+    }
+
+    IoJob job = { 0 };
+    job.type = IO_JOB_REGISTER;
+    strncpy(job.username, username, MAX_NAME_LENGTH - 1);
+    strncpy(job.password, password, MAX_INPUT_CHARS);
+    bool posted = PostIoJob(&job);
+    SecureZero(job.password, sizeof(job.password));
+    if (!posted) {
+        SetUIMessage("Registration failed: the system is busy. Try again.");
+        return USER_REQUEST_FAILED;
+    }
+    userRequestPending = true;
+    return USER_REQUEST_PENDING;
+}
+
+// AuthenticateUser: Queues a password check for the I/O worker and returns at once;
+// PollIoResults signs the user in if it matches. Unknown names are checked against a dummy
+// hash so the answer takes as long as for a real user. A password verified recently for the
+// same user is accepted from the credential cache without running the KDF.
+UserRequestStatus AuthenticateUser(const char* username, const char* password) {
+    if (userRequestPending) {
+        SetUIMessage("Please wait, still working on the previous request.");
+        return USER_REQUEST_FAILED;
+    }
+
+    int index = FindUser(username); // O(1) lookup through the hash index
+    PrepareCredentialCache(); // Before the job is posted, so the worker sees the key
+    if (index >= 0 && CheckCachedCredentials(username, password, &users[index].password)) {
+        CompleteSignIn(users[index].username); // Verified recently: no KDF run, no worker round trip
+        return USER_REQUEST_DONE;
+    }
+
+    IoJob job = { 0 };
+    job.type = IO_JOB_VERIFY;
+    strncpy(job.username, username, MAX_NAME_LENGTH - 1);
+    strncpy(job.password, password, MAX_INPUT_CHARS);
+    job.userFound = index >= 0;
+    if (job.userFound) {
+        job.hash = users[index].password;
+    } else {
+        job.hash = (PasswordHash){ .scheme = PASSWORD_SCRYPT, .logN = KDF_LOG_N, .r = KDF_R, .p = KDF_P };
+    }
+    bool posted = PostIoJob(&job);
+    SecureZero(job.password, sizeof(job.password));
+    if (!posted) {
+        SetUIMessage("Login failed: the system is busy. Try again.");
+        return USER_REQUEST_FAILED;
+    }
+    userRequestPending = true;
+    return USER_REQUEST_PENDING;
+}
+
+// UsernameExists: Checks if a username is already taken.
+bool UsernameExists(const char* username) {
+    return FindUser(username) >= 0;
+}
+
+// HashUsername: 32-bit FNV-1a hash. Spreads similar usernames well across index slots.
+unsigned int HashUsername(const char* username) {
+    unsigned int hash = 2166136261u; // FNV offset basis
+    int c;
+    while ((c = (unsigned char)*username++)) {
+        hash ^= (unsigned int)c;
+        hash *= 16777619u; // FNV prime
+    }
+    return hash;
+}
+
+// FindUser: Returns the position of 'username' in the users array, or -1 if not registered.
+// Probes linearly from the username's home slot until it finds the name or an empty slot.
+int FindUser(const char* username) {
+    if (userIndex.slotCount == 0) return -1; // Index not built yet, so no users
+    unsigned int mask = (unsigned int)userIndex.slotCount - 1;
+    for (unsigned int slot = HashUsername(username) & mask; ; slot = (slot + 1) & mask) {
+        int entry = userIndex.slots[slot];
+        if (entry <= 0 || entry > userCount) return -1; // Reached an empty slot (or a damaged one): not present
+        if (strncmp(users[entry - 1].username, username, MAX_NAME_LENGTH) == 0) return entry - 1;
+    }
+}
+
+// IndexUser: Inserts the user at 'position' into the hash index.
+// If the username is already indexed, the slot is repointed at the newer record.
+void IndexUser(int position) {
+    unsigned int mask = (unsigned int)userIndex.slotCount - 1;
+    unsigned int slot = HashUsername(users[position].username) & mask;
+    while (userIndex.slots[slot] != 0) {
+        if (strncmp(users[userIndex.slots[slot] - 1].username, users[position].username, MAX_NAME_LENGTH) == 0) {
+            userIndex.slots[slot] = position + 1; // Same username: newest record wins
+            return;
+        }
+        slot = (slot + 1) & mask;
+    }
+    userIndex.slots[slot] = position + 1;
+    userIndex.used++;
+}
+
+// RebuildUserIndex: Replaces the hash index with an empty table of 'slotCount' slots
+// (rounded up to a power of two) and re-inserts every user.
+bool RebuildUserIndex(int slotCount) {
+    if (!DetachUserDatabase()) return false; // A mapped index cannot be freed
+    int count = INITIAL_USER_INDEX_SLOTS;
+    while (count < slotCount) count *= 2;
+
+    int* slots = calloc(count, sizeof(int));
+    if (slots == NULL) return false;
+    free(userIndex.slots);
+    userIndex = (UserIndex){ slots, count, 0 };
+
+    for (int i = 0; i < userCount; i++) IndexUser(i);
+    return true;
+}
+
+// AddUser: Appends a user record, growing the array and the index as needed.
+bool AddUser(const char* username, const PasswordHash* hash) {
+    if (!DetachUserDatabase()) return false; // Mapped records are read-only
+    if (userCount == userCapacity) {
+        int newCapacity = (userCapacity > 0) ? userCapacity * 2 : INITIAL_USER_CAPACITY;
+        User* grown = realloc(users, newCapacity * sizeof(User));
+        if (grown == NULL) return false;
+        users = grown;
+        userCapacity = newCapacity;
+    }
+    // Keep the index at most half full; doubling keeps inserts amortized O(1)
+    if ((userIndex.used + 1) * 2 > userIndex.slotCount) {
+        if (!RebuildUserIndex(userIndex.slotCount * 2)) return false;
+    }
+
+    strncpy(users[userCount].username, username, MAX_NAME_LENGTH - 1);
+    users[userCount].username[MAX_NAME_LENGTH - 1] = '\0';
+    users[userCount].password = *hash;
+    IndexUser(userCount);
+    userCount++;
+    return true;
+}
+
+// UpsertUser: Replaces the password hash of an existing user in place, or adds a new user.
+// Rehashing a password therefore never leaves a stale duplicate record behind.
+bool UpsertUser(const char* username, const PasswordHash* hash) {
+    int position = FindUser(username);
+    if (position < 0) return AddUser(username, hash);
+    if (!DetachUserDatabase()) return false; // Mapped records are read-only
+    users[position].password = *hash;
+    return true;
+}
+
+// FreeUsers: Releases the user array and the username index.
+void FreeUsers() {
+    if (userDatabaseMapping != NULL) {
+        UnmapFile(userDatabaseMapping, userDatabaseMappingSize); // 'users' and the slots live inside it
+        userDatabaseMapping = NULL;
+        userDatabaseMappingSize = 0;
+    } else {
+        free(users);
+        free(userIndex.slots);
+    }
+    users = NULL;
+    userCount = 0;
+    userCapacity = 0;
+    userIndex = (UserIndex){ 0 };
+}
+
+// --- Session Function Implementations ---
+// A sign-in issues a random token; bids look the session up by token in O(1) instead of
+// trusting a typed name. The table lives with the user directory, in the process that checks
+// passwords.
+
+// IssueSession: Creates a session for 'username' lasting SESSION_LIFETIME_MS and returns its
+// token. The session holds the name's id from the shared name registry. Fails if the OS has no
+// randomness to offer or memory runs out.
+bool IssueSession(const char* username, SessionToken* token) {
+    uint32_t userId = InternBidder(username); // Names are interned once per sign-in, not per bid
+    if (userId == BIDDER_NONE) return false;
+    if ((sessions.used + 1) * 2 > sessions.slotCount) { // Keep the table at most half full
+        int slotCount = (sessions.slotCount > 0) ? sessions.slotCount : INITIAL_SESSION_SLOTS;
+        int live = 0;
+        for (int i = 0; i < sessions.slotCount; i++) live += sessions.slots[i].state == SESSION_SLOT_LIVE;
+        while ((live + 1) * 2 > slotCount) slotCount *= 2; // Rehashing alone drops the deleted slots
+        if (!ResizeSessionTable(slotCount)) return false;
+    }
+    do {
+        if (!FillRandom(token->bytes, SESSION_TOKEN_LENGTH)) return false;
+    } while (sessions.slots[FindSessionSlot(token)].state == SESSION_SLOT_LIVE); // 2^-128 per try
+
+    int slot = FindSessionSlot(token);
+    Session* session = &sessions.slots[slot];
+    session->token = *token;
+    session->userId = userId;
+    session->expiresAt = WallClockMs() + SESSION_LIFETIME_MS;
+    session->state = SESSION_SLOT_LIVE;
+    sessions.used++;
+    return true;
+}
+
+// FindSession: Returns the live session for 'token', or NULL. An expired session is removed
+// on the lookup that finds it.
+const Session* FindSession(const SessionToken* token) {
+    if (sessions.slotCount == 0) return NULL;
+    Session* session = &sessions.slots[FindSessionSlot(token)];
+    if (session->state != SESSION_SLOT_LIVE) return NULL;
+    if (WallClockMs() >= session->expiresAt) {
+        SecureZero(session, sizeof(*session));
+        session->state = SESSION_SLOT_DELETED;
+        return NULL;
+    }
+    return session;
+}
+
+// RevokeSession: Ends a session; the token is refused from now on.
+void RevokeSession(const SessionToken* token) {
+    if (sessions.slotCount == 0) return;
+    Session* session = &sessions.slots[FindSessionSlot(token)];
+    if (session->state != SESSION_SLOT_LIVE) return;
+    SecureZero(session, sizeof(*session));
+    session->state = SESSION_SLOT_DELETED;
+}
+
+// FindSessionSlot: Probes for 'token'. Returns its slot, or the first empty slot of its probe
+// sequence if it is not in the table. The table must have at least one empty slot.
+int FindSessionSlot(const SessionToken* token) {
+    uint32_t hash;
+    memcpy(&hash, token->bytes, sizeof(hash));
+    int mask = sessions.slotCount - 1;
+    for (int slot = (int)(hash & (uint32_t)mask);; slot = (slot + 1) & mask) {
+        const Session* session = &sessions.slots[slot];
+        if (session->state == SESSION_SLOT_EMPTY) return slot;
+        if (session->state != SESSION_SLOT_LIVE) continue;
+        uint8_t difference = 0; // Compared in constant time, like password keys
+        for (int i = 0; i < SESSION_TOKEN_LENGTH; i++) difference |= (uint8_t)(session->token.bytes[i] ^ token->bytes[i]);
+        if (difference == 0) return slot;
+    }
+}
+
+// ResizeSessionTable: Moves the live, unexpired sessions into a new table of 'slotCount'
+// slots. Deleted and expired slots are left behind.
+bool ResizeSessionTable(int slotCount) {
+    Session* slots = calloc((size_t)slotCount, sizeof(Session));
+    if (slots == NULL) return false;
+    SessionTable old = sessions;
+    sessions = (SessionTable){ slots, slotCount, 0 };
+    int64_t now = WallClockMs();
+    for (int i = 0; i < old.slotCount; i++) {
+        if (old.slots[i].state != SESSION_SLOT_LIVE || now >= old.slots[i].expiresAt) continue;
+        sessions.slots[FindSessionSlot(&old.slots[i].token)] = old.slots[i];
+        sessions.used++;
+    }
+    if (old.slots != NULL) SecureZero(old.slots, (size_t)old.slotCount * sizeof(Session));
+    free(old.slots);
+    return true;
+}
+
+// FreeSessions: Ends every session and forgets the cached credentials and their key.
+void FreeSessions() {
+    if (sessions.slots != NULL) SecureZero(sessions.slots, (size_t)sessions.slotCount * sizeof(Session));
+    free(sessions.slots);
+    sessions = (SessionTable){ 0 };
+    SecureZero(&credentialCache, sizeof(credentialCache));
+    SecureZero(&currentSession, sizeof(currentSession));
+}
+
+// CompleteSignIn: Issues the user's session and opens the item list.
+void CompleteSignIn(const char* username) {
+    if (!IssueSession(username, &currentSession)) {
+        SetUIMessage("Login failed: unable to start a session.");
+        return;
+    }
+    loggedInUserId = FindSession(&currentSession)->userId; // Set the logged-in user
+    currentScreen = SCREEN_ITEM_LIST; // Go to item list screen
+    SetUIMessage(FrameFormat("Welcome, %s!", GetBidderName(loggedInUserId))); // Welcome message
+    ResetInputBoxes(); // Clear login fields
+}
+
+// PrepareCredentialCache: Draws the cache's HMAC key the first time a sign-in needs it. Without
+// randomness the cache stays off and every sign-in runs the KDF.
+bool PrepareCredentialCache() {
+    if (!credentialCache.keyReady) credentialCache.keyReady = FillRandom(credentialCache.key, sizeof(credentialCache.key));
+    return credentialCache.keyReady;
+}
+
+// CredentialDigest: HMAC-SHA256 under the cache key of the stored key and the password. It
+// changes whenever the stored hash does (a rehash, a new password), which empties the cache
+// entry in effect. Thread-safe once the key is drawn.
+void CredentialDigest(const char* password, const PasswordHash* hash, uint8_t out[32]) {
+    HmacSha256(credentialCache.key, sizeof(credentialCache.key), hash->key, PASSWORD_KEY_LENGTH,
+               (const uint8_t*)password, strlen(password), out);
+}
+
+// CheckCachedCredentials: True if 'username' signed in with 'password' within the last
+// CREDENTIAL_CACHE_LIFETIME_MS. Costs one HMAC; a miss costs nothing else.
+bool CheckCachedCredentials(const char* username, const char* password, const PasswordHash* hash) {
+    if (!credentialCache.keyReady || hash->scheme != PASSWORD_SCRYPT) return false;
+    CredentialCacheEntry* entry = &credentialCache.entries[HashUsername(username) & (CREDENTIAL_CACHE_SLOTS - 1)];
+    if (entry->username[0] == '\0' || strcmp(entry->username, username) != 0) return false;
+    if (WallClockMs() >= entry->expiresAt) {
+        SecureZero(entry, sizeof(*entry));
+        return false;
+    }
+    uint8_t digest[32];
+    CredentialDigest(password, hash, digest);
+    uint8_t difference = 0;
+    for (int i = 0; i < 32; i++) difference |= (uint8_t)(digest[i] ^ entry->digest[i]);
+    SecureZero(digest, sizeof(digest));
+    return difference == 0;
+}
+
+// CacheCredentials: Remembers a sign-in the KDF just verified, replacing whatever shared its slot.
+void CacheCredentials(const char* username, const uint8_t digest[32]) {
+    CredentialCacheEntry* entry = &credentialCache.entries[HashUsername(username) & (CREDENTIAL_CACHE_SLOTS - 1)];
+    strncpy(entry->username, username, MAX_NAME_LENGTH - 1);
+    entry->username[MAX_NAME_LENGTH - 1] = '\0';
+    memcpy(entry->digest, digest, sizeof(entry->digest));
+    entry->expiresAt = WallClockMs() + CREDENTIAL_CACHE_LIFETIME_MS;
+}
+
+// --- I/O Worker Function Implementations ---
+
+// StartIoWorker: Starts the worker thread. If it cannot be started, jobs run inline on the
+// UI thread instead, with the same result path.
+void StartIoWorker() {
+    ioWorker.running = true;
+    ioWorker.started = pthread_create(&ioWorker.thread, NULL, IoWorkerThread, NULL) == 0;
+    if (!ioWorker.started) TraceLog(LOG_WARNING, "Unable to start the I/O worker. File writes will block the UI.");
+}
+
+// StopIoWorker: Lets the worker finish every queued job, then joins it.
+void StopIoWorker() {
+    if (!ioWorker.started) return;
+    pthread_mutex_lock(&ioWorker.lock);
+    ioWorker.running = false;
+    pthread_cond_signal(&ioWorker.wake);
+    pthread_mutex_unlock(&ioWorker.lock);
+    pthread_join(ioWorker.thread, NULL);
+    ioWorker.started = false;
+}
+
+// PostIoJob: Queues a job for the worker. At most IO_QUEUE_CAPACITY jobs are in flight, so
+// neither ring can overflow: a job only leaves 'jobs' to enter 'results'.
+bool PostIoJob(const IoJob* job) {
+    if (ioWorker.outstanding >= IO_QUEUE_CAPACITY) return false;
+
+    if (!ioWorker.started) { // No worker: run it here and deliver the result the usual way
+        IoJob inlineJob = *job;
+        ExecuteIoJob(&inlineJob);
+        IoRingPush(&ioWorker.results, &inlineJob);
+    } else {
+        IoRingPush(&ioWorker.jobs, job);
+        pthread_mutex_lock(&ioWorker.lock); // Taken only to wake the worker if it is asleep
+        pthread_cond_signal(&ioWorker.wake);
+        pthread_mutex_unlock(&ioWorker.lock);
+    }
+    ioWorker.outstanding++;
+    return true;
+}
+
+// PollIoResults: Applies every finished job to UI-thread state. The user directory is only
+// ever changed here, so the UI never shares it with the worker.
+void PollIoResults() {
+    ApplyIoResults(IO_QUEUE_CAPACITY); // No more jobs than that can be in flight
+}
+
+// ApplyIoResults: Applies finished jobs in the order they completed, at most 'maxJobs' of them.
+// Returns how many were applied. A replay uses the limit to apply results on the same frames
+// as the recorded session.
+int ApplyIoResults(int maxJobs) {
+    IoJob job;
+    int applied = 0;
+    while (applied < maxJobs && IoRingPop(&ioWorker.results, &job)) {
+        applied++;
+        ioWorker.outstanding--;
+        switch (job.type) {
+            case IO_JOB_REGISTER: {
+                userRequestPending = false;
+                if (!job.ok) {
+                    SetUIMessage("Registration failed. Try again.");
+                } else if (!AddUser(job.username, &job.hash)) { // Also keeps the username index current
+                    SetUIMessage("Cannot register: out of memory."); // On disk, so it still appears after a restart
+                } else {
+                    SetUIMessage("Registration successful! Please sign in."); // Success message
+                    if (currentScreen == SCREEN_SIGN_UP) {
+                        currentScreen = SCREEN_SIGN_IN; // Go to Sign In screen
+                        ResetInputBoxes(); // Clear sign-up fields
+                    }
+
+                }
+            } break;
+
+            case IO_JOB_VERIFY: {
+                userRequestPending = false;
+                if (job.ok) {
+                    if (job.upgraded) UpsertUser(job.username, &job.hash); // Already logged by the worker
+                    if (job.cacheable) CacheCredentials(job.username, job.credentialDigest);
+                    CompleteSignIn(job.username);
+                } else {
+                    SetUIMessage("Login failed. Check username/password."); // Error message
+                }
+            } break;
+
+            case IO_JOB_COMPACT: break; // Nothing to apply; failures were logged by the worker
+        }
+
+        // Fold the log into the snapshot from time to time so startup replay stays short
+        IoJob compaction = { 0 };
+        compaction.type = IO_JOB_COMPACT;
+        if (job.type != IO_JOB_COMPACT && job.logRecords >= USER_LOG_COMPACT_THRESHOLD && CopyUserSnapshot(&compaction.snapshot)) {
+            if (!PostIoJob(&compaction)) {
+                free(compaction.snapshot.users);
+                free(compaction.snapshot.index.slots);
+            }
+        }
+    }
+    return applied;
+}
+
+// ExecuteIoJob: Performs one job and fills in its result fields. Runs on the worker thread,
+// which owns the registration log (userLogFile, userLogRecords) while it is running.
+void ExecuteIoJob(IoJob* job) {
+    switch (job->type) {
+        case IO_JOB_REGISTER: {
+            double profileStart = ProfileBegin();
+            job->ok = HashPassword(job->password, &job->hash) &&
+                      AppendUserLog(job->username, &job->hash); // Once on disk it survives a crash
+            ProfileEnd("HashPassword", profileStart);
+        } break;
+
+        case IO_JOB_VERIFY: {
+            double profileStart = ProfileBegin();
+            job->ok = VerifyPassword(job->password, &job->hash) && job->userFound;
+            ProfileEnd("AuthenticateUser", profileStart);
+
+            // Migrate djb2 records (and scrypt below the current cost) while the password is at hand
+            PasswordHash upgraded;
+            if (job->ok && PasswordNeedsRehash(&job->hash) && HashPassword(job->password, &upgraded) &&
+                AppendUserLog(job->username, &upgraded)) {
+                job->hash = upgraded;
+                job->upgraded = true;
+            }
+            job->cacheable = job->ok && job->hash.scheme == PASSWORD_SCRYPT && credentialCache.keyReady;
+            if (job->cacheable) CredentialDigest(job->password, &job->hash, job->credentialDigest);
+        } break;
+
+        case IO_JOB_COMPACT: {
+            double profileStart = ProfileBegin();
+            job->ok = WriteUsersSnapshot(&job->snapshot) && TruncateUserLog();
+            ProfileEnd("SaveUsers", profileStart);
+            free(job->snapshot.users);
+            free(job->snapshot.index.slots);
+            job->snapshot = (UserSnapshot){ 0 };
+        } break;
+    }
+    SecureZero(job->password, sizeof(job->password)); // The plain password never travels back
+    job->logRecords = userLogRecords;
+}
+
+// IoWorkerThread: Runs jobs in order until StopIoWorker is called and the queue is empty.
+void* IoWorkerThread(void* arg) {
+    (void)arg;
+    IoJob job;
+    for (;;) {
+        if (IoRingPop(&ioWorker.jobs, &job)) {
+            ExecuteIoJob(&job);
+            IoRingPush(&ioWorker.results, &job); // Cannot be full, see PostIoJob
+            continue;
+        }
+
+        // Queue is empty: sleep until a job is posted or shutdown is requested
+        pthread_mutex_lock(&ioWorker.lock);
+        bool stop = false;
+        while (!stop && __atomic_load_n(&ioWorker.jobs.tail, __ATOMIC_ACQUIRE) == ioWorker.jobs.head) {
+            if (!ioWorker.running) stop = true;
+            else pthread_cond_wait(&ioWorker.wake, &ioWorker.lock);
+        }
+        pthread_mutex_unlock(&ioWorker.lock);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+// IoRingPush: Producer side. The slot is filled before 'tail' is published.
+bool IoRingPush(IoRing* ring, const IoJob* job) {
+    uint32_t tail = ring->tail; // Only this side writes 'tail'
+    if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == IO_QUEUE_CAPACITY) return false; // Full
+    ring->slots[tail & (IO_QUEUE_CAPACITY - 1)] = *job;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// IoRingPop: Consumer side. The slot is copied out (and its password cleared, so a plain
+// password lives only in the job being run) before 'head' releases it to the producer.
+bool IoRingPop(IoRing* ring, IoJob* job) {
+    uint32_t head = ring->head; // Only this side writes 'head'
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head) return false; // Empty
+    IoJob* slot = &ring->slots[head & (IO_QUEUE_CAPACITY - 1)];
+    *job = *slot;
+    SecureZero(slot->password, sizeof(slot->password));
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// --- Bid Ledger Function Implementations ---
+
+// OpenBidLedger: Rebuilds each item's high bid from every ledger segment on disk and opens
+// segments 0 .. 'segmentCount' - 1 for new bids. Segments beyond that (left by a server that
+// ran with more shards) are only replayed. After LoadCheckpoint only the tail of each segment
+// past the snapshot is read. Returns false if segment 0 could not be opened.
+bool OpenBidLedger(int segmentCount) {
+    if (segmentCount < 1) segmentCount = 1;
+    if (segmentCount > BID_LEDGER_MAX_SEGMENTS) segmentCount = BID_LEDGER_MAX_SEGMENTS;
+    bidLedger.segmentCount = segmentCount;
+
+    int replayed = 0, files = 0;
+    for (int k = 0; k < BID_LEDGER_MAX_SEGMENTS; k++) {
+        int count = 0;
+        if (k < segmentCount) {
+            if (OpenLedgerSegment(&bidLedger.segments[k], k, &count)) files++;
+        } else {
+            char fileName[32];
+            snprintf(fileName, sizeof(fileName), BID_LEDGER_SEGMENT_FORMAT, k);
+            FILE* file = FileExists(fileName) ? fopen(fileName, "rb") : NULL;
+            if (file == NULL) continue;
+            uint32_t identity;
+            int64_t start = LedgerReplayStart(file, k, fileName, &identity);
+            count = ReplayBidLedger(file, start, &bidLedger.segments[k].committedBytes); // A torn tail is repaired once the segment is written again
+            bidLedger.segments[k].identity = (bidLedger.segments[k].committedBytes > 0) ? identity : 0;
+            fclose(file);
+            if (count < 0) {
+                TraceLog(LOG_WARNING, "Out of memory replaying %s. Some of its bids are missing.", fileName);
+                continue;
+            }
+            files++;
+        }
+        replayed += count;
+    }
+    for (int i = 0; i < items.count; i++) ApplyLedgerToItem(i);
+
+    TraceLog(LOG_INFO, "Replayed %d bids from %d ledger file%s.", replayed, files, (files == 1) ? "" : "s");
+    return bidLedger.segments[0].open;
+}
+
+// OpenLedgerSegment: Replays segment 'index' into the ledger's per-item table, drops a torn
+// trailing record if the last run crashed mid-write, and starts the segment's flush thread.
+bool OpenLedgerSegment(LedgerSegment* segment, int index, int* replayed) {
+    if (index == 0) snprintf(segment->fileName, sizeof(segment->fileName), "%s", BID_LEDGER_FILE);
+    else snprintf(segment->fileName, sizeof(segment->fileName), BID_LEDGER_SEGMENT_FORMAT, index);
+    FILE* file = fopen(segment->fileName, "r+b"); // Existing segment: read it, then append
+    if (file == NULL) file = fopen(segment->fileName, "w+b"); // First run: create it
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "Unable to open %s. Bids will not be saved.", segment->fileName);
+        return false;
+    }
+
+    int64_t validBytes = 0;
+    uint32_t identity;
+    int64_t start = LedgerReplayStart(file, index, segment->fileName, &identity);
+    *replayed = ReplayBidLedger(file, start, &validBytes);
+    segment->identity = (validBytes > 0) ? identity : 0; // The first record may have been the torn one
+    if (*replayed < 0) {
+        // The file is intact; leave it alone so the bids are there once memory allows replaying them
+        TraceLog(LOG_WARNING, "Out of memory replaying %s. Bids will not be saved.", segment->fileName);
+        *replayed = 0;
+        segment->committedBytes = validBytes; // Snapshots must not claim the unread bids
+        fclose(file);
+        return false;
+    }
+    fseek(file, 0, SEEK_END);
+    if (ftell(file) != validBytes) {
+        // Anything after the last intact record is a torn write; cut it off so new records stay aligned
+        fflush(file);
+        if (ftruncate(fileno(file), (long)validBytes) != 0) {
+            TraceLog(LOG_WARNING, "Unable to repair %s. Bids will not be saved.", segment->fileName);
+            fclose(file); // Bids already replayed stay applied
+            return false;
+        }
+        TraceLog(LOG_WARNING, "Discarded a torn record at the end of %s.", segment->fileName);
+    }
+    fseek(file, (long)validBytes, SEEK_SET); // Position for appending
+
+    segment->file = file;
+    segment->committedBytes = validBytes;
+    segment->pendingCapacity = BID_LEDGER_INITIAL_BATCH;
+    segment->pending = malloc(segment->pendingCapacity * sizeof(PendingBid));
+    segment->pendingCount = 0;
+    segment->running = true;
+    pthread_mutex_init(&segment->lock, NULL);
+    pthread_cond_init(&segment->wake, NULL);
+    if (segment->pending == NULL || pthread_create(&segment->flushThread, NULL, BidLedgerFlushThread, segment) != 0) {
+        TraceLog(LOG_WARNING, "Unable to start the bid ledger for %s. Bids will not be saved.", segment->fileName);
+        pthread_cond_destroy(&segment->wake);
+        pthread_mutex_destroy(&segment->lock);
+        free(segment->pending);
+        fclose(file);
+        segment->pending = NULL;
+        segment->file = NULL;
+        return false;
+    }
+    segment->open = true;
+    return true;
+}
+
+// LedgerReplayStart: Reads the checksum of the first record of segment 'index' into 'identity'
+// (0 if the file is shorter than a record) and returns the offset replay starts at: the
+// snapshot's offset if the snapshot was taken of this file, else 0. A ledger that was deleted
+// or rotated since then has another first record, so its bids before that offset are not skipped.
+int64_t LedgerReplayStart(FILE* file, int index, const char* fileName, uint32_t* identity) {
+    BidRecord first;
+    fseek(file, 0, SEEK_SET);
+    *identity = (fread(&first, sizeof(first), 1, file) == 1) ? first.checksum : 0;
+    if (bidLedger.replayFrom[index] == 0) return 0;
+    if (*identity != bidLedger.replayIdentity[index]) {
+        TraceLog(LOG_WARNING, "%s is not the file the snapshot saw. Replaying all of it.", fileName);
+        return 0;
+    }
+    return bidLedger.replayFrom[index];
+}
+
+// ReplayBidLedger: Reads records from byte 'start' of 'file' (the start of the file if the
+// file is shorter than that, e.g. replaced since the snapshot) and keeps the winning intact
+// one per item id; OpenBidLedger applies them once every segment is read, and items that are
+// still being streamed from the catalog pick theirs up through ApplyLedgerToItem. Stops at the
+// first record that is short or fails its checksum and reports the byte length of the
+// intact prefix through 'validBytes'. Records in the older float layout are converted to cents.
+// Returns -1 if the per-item table cannot grow; 'validBytes' is then 'start', since the records
+// after it were not all read and the file must not be cut there.
+int ReplayBidLedger(FILE* file, int64_t start, int64_t* validBytes) {
+    fseek(file, 0, SEEK_END);
+    long length = ftell(file);
+    if (start < 0 || start > length || start % (int64_t)sizeof(BidRecord) != 0) start = 0; // Not the file the snapshot saw
+    fseek(file, (long)start, SEEK_SET);
+
+    int applied = 0, intact = 0;
+    BidRecord record;
+    while (fread(&record, sizeof(record), 1, file) == 1) {
+        uint32_t hash = HashBytes(&record, offsetof(BidRecord, checksum)); // Same range in both layouts
+        if (record.checksum == hash) {
+            LegacyBidRecord legacy;
+            memcpy(&legacy, &record, sizeof(legacy));
+            intact++; // Intact whatever it holds: only torn records may be cut off
+            if (!(legacy.amount >= 0.0f)) continue; // Negative or NaN, never a bid; skipped but kept in the file
+            record.timestamp = legacy.timestamp;
+            // Nearest cent of what the UI showed. Old builds allowed up to 999999999.0f, which is
+            // 1e9 as a float and above MAX_BID_CENTS, so the top is clamped rather than rejected.
+            record.amount = (legacy.amount * 100.0 >= (double)MAX_BID_CENTS) ? MAX_BID_CENTS : (int64_t)(legacy.amount * 100.0 + 0.5);
+            record.itemId = legacy.itemId;
+            memcpy(record.bidder, legacy.bidder, MAX_BIDDER_LENGTH);
+        } else if (record.checksum == (hash ^ BID_RECORD_CENTS_TAG)) {
+            intact++;
+        } else {
+            break; // Torn or corrupt
+        }
+        record.bidder[MAX_BIDDER_LENGTH - 1] = '\0';
+
+        if (record.itemId >= (uint32_t)bidLedger.latestCount) {
+            int newCount = (bidLedger.latestCount > 0) ? bidLedger.latestCount : INITIAL_ITEM_CAPACITY;
+            while ((uint32_t)newCount <= record.itemId) {
+                if (newCount > INT32_MAX / 2) { // No table that large can be allocated anyway
+                    *validBytes = start;
+                    return -1;
+                }
+                newCount *= 2;
+            }
+            BidRecord* latest = realloc(bidLedger.latest, (size_t)newCount * sizeof(BidRecord));
+            bool* latestPresent = realloc(bidLedger.latestPresent, (size_t)newCount * sizeof(bool));
+            if (latest != NULL) bidLedger.latest = latest;
+            if (latestPresent != NULL) bidLedger.latestPresent = latestPresent;
+            if (latest == NULL || latestPresent == NULL) {
+                *validBytes = start;
+                return -1;
+            }
+            memset(bidLedger.latestPresent + bidLedger.latestCount, 0, (newCount - bidLedger.latestCount) * sizeof(bool));
+            bidLedger.latestCount = newCount;
+        }
+        // Bids from concurrent threads (or a server that ran with a different shard count) can
+        // reach the ledger out of order, but accepted bids only ever increase, so the highest
+        // amount per item is the newest
+        if (!bidLedger.latestPresent[record.itemId] || record.amount > bidLedger.latest[record.itemId].amount) {
+            bidLedger.latest[record.itemId] = record;
+        }
+        bidLedger.latestPresent[record.itemId] = true;
+        applied++;
+    }
+    *validBytes = start + (int64_t)intact * (int64_t)sizeof(BidRecord);
+    return applied;
+}
+
+// ApplyLedgerToItem: Copies the newest replayed bid for item 'index' (if any) into the store
+// unless the item already has that bid or a higher one (restored from a snapshot that saw
+// it). Every accepted bid extends the deadline to at least ANTI_SNIPE_SECONDS after itself,
+// so the newest bid alone restores the extended deadline.
+void ApplyLedgerToItem(int index) {
+    if (index >= bidLedger.latestCount || !bidLedger.latestPresent[index]) return; // No recorded bids
+    int64_t currentBid = GetCurrentBid(index);
+    if (bidLedger.latest[index].amount < currentBid) return; // Accepted bids only go up, so this one is already in
+    if (bidLedger.latest[index].amount == currentBid) {
+        // A snapshot taken between SubmitBidAs storing the bid and extending the deadline has the
+        // bid but not the extension. Extending only ever moves the deadline later, so redo it.
+        ExtendDeadline(index, bidLedger.latest[index].timestamp * 1000);
+        return;
+    }
+    uint32_t bidderId = InternBidder(bidLedger.latest[index].bidder);
+    if (bidderId == BIDDER_NONE) return; // Out of memory, keep the catalog's bid
+    StoreBidState(index, PackBid(bidLedger.latest[index].amount, bidderId));
+    ExtendDeadline(index, bidLedger.latest[index].timestamp * 1000); // Redo the anti-sniping extension of the last bid
+    InvalidateItemRender(index);
+}
+
+// RecordBid: Adds an accepted bid to the pending batch of the item's segment and wakes that
+// segment's flush thread. Only takes a short lock, which on the server only the item's shard
+// ever contends for; encoding, disk writes and fsync happen on the flush thread.
+void RecordBid(int itemIndex, int64_t amount, uint32_t bidderId) {
+    if (bidLedger.segmentCount == 0) return; // Ledger not opened
+    LedgerSegment* segment = &bidLedger.segments[itemIndex % bidLedger.segmentCount];
+    if (!segment->open) return; // Segment unavailable, already reported at startup
+
+    PendingBid bid = { (int64_t)time(NULL), amount, (uint32_t)itemIndex, bidderId };
+
+    pthread_mutex_lock(&segment->lock);
+    if (segment->pendingCount == segment->pendingCapacity) {
+        PendingBid* grown = realloc(segment->pending, segment->pendingCapacity * 2 * sizeof(PendingBid));
+        if (grown == NULL) {
+            pthread_mutex_unlock(&segment->lock);
+            TraceLog(LOG_WARNING, "Bid ledger batch is full. Bid on item %d not saved.", itemIndex);
+            return;
+        }
+        segment->pending = grown;
+        segment->pendingCapacity *= 2;
+    }
+    segment->pending[segment->pendingCount++] = bid;
+    pthread_cond_signal(&segment->wake);
+    pthread_mutex_unlock(&segment->lock);
+}
+
+// WriteBidRecords: Turns pending bids into checksummed BidRecords, resolving each bidder id to
+// its name, and writes them BID_LEDGER_WRITE_CHUNK at a time. Runs on the flush thread.
+// 'firstChecksum' receives the checksum of the first record (the segment's identity if the
+// file was empty).
+bool WriteBidRecords(FILE* file, const PendingBid* bids, int count, uint32_t* firstChecksum) {
+    BidRecord records[BID_LEDGER_WRITE_CHUNK];
+    for (int first = 0; first < count; first += BID_LEDGER_WRITE_CHUNK) {
+        int chunk = (count - first < BID_LEDGER_WRITE_CHUNK) ? count - first : BID_LEDGER_WRITE_CHUNK;
+        for (int i = 0; i < chunk; i++) {
+            const PendingBid* bid = &bids[first + i];
+            BidRecord* record = &records[i];
+            memset(record, 0, sizeof(*record)); // Padding and the name tail feed the checksum
+            record->timestamp = bid->timestamp;
+            record->amount = bid->amount;
+            record->itemId = bid->itemId;
+            strncpy(record->bidder, GetBidderName(bid->bidderId), MAX_BIDDER_LENGTH - 1); // Lock-free lookup
+            record->checksum = HashBytes(record, offsetof(BidRecord, checksum)) ^ BID_RECORD_CENTS_TAG;
+        }
+        if (first == 0) *firstChecksum = records[0].checksum;
+        if (fwrite(records, sizeof(BidRecord), chunk, file) != (size_t)chunk) return false;
+    }
+    return true;
+}
+
+// BidLedgerFlushThread: Waits for bids, then commits them in batches. Bids that arrive while
+// a batch is being written pile up in 'pending' and share the next fsync (group commit).
+// A short sleep after waking lets bids arriving close together join the same batch.
+void* BidLedgerFlushThread(void* arg) {
+    LedgerSegment* segment = arg;
+    PendingBid* spare = NULL; // Buffer handed back to the bidding threads on the next swap
+    int spareCapacity = 0;
+
+    pthread_mutex_lock(&segment->lock);
+    while (segment->running || segment->pendingCount > 0) {
+        if (segment->pendingCount == 0) {
+            pthread_cond_wait(&segment->wake, &segment->lock);
+            if (segment->running) {
+                // Give bids arriving right after this one a chance to share the commit
+                pthread_mutex_unlock(&segment->lock);
+                struct timespec delay = { 0, BID_LEDGER_FLUSH_INTERVAL_MS * 1000000L };
+                nanosleep(&delay, NULL);
+                pthread_mutex_lock(&segment->lock);
+            }
+            continue;
+        }
+
+        // The spare must be as large as the batch it replaces, so RecordBid never loses room
+        if (spareCapacity < segment->pendingCapacity) {
+            PendingBid* grown = realloc(spare, segment->pendingCapacity * sizeof(PendingBid));
+            if (grown != NULL) {
+                spare = grown;
+                spareCapacity = segment->pendingCapacity;
+            }
+        }
+
+        // Swap the pending batch out so bidding threads can keep appending while we write.
+        // Without a usable spare, write the batch in place while holding the lock instead.
+        bool swapped = spareCapacity >= segment->pendingCapacity;
+        PendingBid* flushing = segment->pending;
+        int flushingCapacity = segment->pendingCapacity;
+        int flushCount = segment->pendingCount;
+        if (swapped) {
+            segment->pending = spare;
+            segment->pendingCapacity = spareCapacity;
+            segment->pendingCount = 0;
+            pthread_mutex_unlock(&segment->lock);
+        }
+
+        uint32_t firstChecksum = 0;
+        bool written = WriteBidRecords(segment->file, flushing, flushCount, &firstChecksum) &&
+                       fflush(segment->file) == 0 && fsync(fileno(segment->file)) == 0; // One fsync per batch
+        if (!written) TraceLog(LOG_WARNING, "Unable to write %d bids to %s.", flushCount, segment->fileName);
+
+        if (swapped) {
+            spare = flushing; // Reuse the written batch as the next spare
+            spareCapacity = flushingCapacity;
+            pthread_mutex_lock(&segment->lock);
+        } else {
+            segment->pendingCount = 0;
+        }
+        if (written) {
+            if (segment->committedBytes == 0) segment->identity = firstChecksum; // The file's first record
+            segment->committedBytes += (int64_t)flushCount * (int64_t)sizeof(BidRecord); // Snapshots may skip these from now on
+        }
+    }
+    pthread_mutex_unlock(&segment->lock);
+
+    free(spare);
+    return NULL;
+}
+
+// CloseBidLedger: Stops every flush thread after it has committed its queued bids.
+void CloseBidLedger() {
+    for (int k = 0; k < bidLedger.segmentCount; k++) {
+        LedgerSegment* segment = &bidLedger.segments[k];
+        if (!segment->open) continue;
+
+        pthread_mutex_lock(&segment->lock);
+        segment->running = false;
+        pthread_cond_signal(&segment->wake);
+        pthread_mutex_unlock(&segment->lock);
+        pthread_join(segment->flushThread, NULL);
+
+        pthread_cond_destroy(&segment->wake);
+        pthread_mutex_destroy(&segment->lock);
+        free(segment->pending);
+        fclose(segment->file);
+    }
+    free(bidLedger.latest);
+    free(bidLedger.latestPresent);
+    bidLedger = (BidLedger){ 0 };
+}
+
+// HashBytes: 32-bit FNV-1a over an arbitrary byte range (used for record checksums).
+uint32_t HashBytes(const void* data, size_t length) {
+    return HashBytesFrom(2166136261u, data, length); // FNV offset basis
+}
+
+// HashBytesFrom: Feeds more bytes into a hash started by HashBytes, so data written in pieces
+// can be checksummed as one range.
+uint32_t HashBytesFrom(uint32_t hash, const void* data, size_t length) {
+    const unsigned char* bytes = data;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= bytes[i];
+        hash *= 16777619u; // FNV prime
+    }
+    return hash;
+}
+
+// --- Checkpoint Function Implementations ---
+
+// LoadCheckpoint: Rebuilds the item store from CHECKPOINT_FILE if it was written from the
+// catalog that is on disk now, and records where in each ledger segment the snapshot ends so
+// OpenBidLedger replays only the bids after it. Returns false (leaving the store empty) if
+// there is no usable snapshot; the caller then loads the catalog and the whole ledger.
+bool LoadCheckpoint() {
+    FILE* file = fopen(CHECKPOINT_FILE, "rb");
+    if (file == NULL) return false;
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    unsigned char* data = (size >= (long)sizeof(CheckpointHeader)) ? malloc(size) : NULL;
+    bool read = data != NULL && fread(data, 1, size, file) == (size_t)size;
+    fclose(file);
+    if (!read) {
+        free(data);
+        TraceLog(LOG_WARNING, "Unable to read %s. Rebuilding the items from the catalog and ledger.", CHECKPOINT_FILE);
+        return false;
+    }
+
+    CheckpointHeader header;
+    memcpy(&header, data, sizeof(header));
+    uint32_t hash = HashBytesFrom(HashBytes(&header, offsetof(CheckpointHeader, checksum)), data + sizeof(header), size - sizeof(header));
+    if (memcmp(header.magic, CHECKPOINT_MAGIC, 4) != 0 || header.version != CHECKPOINT_VERSION ||
+        header.recordSize != sizeof(CheckpointItem) || header.checksum != hash) {
+        free(data);
+        TraceLog(LOG_WARNING, "%s is damaged or from another version. Rebuilding the items from the catalog and ledger.", CHECKPOINT_FILE);
+        return false;
+    }
+    if (header.catalogSize != checkpointer.catalogSize || header.catalogModified != checkpointer.catalogModified) {
+        free(data);
+        TraceLog(LOG_INFO, "%s changed since the last snapshot. Loading it again.", CATALOG_FILE);
+        return false;
+    }
+
+    // Records were checksummed as a whole; the bounds checks only guard against a layout bug
+    bool ok = ReserveItems((int)header.itemCount);
+    long at = sizeof(header);
+    for (uint32_t i = 0; ok && i < header.itemCount; i++) {
+        CheckpointItem record;
+        if (size - at < (long)sizeof(record)) { ok = false; break; }
+        memcpy(&record, data + at, sizeof(record));
+        at += sizeof(record);
+        long textLength = (long)record.nameLength + record.descriptionLength + record.imageLength + record.bidderLength + 4;
+        if (size - at < textLength) { ok = false; break; }
+        const char* name = (const char*)data + at;
+        const char* description = name + record.nameLength + 1;
+        const char* image = description + record.descriptionLength + 1;
+        const char* bidder = image + record.imageLength + 1;
+        if (name[record.nameLength] != '\0' || description[record.descriptionLength] != '\0' ||
+            image[record.imageLength] != '\0' || bidder[record.bidderLength] != '\0') { ok = false; break; }
+        at += textLength;
+
+        int index = AddAuctionItem(name, description, record.amount, bidder, record.closed != 0, record.endTime);
+        if (index < 0) { ok = false; break; }
+        SetItemImage(index, image);
+    }
+    free(data);
+    if (!ok) {
+        TraceLog(LOG_WARNING, "Unable to restore %s. Rebuilding the items from the catalog and ledger.", CHECKPOINT_FILE);
+        FreeAuctionData();
+        return false;
+    }
+
+    memcpy(bidLedger.replayFrom, header.ledgerOffsets, sizeof(bidLedger.replayFrom));
+    memcpy(bidLedger.replayIdentity, header.ledgerIdentities, sizeof(bidLedger.replayIdentity));
+    memcpy(checkpointer.savedOffsets, header.ledgerOffsets, sizeof(checkpointer.savedOffsets));
+    memcpy(checkpointer.savedIdentities, header.ledgerIdentities, sizeof(checkpointer.savedIdentities));
+    checkpointer.saved = true;
+    TraceLog(LOG_INFO, "Restored %d items from %s.", items.count, CHECKPOINT_FILE);
+    return true;
+}
+
+// WriteCheckpoint: Writes every item to CHECKPOINT_TEMP_FILE and renames it over
+// CHECKPOINT_FILE once it is safely on disk, so a crash at any point leaves either the old or
+// the new snapshot intact. 'ledgerOffsets' must have been taken before the items are read.
+bool WriteCheckpoint(const int64_t* ledgerOffsets, const uint32_t* ledgerIdentities) {
+    double profileStart = ProfileBegin();
+    FILE* file = fopen(CHECKPOINT_TEMP_FILE, "wb");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "Unable to open %s for writing. Snapshot not saved.", CHECKPOINT_TEMP_FILE);
+        return false;
+    }
+
+    CheckpointHeader header;
+    memset(&header, 0, sizeof(header)); // Padding feeds the checksum
+    memcpy(header.magic, CHECKPOINT_MAGIC, 4);
+    header.version = CHECKPOINT_VERSION;
+    header.itemCount = (uint32_t)items.count;
+    header.recordSize = sizeof(CheckpointItem);
+    header.catalogSize = checkpointer.catalogSize;
+    header.catalogModified = checkpointer.catalogModified;
+    header.createdAt = WallClockMs();
+    memcpy(header.ledgerOffsets, ledgerOffsets, sizeof(header.ledgerOffsets));
+    memcpy(header.ledgerIdentities, ledgerIdentities, sizeof(header.ledgerIdentities));
+    uint32_t hash = HashBytes(&header, offsetof(CheckpointHeader, checksum));
+    bool written = fwrite(&header, sizeof(header), 1, file) == 1; // Rewritten with the checksum at the end
+
+    for (int i = 0; written && i < items.count; i++) {
+        uint64_t bidState = LoadBidState(i); // Amount and bidder from the same bid
+        const char* name = GetItemName(i);
+        const char* description = GetItemDescription(i);
+        const char* image = GetItemImage(i);
+        const char* bidder = GetBidderName(BidBidder(bidState));
+
+        CheckpointItem record;
+        memset(&record, 0, sizeof(record));
+        record.amount = BidAmount(bidState);
+        record.endTime = LoadEndTime(i);
+        record.closed = __atomic_load_n(&items.auctionClosed[i], __ATOMIC_ACQUIRE) ? 1 : 0; // Closed concurrently by the scheduler
+        record.nameLength = (uint16_t)strlen(name); // Every string is far shorter than 64 KiB (see MAX_DESC_LENGTH)
+        record.descriptionLength = (uint16_t)strlen(description);
+        record.imageLength = (uint16_t)strlen(image);
+        record.bidderLength = (uint8_t)strlen(bidder);
+
+        hash = HashBytesFrom(hash, &record, sizeof(record));
+        hash = HashBytesFrom(hash, name, record.nameLength + 1);
+        hash = HashBytesFrom(hash, description, record.descriptionLength + 1);
+        hash = HashBytesFrom(hash, image, record.imageLength + 1);
+        hash = HashBytesFrom(hash, bidder, record.bidderLength + 1);
+        written = fwrite(&record, sizeof(record), 1, file) == 1 &&
+                  fwrite(name, record.nameLength + 1, 1, file) == 1 &&
+                  fwrite(description, record.descriptionLength + 1, 1, file) == 1 &&
+                  fwrite(image, record.imageLength + 1, 1, file) == 1 &&
+                  fwrite(bidder, record.bidderLength + 1, 1, file) == 1;
+    }
+
+    header.checksum = hash;
+    written = written && fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    written = written && (fflush(file) == 0) && (fsync(fileno(file)) == 0);
+    fclose(file);
+    if (!written) {
+        TraceLog(LOG_WARNING, "Unable to write %s. Snapshot not saved.", CHECKPOINT_TEMP_FILE);
+        return false;
+    }
+#if defined(_WIN32)
+    remove(CHECKPOINT_FILE); // rename() does not replace existing files on Windows
+#endif
+    if (rename(CHECKPOINT_TEMP_FILE, CHECKPOINT_FILE) != 0) {
+        TraceLog(LOG_WARNING, "Unable to replace %s. Snapshot not saved.", CHECKPOINT_FILE);
+        return false;
+    }
+    ProfileEnd("Checkpoint", profileStart);
+    TraceLog(LOG_INFO, "Saved a snapshot of %d items to %s.", items.count, CHECKPOINT_FILE);
+    return true;
+}
+
+// CheckpointIfChanged: Snapshots the item store unless no bid was committed since the newest
+// snapshot (closes need no snapshot: a restart closes overdue auctions again). Returns false
+// only if a snapshot was due and could not be written.
+bool CheckpointIfChanged() {
+    int64_t offsets[BID_LEDGER_MAX_SEGMENTS];
+    uint32_t identities[BID_LEDGER_MAX_SEGMENTS];
+    LedgerCommittedOffsets(offsets, identities); // Before the items are read, see Checkpointer
+    if (checkpointer.saved && memcmp(offsets, checkpointer.savedOffsets, sizeof(offsets)) == 0 &&
+        memcmp(identities, checkpointer.savedIdentities, sizeof(identities)) == 0) return true;
+    if (!WriteCheckpoint(offsets, identities)) return false;
+    memcpy(checkpointer.savedOffsets, offsets, sizeof(offsets));
+    memcpy(checkpointer.savedIdentities, identities, sizeof(identities));
+    checkpointer.saved = true;
+    return true;
+}
+
+// StartCheckpointer: Starts snapshotting. Call only once the item store has stopped growing
+// (the catalog is loaded) and the ledger is open; snapshots cover what the ledger records.
+void StartCheckpointer() {
+    checkpointer.attempted = true;
+    checkpointer.started = true;
+    checkpointer.running = true;
+    if (pthread_create(&checkpointer.thread, NULL, CheckpointThread, NULL) != 0) {
+        TraceLog(LOG_WARNING, "Unable to start the snapshot thread. Restarts replay the whole ledger.");
+        checkpointer.started = false;
+        checkpointer.running = false;
+    }
+}
+
+// StopCheckpointer: Stops the snapshot thread and takes a last snapshot, so a clean restart
+// replays only the bids still in flight now. Bidding must have stopped, and the ledger must
+// still be open.
+void StopCheckpointer() {
+    if (!checkpointer.started) return;
+    pthread_mutex_lock(&checkpointer.lock);
+    checkpointer.running = false;
+    pthread_cond_signal(&checkpointer.wake);
+    pthread_mutex_unlock(&checkpointer.lock);
+    pthread_join(checkpointer.thread, NULL);
+    checkpointer.started = false;
+    CheckpointIfChanged();
+}
+
+// CheckpointThread: Takes a snapshot every CHECKPOINT_INTERVAL_SECONDS, starting with one
+// right away if the store has none yet (e.g. after loading a large catalog).
+void* CheckpointThread(void* arg) {
+    (void)arg;
+    if (!checkpointer.saved) CheckpointIfChanged();
+    pthread_mutex_lock(&checkpointer.lock);
+    while (checkpointer.running) {
+        int64_t wakeAt = WallClockMs() + (int64_t)CHECKPOINT_INTERVAL_SECONDS * 1000; // pthread_cond_timedwait measures wall-clock time too
+        struct timespec until = { (time_t)(wakeAt / 1000), (long)(wakeAt % 1000) * 1000000L };
+        while (checkpointer.running && pthread_cond_timedwait(&checkpointer.wake, &checkpointer.lock, &until) == 0) {}
+        if (!checkpointer.running) break;
+        pthread_mutex_unlock(&checkpointer.lock);
+        CheckpointIfChanged();
+        pthread_mutex_lock(&checkpointer.lock);
+    }
+    pthread_mutex_unlock(&checkpointer.lock);
+    return NULL;
+}
+
+// LedgerCommittedOffsets: Length of the durable prefix and identity of every ledger segment:
+// the files the running process appends to, and those it only replayed at startup.
+void LedgerCommittedOffsets(int64_t* offsets, uint32_t* identities) {
+    for (int k = 0; k < BID_LEDGER_MAX_SEGMENTS; k++) {
+        LedgerSegment* segment = &bidLedger.segments[k];
+        if (!segment->open) {
+            offsets[k] = segment->committedBytes; // Fixed since OpenBidLedger
+            identities[k] = segment->identity;
+            continue;
+        }
+        pthread_mutex_lock(&segment->lock);
+        offsets[k] = segment->committedBytes;
+        identities[k] = segment->identity;
+        pthread_mutex_unlock(&segment->lock);
+    }
+}
+
+// CatalogFingerprint: Size and modification time of CATALOG_FILE, or -1 and 0 if there is no
+// catalog (demo items). A snapshot is only restored over the catalog it was taken from.
+void CatalogFingerprint(int64_t* size, int64_t* modified) {
+    struct stat info;
+    if (stat(CATALOG_FILE, &info) != 0) {
+        *size = -1;
+        *modified = 0;
+        return;
+    }
+    *size = (int64_t)info.st_size;
+    *modified = (int64_t)info.st_mtime;
+}
+
+// --- Frame Arena Function Implementations ---
+
+// FrameAlloc: Returns 'size' bytes of scratch memory that stay valid until the next
+// ResetFrameArena. Returns NULL (and counts the failure) if the frame has used up the arena.
+void* FrameAlloc(size_t size) {
+    size_t start = (frameArena.used + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+    if (size > FRAME_ARENA_SIZE - start || start > FRAME_ARENA_SIZE) {
+        frameArena.failedAllocations++;
+        return NULL;
+    }
+    frameArena.used = start + size;
+    return frameArena.memory + start;
+}
+
+// FrameFormat: Formats like printf into the frame arena. Unlike TextFormat, which cycles
+// through a few static buffers, every result stays valid for the rest of the frame, so the
+// same string can be measured and drawn without formatting it twice. Returns "" if the arena is full.
+const char* FrameFormat(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    size_t available = (frameArena.used < FRAME_ARENA_SIZE) ? FRAME_ARENA_SIZE - frameArena.used : 0;
+    char* text = (char*)frameArena.memory + frameArena.used; // Format in place, then claim only what was written
+    int length = vsnprintf(available > 0 ? text : NULL, available, format, args);
+    va_end(args);
+    if (length < 0 || (size_t)length >= available) {
+        frameArena.failedAllocations++;
+        return "";
+    }
+    frameArena.used += (size_t)length + 1; // Strings need no alignment; FrameAlloc rounds up after them
+    return text;
+}
+
+// ResetFrameArena: Releases everything allocated since the last reset. Call once per frame,
+// after EndDrawing, when nothing formatted for the frame is referenced any more.
+void ResetFrameArena() {
+    if (frameArena.failedAllocations > 0) {
+        TraceLog(LOG_WARNING, "Frame arena full: %d allocations failed (raise FRAME_ARENA_SIZE).", frameArena.failedAllocations);
+    }
+    if (frameArena.used > frameArena.peak) frameArena.peak = frameArena.used;
+    frameArena.lastUsed = frameArena.used;
+    frameArena.used = 0;
+    frameArena.failedAllocations = 0;
+}
+
+// --- Profiler Function Implementations ---
+
+// ProfilerClock: Monotonic time in seconds. Works before InitWindow, unlike GetTime().
+double ProfilerClock() {
+#if defined(_WIN32)
+    static unsigned long long int frequency = 0; // Fixed at boot, so racing first calls store the same value
+    unsigned long long int count;
+    if (frequency == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&count);
+    return (double)count / (double)frequency;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+#endif
+}
+
+// InitProfiler: Must run on the UI thread before any scope is recorded.
+void InitProfiler() {
+    profiler.epoch = ProfilerClock();
+    profiler.mainThread = pthread_self();
+}
+
+// ProfileBegin: Starts a timed scope; pass the result to ProfileEnd.
+double ProfileBegin() {
+    return ProfilerClock() - profiler.epoch;
+}
+
+// ProfileEnd: Completes a timed scope and stores it in the ring buffer.
+void ProfileEnd(const char* name, double start) {
+    double end = ProfilerClock() - profiler.epoch;
+    int threadId = pthread_equal(pthread_self(), profiler.mainThread) ? 1 : 2;
+
+    pthread_mutex_lock(&profiler.lock);
+    ProfileEvent* event = &profiler.events[profiler.eventCount % PROFILER_MAX_EVENTS];
+    *event = (ProfileEvent){ name, start, end - start, threadId };
+    profiler.eventCount++;
+    pthread_mutex_unlock(&profiler.lock);
+}
+
+// RecordFrameTime: Adds the CPU time of one drawn frame to the history.
+void RecordFrameTime(double seconds) {
+    profiler.frameTimes[profiler.frameCount % PROFILER_FRAME_HISTORY] = (float)seconds;
+    profiler.frameCount++;
+}
+
+// CompareFloats: qsort comparator for ascending floats.
+int CompareFloats(const void* a, const void* b) {
+    float x = *(const float*)a, y = *(const float*)b;
+    return (x > y) - (x < y);
+}
+
+// FrameTimePercentile: Sorts a copy of the frame history and picks the requested percentile.
+float FrameTimePercentile(float percentile) {
+    int count = (profiler.frameCount < PROFILER_FRAME_HISTORY) ? profiler.frameCount : PROFILER_FRAME_HISTORY;
+    if (count == 0) return 0.0f;
+
+    float sorted[PROFILER_FRAME_HISTORY];
+    memcpy(sorted, profiler.frameTimes, count * sizeof(float));
+    qsort(sorted, count, sizeof(float), CompareFloats);
+    int rank = (int)(percentile / 100.0f * (count - 1) + 0.5f);
+    return sorted[rank];
+}
+
+#if !defined(AUCTION_HEADLESS)
+// DrawProfilerOverlay: Shows p50/p99 frame times over the recent history (toggle with F3).
+void DrawProfilerOverlay() {
+    int count = (profiler.frameCount < PROFILER_FRAME_HISTORY) ? profiler.frameCount : PROFILER_FRAME_HISTORY;
+    Rectangle panel = { GetScreenWidth() - UiPx(250), UiPx(70), UiPx(240), UiPx(103) };
+    int textX = (int)panel.x + UiPx(10), textY = (int)panel.y;
+    DrawRectangleRec(panel, CLITERAL(Color){ 0, 0, 0, 180 });
+    DrawUiText(FrameFormat("Frame p50: %.2f ms", FrameTimePercentile(50.0f) * 1000.0f), textX, textY + UiPx(8), 15, RAYWHITE);
+    DrawUiText(FrameFormat("Frame p99: %.2f ms", FrameTimePercentile(99.0f) * 1000.0f), textX, textY + UiPx(26), 15, RAYWHITE);
+    DrawUiText(FrameFormat("Frames: %d  Scopes: %lld", count, profiler.eventCount), textX, textY + UiPx(44), 15, LIGHTGRAY_CUSTOM);
+    DrawUiText(FrameFormat("Arena: %d B last, %d B peak", (int)frameArena.lastUsed, (int)frameArena.peak), textX, textY + UiPx(62), 15, LIGHTGRAY_CUSTOM);
+    DrawUiText("F12: export " PROFILER_TRACE_FILE, textX, textY + UiPx(80), 15, LIGHTGRAY_CUSTOM);
+}
+#endif
+
+// ExportChromeTrace: Writes the buffered scopes, oldest first, as "complete" (ph X) events in
+// the Chrome trace event format. Open the file in chrome://tracing or ui.perfetto.dev.
+bool ExportChromeTrace(const char* fileName) {
+    FILE* file = fopen(fileName, "w");
+    if (file == NULL) {
+        TraceLog(LOG_WARNING, "Unable to open %s for writing.", fileName);
+        return false;
+    }
+
+    // Copy the ring under the lock, then format without it: writing 65536 events takes long
+    // enough to stall every thread that finishes a scope meanwhile
+    ProfileEvent* events = malloc(PROFILER_MAX_EVENTS * sizeof(ProfileEvent));
+    if (events == NULL) {
+        TraceLog(LOG_WARNING, "Out of memory exporting %s.", fileName);
+        fclose(file);
+        return false;
+    }
+    pthread_mutex_lock(&profiler.lock);
+    long long last = profiler.eventCount;
+    long long first = (last > PROFILER_MAX_EVENTS) ? last - PROFILER_MAX_EVENTS : 0;
+    for (long long i = first; i < last; i++) events[i - first] = profiler.events[i % PROFILER_MAX_EVENTS];
+    pthread_mutex_unlock(&profiler.lock);
+
+    int count = (int)(last - first);
+    fprintf(file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    for (int i = 0; i < count; i++) {
+        const ProfileEvent* event = &events[i];
+        fprintf(file, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}%s\n",
+                event->name, event->threadId, event->start * 1e6, event->duration * 1e6, (i + 1 < count) ? "," : "");
+    }
+    fprintf(file, "]}\n");
+    free(events);
+
+    bool written = (ferror(file) == 0);
+    fclose(file);
+    TraceLog(LOG_INFO, "Exported %d profiler scopes to %s.", count, fileName);
+    return written;
+}
+
+// --- Bid Function Implementations ---
+
+// ValidateBid: Runs every acceptance check against the item's current state without changing
+// it. The UI uses this to reject bids before sending them; SubmitBid repeats the checks.
+BidStatus ValidateBid(int itemIndex, int64_t amount, const char* bidder) {
+    if (itemIndex < 0 || itemIndex >= items.count) return BID_UNKNOWN_ITEM;
+    if (bidder[0] == '\0') return BID_NO_NAME;
+    return CheckBidAgainst(itemIndex, amount, LoadBidState(itemIndex));
+}
+
+// CheckBidAgainst: Acceptance rules for bidding 'amount' cents when the item's bid word is
+// 'bidState'. Amounts are integers, so every comparison is exact at any size.
+BidStatus CheckBidAgainst(int itemIndex, int64_t amount, uint64_t bidState) {
+    if (items.auctionClosed[itemIndex]) return BID_CLOSED;
+    int64_t endTime = LoadEndTime(itemIndex);
+    if (endTime > 0 && WallClockMs() >= endTime) return BID_CLOSED; // Over, even if the scheduler has not closed it yet
+    if (amount < 0) return BID_INVALID_AMOUNT;
+    if (amount <= BidAmount(bidState)) return BID_TOO_LOW;
+    if (amount > MAX_BID_CENTS) return BID_TOO_LARGE; // Prevent excessively large bids (and keep them packable)
+    return BID_ACCEPTED;
+}
+
+// SubmitBid: Validates a bid and, if it wins, makes it the item's new high bid and queues it
+// for the ledger. Safe to call from any number of threads: the high bid is replaced with one
+// compare-and-swap on the item's bid word, so bids on different items never touch shared
+// state and racing bids on the same item are ordered by the CAS (a loser re-checks against
+// the winner). Used by the local UI and by the bid server.
+BidStatus SubmitBid(int itemIndex, int64_t amount, const char* bidder) {
+    if (itemIndex < 0 || itemIndex >= items.count) return BID_UNKNOWN_ITEM;
+    if (bidder[0] == '\0') return BID_NO_NAME;
+
+    BidStatus status = CheckBidAgainst(itemIndex, amount, LoadBidState(itemIndex));
+    if (status != BID_ACCEPTED) return status; // Cheap rejection before touching the registry
+
+    uint32_t bidderId = InternBidder(bidder);
+    if (bidderId == BIDDER_NONE) return BID_FAILED;
+    return SubmitBidAs(itemIndex, amount, bidderId);
+}
+
+// SubmitBidAs: SubmitBid for a bidder that already has an id, such as the user of a session.
+// From here on the bid is only numbers: one compare-and-swap, one ledger entry.
+BidStatus SubmitBidAs(int itemIndex, int64_t amount, uint32_t bidderId) {
+    if (itemIndex < 0 || itemIndex >= items.count) return BID_UNKNOWN_ITEM;
+    if (bidderId == BIDDER_NONE) return BID_NO_NAME;
+
+    uint64_t expected = LoadBidState(itemIndex);
+    BidStatus status = CheckBidAgainst(itemIndex, amount, expected);
+    if (status != BID_ACCEPTED) return status;
+    uint64_t desired = PackBid(amount, bidderId);
+    while (!__atomic_compare_exchange_n(&items.bidState[itemIndex], &expected, desired, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+        status = CheckBidAgainst(itemIndex, amount, expected); // 'expected' now holds the bid that got in first
+        if (status != BID_ACCEPTED) return status;
+    }
+
+    ExtendDeadline(itemIndex, WallClockMs()); // A late bid gives the others time to answer
+    RecordBid(itemIndex, amount, bidderId); // Queue for the ledger (never blocks on disk)
+    char amountText[MAX_CENTS_TEXT];
+    TraceLog(LOG_INFO, "BID PLACED: %s for %s by %s", GetItemName(itemIndex), FormatCents(amount, amountText, sizeof(amountText)), GetBidderName(bidderId));
+    return BID_ACCEPTED;
+}
+
+// PackBid: An item's high bid as one word: the amount in cents in the upper 40 bits (enough
+// for MAX_BID_CENTS) and the bidder id in the lower BID_BIDDER_BITS. 'amount' must already be
+// checked against MAX_BID_CENTS.
+uint64_t PackBid(int64_t amount, uint32_t bidderId) {
+    return ((uint64_t)amount << BID_BIDDER_BITS) | bidderId;
+}
+
+// BidAmount: Amount in cents stored in a bid word.
+int64_t BidAmount(uint64_t bidState) {
+    return (int64_t)(bidState >> BID_BIDDER_BITS);
+}
+
+// BidBidder: Bidder id stored in a bid word.
+uint32_t BidBidder(uint64_t bidState) {
+    return (uint32_t)(bidState & ((1u << BID_BIDDER_BITS) - 1));
+}
+
+// LoadBidState: Reads an item's bid word. Amount and bidder always come from the same bid.
+uint64_t LoadBidState(int itemIndex) {
+    return __atomic_load_n(&items.bidState[itemIndex], __ATOMIC_ACQUIRE);
+}
+
+// StoreBidState: Overwrites an item's bid word without checking it, for state that is
+// already authoritative (ledger replay, updates from the bid server).
+void StoreBidState(int itemIndex, uint64_t bidState) {
+    __atomic_store_n(&items.bidState[itemIndex], bidState, __ATOMIC_RELEASE);
+}
+
+// GetCurrentBid: Current high bid of an item, in cents.
+int64_t GetCurrentBid(int itemIndex) {
+    return BidAmount(LoadBidState(itemIndex));
+}
+
+// GetHighestBidder: Name of an item's highest bidder.
+const char* GetHighestBidder(int itemIndex) {
+    return GetBidderName(BidBidder(LoadBidState(itemIndex)));
+}
+
+// InternBidder: Returns the id of 'name' (truncated to MAX_BIDDER_LENGTH - 1), registering it
+// on first use. Known names only take the shared lock; the exclusive lock is held just long
+// enough to copy a new name in (and, rarely, to grow the index).
+uint32_t InternBidder(const char* name) {
+    char key[MAX_BIDDER_LENGTH];
+    strncpy(key, name, MAX_BIDDER_LENGTH - 1);
+    key[MAX_BIDDER_LENGTH - 1] = '\0';
+    unsigned int hash = HashUsername(key);
+
+    pthread_rwlock_rdlock(&bidders.lock);
+    uint32_t id = FindBidderLocked(key, hash);
+    pthread_rwlock_unlock(&bidders.lock);
+    if (id != BIDDER_NONE) return id;
+
+    pthread_rwlock_wrlock(&bidders.lock);
+    id = FindBidderLocked(key, hash); // Another thread may have added it in between
+    if (id == BIDDER_NONE) id = AddBidderLocked(key, hash);
+    pthread_rwlock_unlock(&bidders.lock);
+    return id;
+}
+
+// FindBidderLocked: Looks 'name' up in the registry index. Caller holds the lock.
+uint32_t FindBidderLocked(const char* name, unsigned int hash) {
+    if (bidders.slotCount == 0) return BIDDER_NONE;
+    uint32_t mask = bidders.slotCount - 1;
+    for (uint32_t slot = hash & mask; bidders.slots[slot] != 0; slot = (slot + 1) & mask) {
+        uint32_t id = bidders.slots[slot] - 1;
+        if (strcmp(GetBidderName(id), name) == 0) return id;
+    }
+    return BIDDER_NONE;
+}
+
+// AddBidderLocked: Stores a new name and indexes it. Caller holds the lock exclusively.
+// The name is written before 'count' is published, so readers never see a half-written name.
+uint32_t AddBidderLocked(const char* name, unsigned int hash) {
+    uint32_t id = bidders.count;
+    uint32_t chunk = id / BIDDER_CHUNK_SIZE;
+    if (chunk >= BIDDER_MAX_CHUNKS) {
+        TraceLog(LOG_WARNING, "Bidder registry is full.");
+        return BIDDER_NONE;
+    }
+    if (bidders.chunks[chunk] == NULL) {
+        bidders.chunks[chunk] = malloc(BIDDER_CHUNK_SIZE * sizeof(*bidders.chunks[chunk]));
+        if (bidders.chunks[chunk] == NULL) return BIDDER_NONE;
+    }
+
+    if ((id + 1) * 2 > bidders.slotCount) { // Keep the index at most half full
+        uint32_t newSlotCount = (bidders.slotCount > 0) ? bidders.slotCount * 2 : INITIAL_BIDDER_INDEX_SLOTS;
+        uint32_t* slots = calloc(newSlotCount, sizeof(uint32_t));
+        if (slots == NULL) return BIDDER_NONE;
+        for (uint32_t existing = 0; existing < id; existing++) {
+            uint32_t slot = HashUsername(GetBidderName(existing)) & (newSlotCount - 1);
+            while (slots[slot] != 0) slot = (slot + 1) & (newSlotCount - 1);
+            slots[slot] = existing + 1;
+        }
+        free(bidders.slots);
+        bidders.slots = slots;
+        bidders.slotCount = newSlotCount;
+    }
+
+    strcpy(bidders.chunks[chunk][id % BIDDER_CHUNK_SIZE], name);
+    uint32_t slot = hash & (bidders.slotCount - 1);
+    while (bidders.slots[slot] != 0) slot = (slot + 1) & (bidders.slotCount - 1);
+    bidders.slots[slot] = id + 1;
+    __atomic_store_n(&bidders.count, id + 1, __ATOMIC_RELEASE);
+    return id;
+}
+
+// GetBidderName: Name for an id taken from a bid word. Chunks never move, so no lock is needed.
+const char* GetBidderName(uint32_t bidderId) {
+    if (bidderId >= __atomic_load_n(&bidders.count, __ATOMIC_ACQUIRE)) return ""; // Never issued
+    return bidders.chunks[bidderId / BIDDER_CHUNK_SIZE][bidderId % BIDDER_CHUNK_SIZE];
+}
+
+// FreeBidders: Releases the registry. No bid words may refer to it afterwards.
+void FreeBidders() {
+    for (int chunk = 0; chunk < BIDDER_MAX_CHUNKS && bidders.chunks[chunk] != NULL; chunk++) {
+        free(bidders.chunks[chunk]);
+        bidders.chunks[chunk] = NULL;
+    }
+    free(bidders.slots);
+    bidders.slots = NULL;
+    bidders.slotCount = 0;
+    bidders.count = 0;
+}
+
+// BidStatusMessage: Text shown to the user for a bid outcome. Amounts are in cents.
+const char* BidStatusMessage(BidStatus status, int64_t amount, int64_t currentBid) {
+    char amountText[MAX_CENTS_TEXT], currentText[MAX_CENTS_TEXT];
+    switch (status) {
+        case BID_ACCEPTED: return FrameFormat("Bid of $%s placed successfully!", FormatCents(amount, amountText, sizeof(amountText)));
+        case BID_NO_NAME: return "Please enter your name to bid.";
+        case BID_TOO_LOW: return FrameFormat("Bid failed: $%s is not higher than current bid $%s", FormatCents(amount, amountText, sizeof(amountText)), FormatCents(currentBid, currentText, sizeof(currentText)));
+        case BID_TOO_LARGE: return "Bid amount too large!";
+        case BID_CLOSED: return "Bid failed: this auction is closed.";
+        case BID_UNKNOWN_ITEM: return "Bid failed: unknown item.";
+        case BID_FAILED: return "Bid failed: please try again later.";
+        case BID_INVALID_AMOUNT: return "Bid failed: enter an amount like 25 or 25.50.";
+    }
+    return "Bid failed.";
+}
+
+// ParseCents: Parses a dollar amount such as "1500", "$12.5" or "0.99" into cents. Leading and
+// trailing blanks are allowed, and more than two decimals only if the extra ones are zeros.
+// Works on integers only, so there is no rounding, no locale and no allocation. Returns -1 if
+// 'text' is not an amount, or INT64_MAX if it is larger than any bid could be.
+int64_t ParseCents(const char* text) {
+    const char* c = text;
+    while (*c == ' ') c++;
+    if (*c == '$') c++;
+
+    int64_t whole = 0;
+    int digits = 0;
+    bool tooLarge = false;
+    for (; *c >= '0' && *c <= '9'; c++, digits++) {
+        if (whole > MAX_BID_CENTS) tooLarge = true; // Keep scanning so the syntax is still checked
+        else whole = whole * 10 + (*c - '0');
+    }
+    int64_t fraction = 0;
+    int decimals = 0;
+    if (*c == '.') {
+        for (c++; *c >= '0' && *c <= '9'; c++, decimals++) {
+            if (decimals < 2) fraction = fraction * 10 + (*c - '0');
+            else if (*c != '0') return -1; // Fractions of a cent
+        }
+    }
+    while (*c == ' ') c++;
+    if (*c != '\0' || digits + decimals == 0) return -1;
+    if (decimals == 1) fraction *= 10; // "12.5" is 12.50
+    if (tooLarge) return INT64_MAX;
+    return whole * 100 + fraction;
+}
+
+// FormatCents: Writes a non-negative amount of cents as dollars with two decimals ("1500.00"),
+// exactly, for any amount. Returns 'buffer' so it can be used inside a FrameFormat call.
+const char* FormatCents(int64_t cents, char* buffer, int capacity) {
+    snprintf(buffer, capacity, "%lld.%02d", (long long)(cents / 100), (int)(cents % 100));
+    return buffer;
+}
+
+// --- Close Scheduler Function Implementations ---
+
+// WallClockMs: Unix time in milliseconds. Deadlines are wall-clock times so they survive
+// restarts and mean the same on the server and its clients.
+int64_t WallClockMs() {
+#if defined(_WIN32)
+    return (int64_t)time(NULL) * 1000; // Second resolution is all time.h offers without windows.h
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_REALTIME, &now);
+    return (int64_t)now.tv_sec * 1000 + now.tv_nsec / 1000000;
+#endif
+}
+
+// EnableCloseScheduler: Schedules the deadlines of every item loaded so far; AddAuctionItem
+// schedules later ones. Only the thread that runs CloseNextDueAuction on a heap may touch it
+// (the server enables the scheduler before its shards start).
+void EnableCloseScheduler() {
+    closeScheduler.enabled = true;
+    for (int i = 0; i < items.count; i++) ScheduleClose(i);
+}
+
+// FreeCloseScheduler: Drops every deadline in 'scheduler'.
+void FreeCloseScheduler(CloseScheduler* scheduler) {
+    free(scheduler->heap);
+    *scheduler = (CloseScheduler){ .enabled = scheduler->enabled };
+}
+
+// SchedulerFor: The heap an item's deadline lives in: its shard's on the server, otherwise
+// the single closeScheduler.
+CloseScheduler* SchedulerFor(int index) {
+    return (bidServer.shardCount > 0) ? &bidServer.shards[index % bidServer.shardCount].scheduler : &closeScheduler;
+}
+
+// ScheduleClose: Adds an open item with a deadline to its heap (O(log n)).
+void ScheduleClose(int index) {
+    int64_t endTime = LoadEndTime(index);
+    if (endTime == 0 || items.auctionClosed[index]) return; // Nothing to close
+    if (!PushDeadline(SchedulerFor(index), (Deadline){ endTime, index })) {
+        TraceLog(LOG_WARNING, "Unable to schedule the close of '%s'. Bids are still refused after its deadline.", GetItemName(index));
+    }
+}
+
+// CloseNextDueAuction: Closes the auction with the earliest deadline if that deadline is at or
+// before 'now', and returns its index (-1 if none is due). Callers loop until -1 and publish
+// each close. Entries of items closed by other means are dropped; entries whose item was
+// extended meanwhile are pushed back with the new deadline. The closed flag is stored
+// atomically because the server's network thread reads it while shards close their items.
+int CloseNextDueAuction(CloseScheduler* scheduler, int64_t now) {
+    while (scheduler->count > 0 && scheduler->heap[0].endTime <= now) {
+        int index = PopDeadline(scheduler).itemIndex;
+        if (index >= items.count || items.auctionClosed[index]) continue;
+        int64_t endTime = LoadEndTime(index);
+        if (endTime == 0) continue; // Deadline removed
+        if (endTime > now) { // Extended by a late bid: wait for the new deadline
+            if (!PushDeadline(scheduler, (Deadline){ endTime, index })) TraceLog(LOG_WARNING, "Unable to reschedule the close of '%s'.", GetItemName(index));
+            continue;
+        }
+        __atomic_store_n(&items.auctionClosed[index], true, __ATOMIC_RELEASE);
+        char amountText[MAX_CENTS_TEXT];
+        TraceLog(LOG_INFO, "AUCTION CLOSED: %s at %s (%s)", GetItemName(index), FormatCents(GetCurrentBid(index), amountText, sizeof(amountText)), GetHighestBidder(index));
+        return index;
+    }
+    return -1;
+}
+
+// NextCloseDeadline: Earliest deadline in the heap (0 if none), for sleeping until it is due.
+int64_t NextCloseDeadline(CloseScheduler* scheduler) {
+    return (scheduler->count > 0) ? scheduler->heap[0].endTime : 0;
+}
+
+// PushDeadline: Inserts a deadline and sifts it up (O(log n)).
+bool PushDeadline(CloseScheduler* scheduler, Deadline deadline) {
+    if (scheduler->count == scheduler->capacity) {
+        int newCapacity = (scheduler->capacity > 0) ? scheduler->capacity * 2 : INITIAL_SCHEDULER_CAPACITY;
+        Deadline* grown = realloc(scheduler->heap, newCapacity * sizeof(Deadline));
+        if (grown == NULL) return false;
+        scheduler->heap = grown;
+        scheduler->capacity = newCapacity;
+    }
+    Deadline* heap = scheduler->heap;
+    int at = scheduler->count++;
+    while (at > 0 && heap[(at - 1) / 2].endTime > deadline.endTime) {
+        heap[at] = heap[(at - 1) / 2]; // Move the later parent down
+        at = (at - 1) / 2;
+    }
+    heap[at] = deadline;
+    return true;
+}
+
+// PopDeadline: Removes and returns the earliest deadline; the heap must not be empty (O(log n)).
+Deadline PopDeadline(CloseScheduler* scheduler) {
+    Deadline* heap = scheduler->heap;
+    Deadline earliest = heap[0];
+    Deadline last = heap[--scheduler->count];
+    int at = 0;
+    for (;;) {
+        int child = 2 * at + 1;
+        if (child >= scheduler->count) break;
+        if (child + 1 < scheduler->count && heap[child + 1].endTime < heap[child].endTime) child++;
+        if (heap[child].endTime >= last.endTime) break;
+        heap[at] = heap[child]; // Move the earlier child up
+        at = child;
+    }
+    if (scheduler->count > 0) heap[at] = last;
+    return earliest;
+}
+
+// LoadEndTime: Reads an item's deadline. Bidding threads extend deadlines, so it is atomic.
+int64_t LoadEndTime(int itemIndex) {
+    return __atomic_load_n(&items.endTime[itemIndex], __ATOMIC_ACQUIRE);
+}
+
+// StoreEndTime: Replaces an item's deadline (the server's word, in --connect mode).
+void StoreEndTime(int itemIndex, int64_t endTime) {
+    __atomic_store_n(&items.endTime[itemIndex], endTime, __ATOMIC_RELEASE);
+}
+
+// ExtendDeadline: Anti-sniping. A bid accepted at 'bidTime' within the last ANTI_SNIPE_SECONDS
+// of an auction moves its end to ANTI_SNIPE_SECONDS after the bid, so the other bidders always
+// get that long to answer. Deadlines only ever move later, which a CAS loop keeps true when
+// bids race; the scheduler picks the new deadline up when the old one comes due.
+void ExtendDeadline(int itemIndex, int64_t bidTime) {
+    int64_t extended = bidTime + (int64_t)ANTI_SNIPE_SECONDS * 1000;
+    int64_t current = LoadEndTime(itemIndex);
+    while (current > 0 && current < extended) {
+        if (__atomic_compare_exchange_n(&items.endTime[itemIndex], &current, extended, true, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) return;
+    }
+}
+
+// FormatTimeLeft: Writes a countdown such as "2h 05m", "4m 12s" or "12s".
+void FormatTimeLeft(int64_t milliseconds, char* text, int capacity) {
+    long long seconds = (milliseconds > 0) ? (milliseconds + 999) / 1000 : 0; // Round up: "0s" only once it is over
+    if (seconds >= 3600) snprintf(text, capacity, "%lldh %02lldm", seconds / 3600, (seconds / 60) % 60);
+    else if (seconds >= 60) snprintf(text, capacity, "%lldm %02llds", seconds / 60, seconds % 60);
+    else snprintf(text, capacity, "%llds", seconds);
+}
+
+// --- Networking Function Implementations ---
+// The bid protocol runs over TCP with small framed messages (see NetMessageType). Sockets are
+// only implemented for POSIX systems; on Windows the server and --connect are unavailable.
+
+#if !defined(_WIN32)
+
+// HandleStopSignal: Lets Ctrl+C end the server loop cleanly so the ledger is flushed.
+void HandleStopSignal(int signalNumber) {
+    (void)signalNumber;
+    serverStopRequested = 1;
+}
+
+// MakeNonBlocking: Switches a socket to non-blocking mode and disables Nagle's algorithm,
+// since bid messages are tiny and latency matters more than packet count.
+bool MakeNonBlocking(int socketFd) {
+    int noDelay = 1;
+    setsockopt(socketFd, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+    int flags = fcntl(socketFd, F_GETFL, 0);
+    return flags >= 0 && fcntl(socketFd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+// QueueItemState: Appends the full state of one item to a client's output, preceded by the
+// bidder's name if the client has not had it yet.
+void QueueItemState(ServerClient* client, int itemIndex) {
+    uint64_t bidState = LoadBidState(itemIndex); // Amount and bidder from the same bid
+    if (!QueueBidderName(client, BidBidder(bidState))) return; // Out of memory; the next change resends it
+    NetBuffer* out = &client->connection.out;
+    int start = out->size;
+    BeginMessage(out, NET_MSG_ITEM_STATE);
+    PutU32(out, (uint32_t)itemIndex);
+    PutU64(out, bidState);
+    PutU8(out, __atomic_load_n(&items.auctionClosed[itemIndex], __ATOMIC_ACQUIRE) ? 1 : 0); // Shards close items concurrently
+    PutU64(out, (uint64_t)LoadEndTime(itemIndex));
+    EndMessage(out, start);
+}
+
+// RunBidServer: Loads the catalog and ledger, then serves bids until interrupted. One poll()
+// loop does the socket work for every client and routes each bid to the shard that owns the
+// item; shards apply bids and close auctions in parallel and report back through their result
+// rings. The pass's new high bids are sent in batches to the clients subscribed to them.
+int RunBidServer(const char* port, int shardCount) {
+    if (shardCount <= 0) {
+        long cores = sysconf(_SC_NPROCESSORS_ONLN);
+        shardCount = (cores > 1) ? (int)cores - 1 : 1; // Leave a core for the network thread
+    }
+    if (shardCount > SERVER_MAX_SHARDS) shardCount = SERVER_MAX_SHARDS;
+
+    InitAuctionData(true); // Newest snapshot if there is one
+    while (catalogLoader.active) PumpCatalogLoader(1.0); // Headless: load the whole catalog up front
+    bidServer.dirtyItems = calloc(items.count > 0 ? items.count : 1, sizeof(uint8_t));
+    bidServer.dirtyList = malloc((items.count > 0 ? items.count : 1) * sizeof(int));
+    if (bidServer.dirtyItems == NULL || bidServer.dirtyList == NULL || !StartShards(&bidServer, shardCount)) {
+        TraceLog(LOG_ERROR, "Not enough memory to serve %d items.", items.count);
+        free(bidServer.dirtyItems);
+        free(bidServer.dirtyList);
+        StopShards(&bidServer);
+        FreeAuctionData();
+        return 1;
+    }
+    EnableCloseScheduler(); // Each shard closes its auctions at their deadlines
+    OpenBidLedger(shardCount); // One segment per shard
+
+    struct addrinfo hints = { 0 };
+    struct addrinfo* address = NULL;
+    hints.ai_family = AF_INET6; // Dual-stack where available
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_flags = AI_PASSIVE;
+    if (getaddrinfo(NULL, port, &hints, &address) != 0) {
+        hints.ai_family = AF_INET; // IPv4-only systems
+        if (getaddrinfo(NULL, port, &hints, &address) != 0) {
+            TraceLog(LOG_ERROR, "Invalid server port '%s'.", port);
+            return 1;
+        }
+    }
+    bidServer.listenSocket = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+    int reuse = 1, v6Only = 0;
+    if (bidServer.listenSocket >= 0) {
+        setsockopt(bidServer.listenSocket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        if (address->ai_family == AF_INET6) setsockopt(bidServer.listenSocket, IPPROTO_IPV6, IPV6_V6ONLY, &v6Only, sizeof(v6Only));
+    }
+    bool listening = bidServer.listenSocket >= 0 &&
+                     bind(bidServer.listenSocket, address->ai_addr, address->ai_addrlen) == 0 &&
+                     listen(bidServer.listenSocket, 128) == 0 && MakeNonBlocking(bidServer.listenSocket);
+    freeaddrinfo(address);
+    if (!listening || !RunShards(&bidServer)) {
+        if (listening) TraceLog(LOG_ERROR, "Unable to start the bid shards.");
+        else TraceLog(LOG_ERROR, "Unable to listen on port %s.", port);
+        if (bidServer.listenSocket >= 0) close(bidServer.listenSocket);
+        free(bidServer.dirtyItems);
+        free(bidServer.dirtyList);
+        StopShards(&bidServer);
+        CloseBidLedger();
+        FreeAuctionData();
+        return 1;
+    }
+
+    signal(SIGINT, HandleStopSignal);
+    signal(SIGTERM, HandleStopSignal);
+    signal(SIGPIPE, SIG_IGN); // A client vanishing mid-send must not kill the server
+    TraceLog(LOG_INFO, "Auction server listening on port %s with %d items in %d shards.", port, items.count, bidServer.shardCount);
+    if (bidLedger.segments[0].open) StartCheckpointer(); // Snapshots bound the ledger a restart has to replay
+
+    while (!serverStopRequested) {
+        // Build the poll set: the listener, the shards' wake pipe, then every client (asking
+        // for POLLOUT only when output is queued). Deadlines are the shards' business.
+        struct pollfd* pollSet = realloc(bidServer.pollSet, (bidServer.clientCount + 2) * sizeof(struct pollfd));
+        if (pollSet == NULL) break;
+        bidServer.pollSet = pollSet;
+        pollSet[0] = (struct pollfd){ bidServer.listenSocket, POLLIN, 0 };
+        pollSet[1] = (struct pollfd){ bidServer.wakePipe[0], POLLIN, 0 };
+        for (int i = 0; i < bidServer.clientCount; i++) {
+            NetConnection* client = &bidServer.clients[i].connection;
+            pollSet[i + 2] = (struct pollfd){ client->socket, (short)(POLLIN | (client->out.size > 0 ? POLLOUT : 0)), 0 };
+        }
+        int pollCount = bidServer.clientCount + 2;
+        if (poll(pollSet, pollCount, NET_POLL_TIMEOUT_MS) < 0) {
+            if (errno == EINTR) continue; // Interrupted by a signal, re-check the stop flag
+            break;
+        }
+
+        // Answer the bids the shards have finished and collect their closes
+        ApplyShardResults(&bidServer);
+
+        // Serve existing clients first; clients accepted below join the next pass
+        for (int i = 0; i < pollCount - 2; i++) {
+            NetConnection* client = &bidServer.clients[i].connection;
+            if (pollSet[i + 2].revents == 0 || client->socket < 0) continue;
+            bool alive = PumpConnection(client, (pollSet[i + 2].revents & (POLLIN | POLLHUP | POLLERR)) != 0);
+
+            int type, consumed = 0, used = 0; // The loop never runs for a client that is already gone
+            NetReader reader;
+            while (alive && (used = NextMessage(&client->in, &type, &reader, &consumed)) > 0) {
+                HandleServerMessage(&bidServer, i, type, &reader);
+            }
+            if (used < 0) alive = false; // Malformed frame
+            if (consumed > 0) {
+                memmove(client->in.data, client->in.data + consumed, client->in.size - consumed);
+                client->in.size -= consumed;
+            }
+            if (!alive) CloseServerClient(&bidServer.clients[i]);
+        }
+
+        // One wake-up per shard for all the bids it was handed this pass
+        for (int s = 0; s < bidServer.shardCount; s++) {
+            BidShard* shard = &bidServer.shards[s];
+            if (!shard->wakePending) continue;
+            shard->wakePending = false;
+            pthread_mutex_lock(&shard->lock);
+            pthread_cond_signal(&shard->wake);
+            pthread_mutex_unlock(&shard->lock);
+        }
+
+        // One batch of updates per pass, however many bids arrived in it
+        if (bidServer.dirtyCount > 0) FlushItemUpdates(&bidServer);
+
+        // Push queued responses and updates right away instead of waiting for the next poll
+        for (int i = 0; i < bidServer.clientCount; i++) {
+            NetConnection* client = &bidServer.clients[i].connection;
+            if (client->socket >= 0 && client->out.size > 0 && !PumpConnection(client, false)) CloseServerClient(&bidServer.clients[i]);
+            if (client->out.size > NET_MAX_OUTPUT) {
+                TraceLog(LOG_WARNING, "Dropping a client that stopped reading.");
+                CloseServerClient(&bidServer.clients[i]);
+            }
+        }
+
+        // Compact the client array, dropping closed connections (the order, and so the id order, is kept)
+        int kept = 0;
+        for (int i = 0; i < bidServer.clientCount; i++) {
+            if (bidServer.clients[i].connection.socket >= 0) {
+                if (kept != i) bidServer.clients[kept] = bidServer.clients[i];
+                kept++;
+            }
+        }
+        bidServer.clientCount = kept;
+
+        // Accept new clients; they receive item state as they subscribe
+        if (pollSet[0].revents & POLLIN) {
+            int socketFd;
+            while ((socketFd = accept(bidServer.listenSocket, NULL, NULL)) >= 0) {
+                if (!MakeNonBlocking(socketFd)) {
+                    close(socketFd);
+                    continue;
+                }
+                if (bidServer.clientCount == bidServer.clientCapacity) {
+                    int newCapacity = (bidServer.clientCapacity > 0) ? bidServer.clientCapacity * 2 : 16;
+                    ServerClient* grown = realloc(bidServer.clients, newCapacity * sizeof(ServerClient));
+                    if (grown == NULL) {
+                        close(socketFd);
+                        continue;
+                    }
+                    bidServer.clients = grown;
+                    bidServer.clientCapacity = newCapacity;
+                }
+                ServerClient* client = &bidServer.clients[bidServer.clientCount++];
+                client->connection = (NetConnection){ socketFd, { 0 }, { 0 } };
+                client->subscriptionCount = 0;
+                client->sentBidders = NULL;
+                client->sentBidderWords = 0;
+                client->id = ++bidServer.nextClientId; // Never 0, which marks a close
+                TraceLog(LOG_INFO, "Client connected (%d total).", bidServer.clientCount);
+            }
+        }
+    }
+
+    TraceLog(LOG_INFO, "Auction server shutting down.");
+    StopShards(&bidServer); // Queued bids are applied and recorded; their answers are dropped with the clients
+    StopCheckpointer(); // Last snapshot, once no more bids can arrive
+    for (int i = 0; i < bidServer.clientCount; i++) CloseServerClient(&bidServer.clients[i]);
+    free(bidServer.clients);
+    free(bidServer.pollSet);
+    free(bidServer.dirtyItems);
+    free(bidServer.dirtyList);
+    close(bidServer.listenSocket);
+    bidServer = (BidServer){ .listenSocket = -1, .wakePipe = { -1, -1 } };
+    CloseBidLedger(); // Commit every accepted bid before exiting
+    FreeAuctionData();
+    return 0;
+}
+
+// HandleServerMessage: Server side of the protocol. Subscriptions are served here; bids are
+// queued for the shard that owns the item, which applies them through SubmitBid in the order
+// they arrived. Bids that cannot be routed are answered right away.
+void HandleServerMessage(BidServer* server, int clientIndex, int type, NetReader* reader) {
+    if (type == NET_MSG_SUBSCRIBE || type == NET_MSG_UNSUBSCRIBE) {
+        HandleSubscription(&server->clients[clientIndex], type, reader);
+        return;
+    }
+    if (type != NET_MSG_BID) return; // Unknown message from a newer client: ignore it
+
+    ShardMessage request = { 0 };
+    request.clientId = server->clients[clientIndex].id;
+    request.requestId = GetU32(reader);
+    uint32_t itemId = GetU32(reader);
+    request.amount = (int64_t)GetU64(reader); // Anything out of range is refused by SubmitBid
+    GetString(reader, request.bidder, sizeof(request.bidder));
+    if (!reader->ok) return; // Truncated message
+
+    BidStatus status = BID_UNKNOWN_ITEM;
+    if (itemId < (uint32_t)items.count) {
+        request.itemIndex = (int)itemId;
+        BidShard* shard = &server->shards[itemId % (uint32_t)server->shardCount];
+        if (ShardRingPush(&shard->requests, &request)) {
+            shard->wakePending = true;
+            return; // Answered when the shard's result comes back
+        }
+        status = BID_FAILED; // The shard is too far behind; the client may retry
+    }
+
+    NetBuffer* reply = &server->clients[clientIndex].connection.out;
+    int start = reply->size;
+    BeginMessage(reply, NET_MSG_BID_RESULT);
+    PutU32(reply, request.requestId);
+    PutU8(reply, (uint8_t)status);
+    PutU64(reply, (status == BID_FAILED) ? (uint64_t)GetCurrentBid((int)itemId) : 0);
+    EndMessage(reply, start);
+}
+
+// HandleSubscription: Adds the ids of a NET_MSG_SUBSCRIBE to the client's set (sending the
+// current state of each new item) or removes the ids of a NET_MSG_UNSUBSCRIBE. Unknown items,
+// duplicates and ids beyond NET_MAX_SUBSCRIPTIONS are ignored.
+void HandleSubscription(ServerClient* client, int type, NetReader* reader) {
+    while (reader->remaining >= 4) {
+        uint32_t itemId = GetU32(reader);
+        if (itemId >= (uint32_t)items.count) continue;
+        int count = client->subscriptionCount;
+        int low = 0, high = count; // Binary search for the first subscription >= itemId
+        while (low < high) {
+            int middle = (low + high) / 2;
+            if (client->subscriptions[middle] < itemId) low = middle + 1;
+            else high = middle;
+        }
+        int position = low;
+        bool present = position < count && client->subscriptions[position] == itemId;
+        if (type == NET_MSG_SUBSCRIBE && !present && count < NET_MAX_SUBSCRIPTIONS) {
+            memmove(&client->subscriptions[position + 1], &client->subscriptions[position], (count - position) * sizeof(uint32_t));
+            client->subscriptions[position] = itemId;
+            client->subscriptionCount++;
+            QueueItemState(client, (int)itemId);
+        } else if (type == NET_MSG_UNSUBSCRIBE && present) {
+            memmove(&client->subscriptions[position], &client->subscriptions[position + 1], (count - position - 1) * sizeof(uint32_t));
+            client->subscriptionCount--;
+        }
+    }
+}
+
+// MarkItemDirty: Notes that an item changed during this pass. Several bids on one item in the
+// same pass collapse into one update carrying the latest bid.
+void MarkItemDirty(BidServer* server, int itemIndex, uint8_t flags) {
+    if (server->dirtyItems[itemIndex] == 0) server->dirtyList[server->dirtyCount++] = itemIndex;
+    server->dirtyItems[itemIndex] |= flags;
+}
+
+// FlushItemUpdates: Sends the pass's changes to every client subscribed to them. With enough
+// clients the work is split into one slice per shard plus one for the network thread; shards
+// join the batch between bids, and whoever finishes early steals clients from the others. The
+// network thread returns once every shard is done, so nothing else touches the clients meanwhile.
+void FlushItemUpdates(BidServer* server) {
+    if (server->shardCount < 2 || server->clientCount < SERVER_PARALLEL_FLUSH_CLIENTS) {
+        for (int i = 0; i < server->clientCount; i++) FlushClientUpdates(server, &server->clients[i]);
+    } else {
+        int participants = server->shardCount + 1;
+        for (int p = 0; p < participants; p++) {
+            server->flushSlices[p].next = (int)((int64_t)server->clientCount * p / participants);
+            server->flushSlices[p].end = (int)((int64_t)server->clientCount * (p + 1) / participants);
+        }
+        pthread_mutex_lock(&server->flushLock);
+        server->flushPending = server->shardCount;
+        pthread_mutex_unlock(&server->flushLock);
+        __atomic_store_n(&server->flushGeneration, server->flushGeneration + 1, __ATOMIC_RELEASE); // Publishes the slices
+        for (int s = 0; s < server->shardCount; s++) {
+            pthread_mutex_lock(&server->shards[s].lock);
+            pthread_cond_signal(&server->shards[s].wake);
+            pthread_mutex_unlock(&server->shards[s].lock);
+        }
+
+        RunFlushSlices(server, server->shardCount);
+        pthread_mutex_lock(&server->flushLock);
+        while (server->flushPending > 0) pthread_cond_wait(&server->flushDone, &server->flushLock);
+        pthread_mutex_unlock(&server->flushLock);
+    }
+    for (int d = 0; d < server->dirtyCount; d++) server->dirtyItems[server->dirtyList[d]] = 0;
+    server->dirtyCount = 0;
+}
+
+// FlushClientUpdates: Queues the pass's changes one client follows: full state for closed or
+// extended items, otherwise NET_MSG_BID_DELTAS batches of [item][bid word]. Names of bidders
+// the client has not seen yet go first. Matching walks whichever of the client's subscriptions
+// and the dirty list is shorter, so during a busy close it costs at most NET_MAX_SUBSCRIPTIONS
+// lookups per client. Only touches 'client', so different clients can be flushed in parallel.
+void FlushClientUpdates(BidServer* server, ServerClient* client) {
+    if (client->connection.socket < 0 || client->subscriptionCount == 0) return;
+    NetBuffer* out = &client->connection.out;
+
+    int matches[NET_MAX_SUBSCRIPTIONS];
+    int matched = 0;
+    if (client->subscriptionCount < server->dirtyCount) {
+        for (int s = 0; s < client->subscriptionCount; s++) {
+            if (server->dirtyItems[client->subscriptions[s]] != 0) matches[matched++] = (int)client->subscriptions[s];
+        }
+    } else {
+        for (int d = 0; d < server->dirtyCount; d++) {
+            uint32_t itemId = (uint32_t)server->dirtyList[d];
+            if (bsearch(&itemId, client->subscriptions, client->subscriptionCount, sizeof(uint32_t), CompareItemIds) != NULL) {
+                matches[matched++] = (int)itemId;
+            }
+        }
+    }
+
+    // Full states and bidder names, so every delta below can be applied on arrival. Each bid
+    // word is loaded once: a bid landing in between must not send a bidder whose name was not.
+    uint64_t states[NET_MAX_SUBSCRIPTIONS];
+    int deltas = 0;
+    for (int m = 0; m < matched; m++) {
+        int itemIndex = matches[m];
+        if (server->dirtyItems[itemIndex] & ITEM_DIRTY_STATE) {
+            QueueItemState(client, itemIndex);
+            continue;
+        }
+        uint64_t bidState = LoadBidState(itemIndex);
+        if (QueueBidderName(client, BidBidder(bidState))) {
+            matches[deltas] = itemIndex;
+            states[deltas++] = bidState;
+        }
     }
 
-    fclose(file);
-    TraceLog(LOG_INFO, "Saved %d users to %s.", userCount, USERS_FILE);
+    for (int first = 0; first < deltas; first += NET_DELTAS_PER_MESSAGE) {
+        int start = out->size;
+        BeginMessage(out, NET_MSG_BID_DELTAS);
+        for (int m = first; m < deltas && m < first + NET_DELTAS_PER_MESSAGE; m++) {
+            PutU32(out, (uint32_t)matches[m]);
+            PutU64(out, states[m]); // Latest bid, even if several arrived this pass
+        }
+        EndMessage(out, start);
+    }
+}
+
+// RunFlushSlices: Flushes the clients of slice 'own' and then steals the unclaimed clients of
+// every other slice, so a participant that joined late or got heavy clients is helped out.
+void RunFlushSlices(BidServer* server, int own) {
+    int participants = server->shardCount + 1;
+    for (int k = 0; k < participants; k++) {
+        FlushSlice* slice = &server->flushSlices[(own + k) % participants];
+        int i;
+        while ((i = __atomic_fetch_add(&slice->next, 1, __ATOMIC_RELAXED)) < slice->end) {
+            FlushClientUpdates(server, &server->clients[i]);
+        }
+    }
+}
+
+// StartShards: Allocates 'shardCount' shards, their flush slices and the wake pipe. The
+// threads are started by RunShards once the shards' deadlines are scheduled.
+bool StartShards(BidServer* server, int shardCount) {
+    server->shards = calloc(shardCount, sizeof(BidShard));
+    server->flushSlices = calloc(shardCount + 1, sizeof(FlushSlice));
+    if (server->shards == NULL || server->flushSlices == NULL || pipe(server->wakePipe) != 0) return false;
+    fcntl(server->wakePipe[0], F_SETFL, fcntl(server->wakePipe[0], F_GETFL, 0) | O_NONBLOCK);
+    fcntl(server->wakePipe[1], F_SETFL, fcntl(server->wakePipe[1], F_GETFL, 0) | O_NONBLOCK); // A full pipe already means "wake up"
+    pthread_mutex_init(&server->flushLock, NULL);
+    pthread_cond_init(&server->flushDone, NULL);
+    for (int s = 0; s < shardCount; s++) {
+        BidShard* shard = &server->shards[s];
+        shard->index = s;
+        shard->running = true;
+        pthread_mutex_init(&shard->lock, NULL);
+        pthread_cond_init(&shard->wake, NULL);
+    }
+    server->shardCount = shardCount;
+    return true;
+}
+
+// RunShards: Starts one thread per shard. Returns false if any could not be started.
+bool RunShards(BidServer* server) {
+    for (int s = 0; s < server->shardCount; s++) {
+        BidShard* shard = &server->shards[s];
+        if (pthread_create(&shard->thread, NULL, ShardThread, shard) != 0) return false;
+        shard->started = true;
+    }
+    return true;
+}
+
+// StopShards: Asks every shard to stop, waits until each has applied the bids still queued
+// for it, then frees the shards. Safe to call after a partial StartShards.
+void StopShards(BidServer* server) {
+    for (int s = 0; s < server->shardCount; s++) {
+        BidShard* shard = &server->shards[s];
+        pthread_mutex_lock(&shard->lock);
+        __atomic_store_n(&shard->running, false, __ATOMIC_RELEASE); // Also read by PostShardResult without the lock
+        pthread_cond_signal(&shard->wake);
+        pthread_mutex_unlock(&shard->lock);
+    }
+    for (int s = 0; s < server->shardCount; s++) {
+        BidShard* shard = &server->shards[s];
+        if (shard->started) pthread_join(shard->thread, NULL);
+        pthread_cond_destroy(&shard->wake);
+        pthread_mutex_destroy(&shard->lock);
+        FreeCloseScheduler(&shard->scheduler);
+    }
+    if (server->shardCount > 0) {
+        pthread_cond_destroy(&server->flushDone);
+        pthread_mutex_destroy(&server->flushLock);
+    }
+    if (server->wakePipe[0] >= 0) close(server->wakePipe[0]);
+    if (server->wakePipe[1] >= 0) close(server->wakePipe[1]);
+    free(server->shards);
+    free(server->flushSlices);
+    server->shards = NULL;
+    server->flushSlices = NULL;
+    server->shardCount = 0;
+    server->wakePipe[0] = server->wakePipe[1] = -1;
+}
+
+// ShardThread: Closes the shard's auctions as they come due and applies its bids one at a
+// time in arrival order, joining flush batches in between. Sleeps until the next deadline
+// when there is nothing to do.
+void* ShardThread(void* arg) {
+    BidShard* shard = arg;
+    BidServer* server = &bidServer;
+    for (;;) {
+        bool posted = false;
+        int closedIndex;
+        while ((closedIndex = CloseNextDueAuction(&shard->scheduler, WallClockMs())) >= 0) {
+            ShardMessage closed = { .itemIndex = closedIndex, .dirty = ITEM_DIRTY_STATE };
+            PostShardResult(server, shard, &closed);
+            posted = true;
+        }
+
+        ShardMessage request;
+        while (ShardRingPop(&shard->requests, &request)) {
+            ProcessShardRequest(shard, &request);
+            posted = true;
+            JoinFlushBatch(server, shard); // Keeps a long queue from holding up the pass's updates
+        }
+        if (posted) WakeNetworkThread(server);
+        JoinFlushBatch(server, shard);
+
+        // Nothing queued: sleep until a request, a flush batch, shutdown or the next deadline
+        pthread_mutex_lock(&shard->lock);
+        while (shard->running && __atomic_load_n(&shard->requests.tail, __ATOMIC_ACQUIRE) == shard->requests.head &&
+               __atomic_load_n(&server->flushGeneration, __ATOMIC_ACQUIRE) == shard->flushGeneration) {
+            int64_t nextClose = NextCloseDeadline(&shard->scheduler);
+            if (nextClose == 0) {
+                pthread_cond_wait(&shard->wake, &shard->lock);
+            } else {
+                if (WallClockMs() >= nextClose) break;
+                struct timespec until = { (time_t)(nextClose / 1000), (long)(nextClose % 1000) * 1000000L }; // Deadlines are CLOCK_REALTIME, like the wait
+                pthread_cond_timedwait(&shard->wake, &shard->lock, &until);
+            }
+        }
+        bool stop = !shard->running && __atomic_load_n(&shard->requests.tail, __ATOMIC_ACQUIRE) == shard->requests.head;
+        pthread_mutex_unlock(&shard->lock);
+        if (stop) break;
+    }
+    return NULL;
+}
+
+// ProcessShardRequest: Applies one bid with SubmitBid and posts its outcome. Only the item's
+// shard gets here, so no other bid on the item can slip in between.
+void ProcessShardRequest(BidShard* shard, const ShardMessage* request) {
+    int64_t endTime = LoadEndTime(request->itemIndex);
+    BidStatus status = SubmitBid(request->itemIndex, request->amount, request->bidder);
+
+    ShardMessage result = *request;
+    result.status = (uint8_t)status;
+    result.amount = GetCurrentBid(request->itemIndex);
+    result.dirty = 0;
+    if (status == BID_ACCEPTED) {
+        bool extended = LoadEndTime(request->itemIndex) != endTime; // Anti-sniping moved the deadline, which a delta does not carry
+        result.dirty = extended ? ITEM_DIRTY_STATE : ITEM_DIRTY_BID;
+    }
+    PostShardResult(&bidServer, shard, &result);
+}
+
+// PostShardResult: Queues a result for the network thread. If the ring is full the shard
+// wakes the network thread and waits for room, joining any flush batch the network thread may
+// be waiting on meanwhile. Results are dropped once the server is stopping.
+void PostShardResult(BidServer* server, BidShard* shard, const ShardMessage* result) {
+    while (!ShardRingPush(&shard->results, result)) {
+        if (!__atomic_load_n(&shard->running, __ATOMIC_ACQUIRE)) return;
+        WakeNetworkThread(server);
+        JoinFlushBatch(server, shard);
+        struct timespec delay = { 0, 1000000L };
+        nanosleep(&delay, NULL);
+    }
+}
+
+// JoinFlushBatch: Takes part in the current flush batch if this shard has not yet, and tells
+// the network thread when the last shard is done.
+void JoinFlushBatch(BidServer* server, BidShard* shard) {
+    uint32_t generation = __atomic_load_n(&server->flushGeneration, __ATOMIC_ACQUIRE);
+    if (generation == shard->flushGeneration) return;
+    shard->flushGeneration = generation;
+    RunFlushSlices(server, shard->index);
+    pthread_mutex_lock(&server->flushLock);
+    if (--server->flushPending == 0) pthread_cond_signal(&server->flushDone);
+    pthread_mutex_unlock(&server->flushLock);
+}
+
+// WakeNetworkThread: Writes a byte to the wake pipe so poll() returns and results are applied.
+void WakeNetworkThread(BidServer* server) {
+    char byte = 1;
+    ssize_t written = write(server->wakePipe[1], &byte, 1); // EAGAIN: the pipe is full, so a wake-up is already pending
+    (void)written;
+}
+
+// ApplyShardResults: Drains the wake pipe and every shard's result ring: answers each bid to
+// the client that sent it (if it is still connected) and marks changed items for the pass's
+// update batch. Runs on the network thread.
+void ApplyShardResults(BidServer* server) {
+    char drain[64];
+    while (read(server->wakePipe[0], drain, sizeof(drain)) > 0) {}
+
+    for (int s = 0; s < server->shardCount; s++) {
+        ShardMessage result;
+        while (ShardRingPop(&server->shards[s].results, &result)) {
+            if (result.dirty != 0) MarkItemDirty(server, result.itemIndex, result.dirty);
+            ServerClient* client = (result.clientId != 0) ? FindServerClient(server, result.clientId) : NULL;
+            if (client == NULL) continue; // A close, or the client has gone
+
+            NetBuffer* reply = &client->connection.out;
+            int start = reply->size;
+            BeginMessage(reply, NET_MSG_BID_RESULT);
+            PutU32(reply, result.requestId);
+            PutU8(reply, result.status);
+            PutU64(reply, (uint64_t)result.amount);
+            EndMessage(reply, start);
+        }
+    }
+}
+
+// FindServerClient: Binary search for a connected client by id. Ids are handed out in
+// increasing order and compaction keeps the order, so 'clients' stays sorted by id.
+ServerClient* FindServerClient(BidServer* server, uint32_t id) {
+    int low = 0, high = server->clientCount;
+    while (low < high) {
+        int middle = (low + high) / 2;
+        if (server->clients[middle].id < id) low = middle + 1;
+        else high = middle;
+    }
+    if (low == server->clientCount || server->clients[low].id != id || server->clients[low].connection.socket < 0) return NULL;
+    return &server->clients[low];
+}
+
+// ShardRingPush: Producer side. The slot is filled before 'tail' is published.
+bool ShardRingPush(ShardRing* ring, const ShardMessage* message) {
+    uint32_t tail = ring->tail; // Only this side writes 'tail'
+    if (tail - __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE) == SHARD_QUEUE_CAPACITY) return false; // Full
+    ring->slots[tail & (SHARD_QUEUE_CAPACITY - 1)] = *message;
+    __atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+// ShardRingPop: Consumer side. The slot is copied out before 'head' releases it to the producer.
+bool ShardRingPop(ShardRing* ring, ShardMessage* message) {
+    uint32_t head = ring->head; // Only this side writes 'head'
+    if (__atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE) == head) return false; // Empty
+    *message = ring->slots[head & (SHARD_QUEUE_CAPACITY - 1)];
+    __atomic_store_n(&ring->head, head + 1, __ATOMIC_RELEASE);
     return true;
 }
 
-// RegisterUser: Adds a new user to the system.
-bool RegisterUser(const char* username, const char* password) {
-    if (userCount >= MAX_USERS) {
-        SetUIMessage("Cannot register: maximum user limit reached.");
+// QueueBidderName: Makes sure the client knows the name behind a server bidder id, sending a
+// NET_MSG_BIDDER the first time. Returns false if the name could not be tracked.
+bool QueueBidderName(ServerClient* client, uint32_t bidderId) {
+    int word = (int)(bidderId / 32);
+    if (word >= client->sentBidderWords) {
+        int words = client->sentBidderWords > 0 ? client->sentBidderWords : 8;
+        while (words <= word) words *= 2;
+        uint32_t* grown = realloc(client->sentBidders, words * sizeof(uint32_t));
+        if (grown == NULL) return false;
+        memset(grown + client->sentBidderWords, 0, (words - client->sentBidderWords) * sizeof(uint32_t));
+        client->sentBidders = grown;
+        client->sentBidderWords = words;
+    }
+    uint32_t bit = 1u << (bidderId % 32);
+    if (client->sentBidders[word] & bit) return true;
+    NetBuffer* out = &client->connection.out;
+    int start = out->size;
+    BeginMessage(out, NET_MSG_BIDDER);
+    PutU32(out, bidderId);
+    PutString(out, GetBidderName(bidderId), MAX_BIDDER_LENGTH - 1);
+    EndMessage(out, start);
+    client->sentBidders[word] |= bit;
+    return true;
+}
+
+// CloseServerClient: Closes a client's connection and releases what the server kept for it.
+void CloseServerClient(ServerClient* client) {
+    CloseConnection(&client->connection);
+    free(client->sentBidders);
+    client->sentBidders = NULL;
+    client->sentBidderWords = 0;
+    client->subscriptionCount = 0;
+}
+
+// ConnectToServer: Opens the link to a bid server. 'address' is host or host:port.
+bool ConnectToServer(const char* address) {
+    char host[256];
+    const char* port = DEFAULT_SERVER_PORT;
+    strncpy(host, address, sizeof(host) - 1);
+    host[sizeof(host) - 1] = '\0';
+    char* colon = strrchr(host, ':');
+    if (colon != NULL && strchr(host, ':') == colon) { // Exactly one colon: host:port (not a bare IPv6 address)
+        *colon = '\0';
+        port = colon + 1;
+    }
+
+    struct addrinfo hints = { 0 };
+    struct addrinfo* results = NULL;
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    if (getaddrinfo(host, port, &hints, &results) != 0) return false;
+
+    int socketFd = -1;
+    for (struct addrinfo* candidate = results; candidate != NULL; candidate = candidate->ai_next) {
+        socketFd = socket(candidate->ai_family, candidate->ai_socktype, candidate->ai_protocol);
+        if (socketFd < 0) continue;
+        if (connect(socketFd, candidate->ai_addr, candidate->ai_addrlen) == 0) break; // Blocking connect, once at startup
+        close(socketFd);
+        socketFd = -1;
+    }
+    freeaddrinfo(results);
+    if (socketFd < 0 || !MakeNonBlocking(socketFd)) {
+        if (socketFd >= 0) close(socketFd);
         return false;
     }
-    if (UsernameExists(username)) {
-        // This check should ideally be done before calling RegisterUser
-        // but included here for robustness.
-        SetUIMessage("Registration failed: Username already exists.");
+
+    netClient.connection = (NetConnection){ socketFd, { 0 }, { 0 } };
+    netClient.connected = true;
+    netClient.nextRequestId = 1;
+    netClient.subscriptionCount = 0; // The first frame subscribes to what is on screen
+    TraceLog(LOG_INFO, "Connected to auction server %s:%s.", host, port);
+    return true;
+}
+
+// PollNetClient: Called once per frame. Never blocks: it sends what is queued, reads what
+// has arrived and applies every complete message.
+void PollNetClient() {
+    NetConnection* connection = &netClient.connection;
+    bool alive = PumpConnection(connection, true);
+
+    int type, consumed = 0, used;
+    NetReader reader;
+    while ((used = NextMessage(&connection->in, &type, &reader, &consumed)) > 0) {
+        HandleClientMessage(type, &reader);
+    }
+    if (used < 0) alive = false; // Malformed frame
+    if (consumed > 0) {
+        memmove(connection->in.data, connection->in.data + consumed, connection->in.size - consumed);
+        connection->in.size -= consumed;
+    }
+
+    if (!alive) {
+        DisconnectFromServer();
+        SetUIMessage("Lost connection to the auction server.");
+    }
+}
+
+// HandleClientMessage: Client side of the protocol. Item state from the server overrides the
+// local copy; results of our own bids become UI messages.
+void HandleClientMessage(int type, NetReader* reader) {
+    switch (type) {
+        case NET_MSG_ITEM_STATE: {
+            uint32_t itemId = GetU32(reader);
+            uint64_t bidState = GetU64(reader);
+            bool closed = GetU8(reader) != 0;
+            int64_t endTime = (int64_t)GetU64(reader);
+            if (!reader->ok || itemId >= (uint32_t)items.count) return; // Truncated, or not in our catalog
+            uint32_t bidderId = LocalBidderId(BidBidder(bidState));
+            if (bidderId == BIDDER_NONE) return; // Name never arrived
+            StoreBidState((int)itemId, PackBid(BidAmount(bidState), bidderId)); // The server already decided this bid
+            items.auctionClosed[itemId] = closed; // Closes come from the server's scheduler
+            StoreEndTime((int)itemId, endTime);
+            InvalidateItemRender((int)itemId); // Also schedules a repaint
+        } break;
+
+        case NET_MSG_BIDDER: {
+            uint32_t serverId = GetU32(reader);
+            char bidder[MAX_BIDDER_LENGTH];
+            GetString(reader, bidder, sizeof(bidder));
+            if (!reader->ok || serverId >= (1u << BID_BIDDER_BITS)) return;
+            if (serverId >= netClient.bidderIdCount) {
+                uint32_t count = netClient.bidderIdCount > 0 ? netClient.bidderIdCount : 64;
+                while (count <= serverId) count *= 2;
+                uint32_t* grown = realloc(netClient.bidderIds, count * sizeof(uint32_t));
+                if (grown == NULL) return; // Deltas from this bidder are skipped
+                for (uint32_t i = netClient.bidderIdCount; i < count; i++) grown[i] = BIDDER_NONE;
+                netClient.bidderIds = grown;
+                netClient.bidderIdCount = count;
+            }
+            netClient.bidderIds[serverId] = InternBidder(bidder);
+        } break;
+
+        case NET_MSG_BID_DELTAS: {
+            while (reader->remaining >= NET_DELTA_SIZE) {
+                uint32_t itemId = GetU32(reader);
+                uint64_t bidState = GetU64(reader);
+                uint32_t bidderId = LocalBidderId(BidBidder(bidState));
+                if (itemId >= (uint32_t)items.count || bidderId == BIDDER_NONE) continue; // Not in our catalog, or name never arrived
+                StoreBidState((int)itemId, PackBid(BidAmount(bidState), bidderId)); // Same amount, our id for the name
+                InvalidateItemRender((int)itemId); // Also schedules a repaint
+            }
+        } break;
+
+        case NET_MSG_BID_RESULT: {
+            GetU32(reader); // Request id (results for bids on different items can arrive out of order)
+            BidStatus status = (BidStatus)GetU8(reader);
+            int64_t currentBid = (int64_t)GetU64(reader);
+            if (!reader->ok) return;
+            SetUIMessage(BidStatusMessage(status, currentBid, currentBid));
+        } break;
+
+        default: break; // Unknown message from a newer server: skip it
+    }
+}
+
+// LocalBidderId: Our id for the name behind a server bidder id, BIDDER_NONE if the server has
+// not named it yet.
+uint32_t LocalBidderId(uint32_t serverId) {
+    return (serverId < netClient.bidderIdCount) ? netClient.bidderIds[serverId] : BIDDER_NONE;
+}
+
+// SendBid: Queues a bid for the server; PollNetClient sends it.
+void SendBid(int itemIndex, int64_t amount, const char* bidder) {
+    NetBuffer* out = &netClient.connection.out;
+    int start = out->size;
+    BeginMessage(out, NET_MSG_BID);
+    PutU32(out, netClient.nextRequestId++);
+    PutU32(out, (uint32_t)itemIndex);
+    PutU64(out, (uint64_t)amount);
+    PutString(out, bidder, MAX_BIDDER_LENGTH - 1);
+    EndMessage(out, start);
+    PumpConnection(&netClient.connection, false); // Try to send right away
+}
+
+// UpdateSubscriptions: Compares the items now on screen ('ids', ascending) with the set the
+// server already sends updates for, and queues only the difference. Scrolling by one row costs
+// one subscribe and one unsubscribe.
+void UpdateSubscriptions(const uint32_t* ids, int count) {
+    uint32_t added[NET_MAX_SUBSCRIPTIONS], removed[NET_MAX_SUBSCRIPTIONS];
+    int addedCount = 0, removedCount = 0;
+    int i = 0, j = 0;
+    while (i < count || j < netClient.subscriptionCount) {
+        if (j == netClient.subscriptionCount || (i < count && ids[i] < netClient.subscriptions[j])) {
+            added[addedCount++] = ids[i++];
+        } else if (i == count || netClient.subscriptions[j] < ids[i]) {
+            removed[removedCount++] = netClient.subscriptions[j++];
+        } else {
+            i++;
+            j++;
+        }
+    }
+    if (addedCount == 0 && removedCount == 0) return;
+    SendItemIds(NET_MSG_UNSUBSCRIBE, removed, removedCount);
+    SendItemIds(NET_MSG_SUBSCRIBE, added, addedCount);
+    memcpy(netClient.subscriptions, ids, count * sizeof(uint32_t));
+    netClient.subscriptionCount = count;
+}
+
+// SendItemIds: Queues item ids as messages of 'type', NET_IDS_PER_MESSAGE ids each.
+void SendItemIds(int type, const uint32_t* ids, int count) {
+    NetBuffer* out = &netClient.connection.out;
+    for (int first = 0; first < count; first += NET_IDS_PER_MESSAGE) {
+        int start = out->size;
+        BeginMessage(out, type);
+        for (int i = first; i < count && i < first + NET_IDS_PER_MESSAGE; i++) PutU32(out, ids[i]);
+        EndMessage(out, start);
+    }
+}
+
+// DisconnectFromServer: Drops the server link; the UI keeps the last known item state.
+void DisconnectFromServer() {
+    if (!netClient.connected) return;
+    CloseConnection(&netClient.connection);
+    netClient.connected = false;
+    netClient.subscriptionCount = 0;
+    free(netClient.bidderIds); // Server bidder ids mean nothing to another connection
+    netClient.bidderIds = NULL;
+    netClient.bidderIdCount = 0;
+}
+
+// PumpConnection: Writes as much queued output as the socket takes and, if 'canRead', reads
+// everything available. Returns false if the peer closed the connection or an error occurred.
+bool PumpConnection(NetConnection* connection, bool canRead) {
+    if (connection->socket < 0) return false;
+
+    // Send queued output
+    int sent = 0;
+    while (sent < connection->out.size) {
+        ssize_t written = send(connection->socket, connection->out.data + sent, connection->out.size - sent, 0);
+        if (written > 0) {
+            sent += (int)written;
+        } else if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // Socket buffer full, try again later
+        } else if (written < 0 && errno == EINTR) {
+            continue;
+        } else {
+            return false;
+        }
+    }
+    if (sent > 0) {
+        memmove(connection->out.data, connection->out.data + sent, connection->out.size - sent);
+        connection->out.size -= sent;
+    }
+
+    // Receive everything that has arrived
+    while (canRead) {
+        if (!ReserveNetBuffer(&connection->in, 4096)) return false;
+        ssize_t received = recv(connection->socket, connection->in.data + connection->in.size, connection->in.capacity - connection->in.size, 0);
+        if (received > 0) {
+            connection->in.size += (int)received;
+        } else if (received == 0) {
+            return false; // Orderly shutdown by the peer
+        } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+            break; // Nothing more for now
+        } else if (errno != EINTR) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// CloseConnection: Closes the socket and releases both queues.
+void CloseConnection(NetConnection* connection) {
+    if (connection->socket >= 0) close(connection->socket);
+    free(connection->in.data);
+    free(connection->out.data);
+    *connection = (NetConnection){ -1, { 0 }, { 0 } };
+}
+
+#else // _WIN32: winsock cannot be included next to raylib.h, so networking is not available
+
+int RunBidServer(const char* port, int shardCount) {
+    (void)port;
+    (void)shardCount;
+    TraceLog(LOG_ERROR, "Server mode is not supported on this platform.");
+    return 1;
+}
+bool ConnectToServer(const char* address) { (void)address; return false; }
+void PollNetClient() {}
+void SendBid(int itemIndex, int64_t amount, const char* bidder) { (void)itemIndex; (void)amount; (void)bidder; }
+void UpdateSubscriptions(const uint32_t* ids, int count) { (void)ids; (void)count; }
+void DisconnectFromServer() {}
+
+#endif
+
+// NextMessage: If 'in' holds a complete message after the first '*consumed' bytes, sets 'type'
+// and 'reader' to it, advances '*consumed' past it and returns 1. Returns 0 if more bytes are
+// needed and -1 if the frame is malformed.
+int NextMessage(NetBuffer* in, int* type, NetReader* reader, int* consumed) {
+    int available = in->size - *consumed;
+    if (available < 2) return 0; // Need the length and type bytes
+    const unsigned char* frame = in->data + *consumed;
+    int payloadLength = frame[0];
+    if (available < 2 + payloadLength) return 0;
+    if (frame[1] == 0) return -1; // Type 0 is never sent
+
+    *type = frame[1];
+    *reader = (NetReader){ frame + 2, payloadLength, true };
+    *consumed += 2 + payloadLength;
+    return 1;
+}
+
+// BeginMessage: Writes a frame header with a placeholder length; EndMessage fills it in.
+void BeginMessage(NetBuffer* out, int type) {
+    PutU8(out, 0);
+    PutU8(out, (uint8_t)type);
+}
+
+// EndMessage: Stores the payload length of the message that starts at byte 'start'.
+void EndMessage(NetBuffer* out, int start) {
+    if (out->size <= start) return; // Allocation failed while building the message
+    out->data[start] = (uint8_t)(out->size - start - 2);
+}
+
+// PutU8: Appends one byte (dropped if memory runs out; the connection is then unusable anyway).
+void PutU8(NetBuffer* out, uint8_t value) {
+    if (!ReserveNetBuffer(out, 1)) return;
+    out->data[out->size++] = value;
+}
+
+// PutU32: Appends a u32 in little-endian order.
+void PutU32(NetBuffer* out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) PutU8(out, (uint8_t)(value >> shift));
+}
+
+// PutU64: Appends a u64 in little-endian order.
+void PutU64(NetBuffer* out, uint64_t value) {
+    PutU32(out, (uint32_t)value);
+    PutU32(out, (uint32_t)(value >> 32));
+}
+
+// PutString: Appends a string of at most 'maxLength' bytes as [u8 length][bytes].
+void PutString(NetBuffer* out, const char* text, int maxLength) {
+    int length = (int)strlen(text);
+    if (length > maxLength) length = maxLength;
+    PutU8(out, (uint8_t)length);
+    for (int i = 0; i < length; i++) PutU8(out, (uint8_t)text[i]);
+}
+
+// GetU8: Reads one byte, or returns 0 and clears 'ok' past the end of the payload.
+uint8_t GetU8(NetReader* reader) {
+    if (reader->remaining < 1) {
+        reader->ok = false;
+        return 0;
+    }
+    reader->remaining--;
+    return *reader->data++;
+}
+
+// GetU32: Reads a little-endian u32.
+uint32_t GetU32(NetReader* reader) {
+    uint32_t value = 0;
+    for (int shift = 0; shift < 32; shift += 8) value |= (uint32_t)GetU8(reader) << shift;
+    return value;
+}
+
+// GetU64: Reads a little-endian u64.
+uint64_t GetU64(NetReader* reader) {
+    uint64_t low = GetU32(reader);
+    return low | ((uint64_t)GetU32(reader) << 32);
+}
+
+// GetString: Reads a string sent by PutString, truncating it to fit 'capacity'.
+void GetString(NetReader* reader, char* text, int capacity) {
+    int length = GetU8(reader);
+    int stored = 0;
+    for (int i = 0; i < length; i++) {
+        uint8_t c = GetU8(reader);
+        if (stored < capacity - 1) text[stored++] = (char)c;
+    }
+    text[stored] = '\0';
+}
+
+// CompareItemIds: Orders item ids ascending (subscription sets are kept sorted).
+int CompareItemIds(const void* a, const void* b) {
+    uint32_t left = *(const uint32_t*)a, right = *(const uint32_t*)b;
+    return (left > right) - (left < right);
+}
+
+// ReserveNetBuffer: Grows 'buffer' so at least 'extra' more bytes fit.
+bool ReserveNetBuffer(NetBuffer* buffer, int extra) {
+    if (buffer->size + extra <= buffer->capacity) return true;
+    int newCapacity = (buffer->capacity > 0) ? buffer->capacity : 4096;
+    while (newCapacity < buffer->size + extra) newCapacity *= 2;
+    unsigned char* grown = realloc(buffer->data, newCapacity);
+    if (grown == NULL) return false;
+    buffer->data = grown;
+    buffer->capacity = newCapacity;
+    return true;
+}
+
+// --- Benchmark Function Implementations ---
+// --bench drives the auction core with synthetic load and prints throughput and latency
+// percentiles for each operation. It opens no window, so it also runs in AUCTION_HEADLESS builds
+// and on machines without a GPU. Every run starts from empty files in BENCH_DIRECTORY.
+
+// RunBenchmark: --bench [users] [items] [threads]. Measures a directory of 'users' accounts,
+// sign-ups and sign-ins through the I/O worker, a store of 'items' items and bursts of bids from
+// 'threads' threads at once. Returns 0, or 1 if the arguments are invalid or a step failed.
+int RunBenchmark(int argc, char** argv) {
+    int userTotal = (argc > 0) ? atoi(argv[0]) : BENCH_DEFAULT_USERS;
+    int itemTotal = (argc > 1) ? atoi(argv[1]) : BENCH_DEFAULT_ITEMS;
+    int threadCount = (argc > 2) ? atoi(argv[2]) : BENCH_DEFAULT_THREADS;
+    if (userTotal < 1 || itemTotal < BENCH_HOT_ITEMS || threadCount < 1 || threadCount > BENCH_MAX_THREADS) {
+        TraceLog(LOG_ERROR, "Usage: --bench [users >= 1] [items >= %d] [threads 1-%d]", BENCH_HOT_ITEMS, BENCH_MAX_THREADS);
+        return 1;
+    }
+
+    mkdir(BENCH_DIRECTORY, 0755); // Fails harmlessly if it already exists
+    if (chdir(BENCH_DIRECTORY) != 0) {
+        TraceLog(LOG_ERROR, "Unable to enter %s.", BENCH_DIRECTORY);
+        return 1;
+    }
+    const char* staleFiles[] = { USERS_FILE, USERS_TEMP_FILE, USERS_LOG_FILE, USERS_DB_FILE, USERS_DB_TEMP_FILE, BID_LEDGER_FILE };
+    for (int i = 0; i < (int)(sizeof(staleFiles) / sizeof(staleFiles[0])); i++) remove(staleFiles[i]); // Results must not depend on earlier runs
+    SetTraceLogLevel(LOG_WARNING); // One info line per bid would dominate the timings
+
+    printf("Benchmark: %d users, %d items, %d bid threads x %d bids\n", userTotal, itemTotal, threadCount, BENCH_BIDS_PER_THREAD);
+    printf("%-18s %9s %12s %10s %10s %10s %10s\n", "operation", "ops", "ops/sec", "p50 us", "p90 us", "p99 us", "max us");
+    bool ok = BenchUserDirectory(userTotal) && BenchUserRequests() && BenchItems(itemTotal) && BenchBids(itemTotal, threadCount);
+
+    CloseUserLog();
+    FreeUsers();
+    FreeSessions();
+    FreeAuctionData();
+    if (!ok) TraceLog(LOG_ERROR, "Benchmark aborted.");
+    return ok ? 0 : 1;
+}
+
+// BenchUserDirectory: Fills the directory with 'userTotal' accounts that share one real scrypt
+// hash (hashing each would only measure scrypt), looks every one up, then times full snapshot
+// writes and reloads.
+bool BenchUserDirectory(int userTotal) {
+    PasswordHash hash;
+    int sampleCount = (userTotal > BENCH_FILE_ROUNDS) ? userTotal : BENCH_FILE_ROUNDS;
+    double* samples = malloc(sampleCount * sizeof(double));
+    if (samples == NULL || !HashPassword("bench-password", &hash)) {
+        free(samples);
         return false;
     }
 
-    // Add new user
-    strcpy(users[userCount].username, username);
-    users[userCount].hashedPassword = HashPassword(password);
-    userCount++;
+    bool ok = true;
+    char name[MAX_NAME_LENGTH];
+    double start = ProfilerClock();
+    for (int i = 0; i < userTotal && ok; i++) {
+        snprintf(name, sizeof(name), "bench-user-%d", i);
+        double opStart = ProfilerClock();
+        ok = AddUser(name, &hash);
+        samples[i] = ProfilerClock() - opStart;
+    }
+    if (ok) ReportBench("AddUser", samples, userTotal, ProfilerClock() - start);
+
+    start = ProfilerClock();
+    for (int i = 0; i < userTotal && ok; i++) {
+        snprintf(name, sizeof(name), "bench-user-%d", (int)(((long long)i * 7919) % userTotal)); // Scattered order
+        double opStart = ProfilerClock();
+        ok = FindUser(name) >= 0;
+        samples[i] = ProfilerClock() - opStart;
+    }
+    if (ok) ReportBench("FindUser", samples, userTotal, ProfilerClock() - start);
+
+    start = ProfilerClock();
+    for (int round = 0; round < BENCH_FILE_ROUNDS && ok; round++) {
+        double opStart = ProfilerClock();
+        ok = SaveUsers();
+        samples[round] = ProfilerClock() - opStart;
+    }
+    if (ok) ReportBench("SaveUsers", samples, BENCH_FILE_ROUNDS, ProfilerClock() - start);
+
+    start = ProfilerClock();
+    for (int round = 0; round < BENCH_FILE_ROUNDS && ok; round++) {
+        double opStart = ProfilerClock();
+        ok = LoadUsers() && userCount == userTotal;
+        samples[round] = ProfilerClock() - opStart;
+    }
+    if (ok) ReportBench("LoadUsers", samples, BENCH_FILE_ROUNDS, ProfilerClock() - start);
+
+    free(samples);
+    return ok;
+}
+
+// BenchUserRequests: Times RegisterUser and AuthenticateUser from the call until PollIoResults
+// applies the answer, the latency a user waits for on the sign-up and sign-in screens, and a
+// second sign-in that the credential cache answers.
+bool BenchUserRequests() {
+    double samples[BENCH_AUTH_SAMPLES];
+    char name[MAX_NAME_LENGTH];
+    bool ok = true;
+    StartIoWorker();
+
+    double start = ProfilerClock();
+    for (int i = 0; i < BENCH_AUTH_SAMPLES && ok; i++) {
+        snprintf(name, sizeof(name), "bench-login-%d", i);
+        double opStart = ProfilerClock();
+        ok = RegisterUser(name, "bench-password") == USER_REQUEST_PENDING;
+        if (ok) WaitForUserRequest();
+        samples[i] = ProfilerClock() - opStart;
+        ok = ok && UsernameExists(name);
+    }
+    if (ok) ReportBench("RegisterUser", samples, BENCH_AUTH_SAMPLES, ProfilerClock() - start);
+
+    start = ProfilerClock();
+    for (int i = 0; i < BENCH_AUTH_SAMPLES && ok; i++) {
+        snprintf(name, sizeof(name), "bench-login-%d", i);
+        loggedInUserId = BIDDER_NONE;
+        double opStart = ProfilerClock();
+        ok = AuthenticateUser(name, "bench-password") == USER_REQUEST_PENDING;
+        if (ok) WaitForUserRequest();
+        samples[i] = ProfilerClock() - opStart;
+        ok = ok && loggedInUserId != BIDDER_NONE && strcmp(GetBidderName(loggedInUserId), name) == 0;
+    }
+    if (ok) ReportBench("AuthenticateUser", samples, BENCH_AUTH_SAMPLES, ProfilerClock() - start);
+
+    // Signing in again with the same password is answered by the credential cache
+    start = ProfilerClock();
+    for (int i = 0; i < BENCH_AUTH_SAMPLES && ok; i++) {
+        snprintf(name, sizeof(name), "bench-login-%d", i);
+        RevokeSession(&currentSession);
+        loggedInUserId = BIDDER_NONE;
+        double opStart = ProfilerClock();
+        ok = AuthenticateUser(name, "bench-password") == USER_REQUEST_DONE;
+        samples[i] = ProfilerClock() - opStart;
+        ok = ok && loggedInUserId != BIDDER_NONE && strcmp(GetBidderName(loggedInUserId), name) == 0 && FindSession(&currentSession) != NULL;
+    }
+    if (ok) ReportBench("CachedSignIn", samples, BENCH_AUTH_SAMPLES, ProfilerClock() - start);
+
+    StopIoWorker();
+    PollIoResults(); // Release what the finished jobs handed back
+    ResetFrameArena();
+    return ok;
+}
+
+// WaitForUserRequest: Spins on PollIoResults, as the UI loop would once per frame, until the
+// worker has answered the pending registration or sign-in.
+void WaitForUserRequest() {
+    while (userRequestPending) {
+        PollIoResults();
+        ResetFrameArena(); // Result messages are formatted into the arena; no frame resets it here
+    }
+}
+
+// BenchItems: Appends 'itemTotal' open items without deadlines to an empty store.
+bool BenchItems(int itemTotal) {
+    double* samples = malloc(itemTotal * sizeof(double));
+    if (samples == NULL) return false;
+    FreeAuctionData();
+
+    bool ok = true;
+    char name[MAX_NAME_LENGTH];
+    double start = ProfilerClock();
+    for (int i = 0; i < itemTotal && ok; i++) {
+        snprintf(name, sizeof(name), "Bench item %d", i);
+        double opStart = ProfilerClock();
+        ok = AddAuctionItem(name, "Synthetic item for --bench.", 100, "No Bids Yet", false, 0) == i;
+        samples[i] = ProfilerClock() - opStart;
+    }
+    if (ok) ReportBench("AddAuctionItem", samples, itemTotal, ProfilerClock() - start);
+    free(samples);
+    return ok;
+}
+
+// BenchBids: Starts 'threadCount' threads that submit bursts of bids at the same moment, with
+// the bid ledger recording every accepted bid, and reports their combined latencies.
+bool BenchBids(int itemTotal, int threadCount) {
+    BenchWorker workers[BENCH_MAX_THREADS] = { 0 };
+    int totalBids = threadCount * BENCH_BIDS_PER_THREAD;
+    double* samples = malloc((size_t)totalBids * sizeof(double));
+    if (samples == NULL) return false;
+    OpenBidLedger(1); // Accepted bids are queued for the ledger exactly as in a real session
+
+    __atomic_store_n(&benchStartFlag, 0, __ATOMIC_RELEASE);
+    int started = 0;
+    for (; started < threadCount; started++) {
+        BenchWorker* worker = &workers[started];
+        *worker = (BenchWorker){ .id = started, .itemCount = itemTotal, .bidCount = BENCH_BIDS_PER_THREAD, .seed = 0x9E3779B97F4A7C15ull * (started + 1) };
+        worker->latencies = samples + (size_t)started * BENCH_BIDS_PER_THREAD;
+        if (pthread_create(&worker->thread, NULL, BenchBidThread, worker) != 0) break;
+    }
+    double start = ProfilerClock();
+    __atomic_store_n(&benchStartFlag, 1, __ATOMIC_RELEASE); // Release every thread at once
+    int accepted = 0, outbid = 0, failed = 0;
+    for (int i = 0; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+        accepted += workers[i].accepted;
+        outbid += workers[i].outbid;
+        failed += workers[i].failed;
+    }
+    double seconds = ProfilerClock() - start;
+
+    bool ok = started == threadCount && failed == 0;
+    if (started == threadCount) {
+        ReportBench("SubmitBid", samples, totalBids, seconds);
+        printf("%-18s %9d accepted, %d outbid by a concurrent bid, %d failed\n", "", accepted, outbid, failed);
+    } else {
+        TraceLog(LOG_ERROR, "Unable to start %d bid threads.", threadCount);
+    }
+    CloseBidLedger();
+    free(samples);
+    return ok;
+}
+
+// BenchBidThread: Waits for the start signal, then bids in bursts of BENCH_BURST_SIZE on one
+// item: even bursts on a hot item shared with the other threads, odd ones on any item. Each
+// bid tops the price it just read, so losing a race shows up as BID_TOO_LOW.
+void* BenchBidThread(void* arg) {
+    BenchWorker* worker = (BenchWorker*)arg;
+    char names[BENCH_BIDDERS_PER_THREAD][MAX_BIDDER_LENGTH];
+    for (int i = 0; i < BENCH_BIDDERS_PER_THREAD; i++) snprintf(names[i], MAX_BIDDER_LENGTH, "bench-%d-%d", worker->id, i);
+    while (!__atomic_load_n(&benchStartFlag, __ATOMIC_ACQUIRE)) {} // Spin, so every thread starts together
+
+    int done = 0;
+    for (int burst = 0; done < worker->bidCount; burst++) {
+        int range = (burst % 2 == 0) ? BENCH_HOT_ITEMS : worker->itemCount;
+        int item = (int)(BenchRandom(&worker->seed) % (uint64_t)range);
+        for (int i = 0; i < BENCH_BURST_SIZE && done < worker->bidCount; i++, done++) {
+            uint64_t random = BenchRandom(&worker->seed);
+            int64_t amount = GetCurrentBid(item) + 1 + (int64_t)(random % 100); // Raise by up to a dollar
+            const char* bidder = names[(random >> 32) % BENCH_BIDDERS_PER_THREAD];
+            double opStart = ProfilerClock();
+            BidStatus status = SubmitBid(item, amount, bidder);
+            worker->latencies[done] = ProfilerClock() - opStart;
+            if (status == BID_ACCEPTED) worker->accepted++;
+            else if (status == BID_TOO_LOW) worker->outbid++;
+            else worker->failed++;
+        }
+    }
+    return NULL;
+}
+
+// ReportBench: Prints one result line: 'count' operations that took 'seconds' in total (wall
+// time, so concurrent operations overlap) and the percentiles of their individual latencies.
+void ReportBench(const char* name, double* samples, int count, double seconds) {
+    qsort(samples, count, sizeof(double), CompareDoubles);
+    double percentiles[3] = { 50.0, 90.0, 99.0 };
+    double values[3];
+    for (int i = 0; i < 3; i++) values[i] = samples[(int)(percentiles[i] / 100.0 * (count - 1) + 0.5)] * 1e6;
+    printf("%-18s %9d %12.0f %10.2f %10.2f %10.2f %10.2f\n", name, count, (seconds > 0.0) ? count / seconds : 0.0,
+           values[0], values[1], values[2], samples[count - 1] * 1e6);
+    fflush(stdout); // Show each line as soon as it is measured (the auth rows take a while)
+}
 
-    // Save users to file immediately after registration
-    return SaveUsers();
+// BenchRandom: xorshift64. Fast and per-thread, so the generator does not disturb the timings.
+uint64_t BenchRandom(uint64_t* state) {
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
 }
 
-// AuthenticateUser: Checks if provided username and password match a registered user.
-bool AuthenticateUser(const char* username, const char* password) {
-    unsigned int inputHash = HashPassword(password);
-    for (int i = 0; i < userCount; i++) {
-        if (strcmp(users[i].username, username) == 0 && users[i].hashedPassword == inputHash) {
-            return true; // Match found
+// CompareDoubles: qsort comparator for ascending doubles.
+int CompareDoubles(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// --- Password KDF Function Implementations ---
+// scrypt (RFC 7914) on top of a small SHA-256/HMAC/PBKDF2 implementation, so the app keeps
+// depending on nothing but raylib.
+
+// Scrypt: Derives 'keyLength' bytes from 'password' and 'salt'. Uses 128 * r * 2^logN bytes
+// of memory, which is what makes guessing expensive on parallel hardware.
+bool Scrypt(const char* password, const uint8_t* salt, int saltLength, int logN, int r, int p, uint8_t* key, int keyLength) {
+    size_t blockWords = 32 * (size_t)r; // One scrypt block is 128 * r bytes
+    size_t n = (size_t)1 << logN;
+    uint8_t* blocks = malloc(p * blockWords * sizeof(uint32_t));
+    uint32_t* x = malloc(blockWords * sizeof(uint32_t));
+    uint32_t* scratch = malloc(blockWords * sizeof(uint32_t));
+    uint32_t* v = malloc(n * blockWords * sizeof(uint32_t));
+    bool derived = blocks != NULL && x != NULL && scratch != NULL && v != NULL;
+
+    if (derived) {
+        const uint8_t* passwordBytes = (const uint8_t*)password;
+        size_t passwordLength = strlen(password);
+        Pbkdf2Sha256(passwordBytes, passwordLength, salt, saltLength, blocks, p * blockWords * sizeof(uint32_t));
+
+        for (int lane = 0; lane < p; lane++) {
+            uint8_t* block = blocks + lane * blockWords * sizeof(uint32_t);
+            for (size_t k = 0; k < blockWords; k++) { // Little-endian words
+                const uint8_t* b = block + 4 * k;
+                x[k] = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+            }
+
+            // ROMix: fill V sequentially, then read it back in a data-dependent order
+            for (size_t i = 0; i < n; i++) {
+                memcpy(v + i * blockWords, x, blockWords * sizeof(uint32_t));
+                ScryptBlockMix(x, scratch, r);
+            }
+            for (size_t i = 0; i < n; i++) {
+                size_t j = x[(2 * r - 1) * 16] & (n - 1); // Integerify
+                const uint32_t* vj = v + j * blockWords;
+                for (size_t k = 0; k < blockWords; k++) x[k] ^= vj[k];
+                ScryptBlockMix(x, scratch, r);
+            }
+
+            for (size_t k = 0; k < blockWords; k++) {
+                uint8_t* b = block + 4 * k;
+                b[0] = (uint8_t)x[k];
+                b[1] = (uint8_t)(x[k] >> 8);
+                b[2] = (uint8_t)(x[k] >> 16);
+                b[3] = (uint8_t)(x[k] >> 24);
+            }
         }
+        Pbkdf2Sha256(passwordBytes, passwordLength, blocks, p * blockWords * sizeof(uint32_t), key, keyLength);
+    } else {
+        TraceLog(LOG_WARNING, "Not enough memory to hash a password.");
     }
-    return false; // No match
+
+    if (blocks != NULL) SecureZero(blocks, p * blockWords * sizeof(uint32_t));
+    if (x != NULL) SecureZero(x, blockWords * sizeof(uint32_t));
+    if (v != NULL) SecureZero(v, n * blockWords * sizeof(uint32_t));
+    free(blocks);
+    free(x);
+    free(scratch);
+    free(v);
+    return derived;
 }
 
-// UsernameExists: Checks if a username is already taken.
-bool UsernameExists(const char* username) {
-    for (int i = 0; i < userCount; i++) {
-        if (strcmp(users[i].username, username) == 0) {
-            return true; // Username found
+// ScryptBlockMix: Mixes the 2r 64-byte sub-blocks of 'block' with Salsa20/8 and stores the
+// even outputs followed by the odd ones. 'scratch' holds one block.
+void ScryptBlockMix(uint32_t* block, uint32_t* scratch, int r) {
+    uint32_t state[16];
+    memcpy(state, block + (2 * r - 1) * 16, sizeof(state));
+    for (int i = 0; i < 2 * r; i++) {
+        for (int k = 0; k < 16; k++) state[k] ^= block[i * 16 + k];
+        Salsa208(state);
+        memcpy(scratch + ((i & 1) ? (r + i / 2) : (i / 2)) * 16, state, sizeof(state));
+    }
+    memcpy(block, scratch, 32 * (size_t)r * sizeof(uint32_t));
+}
+
+// Salsa20/8: Four double rounds of the Salsa20 core, added back onto the input.
+void Salsa208(uint32_t state[16]) {
+    #define ROTL32(value, bits) (((value) << (bits)) | ((value) >> (32 - (bits))))
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    for (int round = 0; round < 8; round += 2) {
+        // Columns
+        x[ 4] ^= ROTL32(x[ 0] + x[12],  7); x[ 8] ^= ROTL32(x[ 4] + x[ 0],  9);
+        x[12] ^= ROTL32(x[ 8] + x[ 4], 13); x[ 0] ^= ROTL32(x[12] + x[ 8], 18);
+        x[ 9] ^= ROTL32(x[ 5] + x[ 1],  7); x[13] ^= ROTL32(x[ 9] + x[ 5],  9);
+        x[ 1] ^= ROTL32(x[13] + x[ 9], 13); x[ 5] ^= ROTL32(x[ 1] + x[13], 18);
+        x[14] ^= ROTL32(x[10] + x[ 6],  7); x[ 2] ^= ROTL32(x[14] + x[10],  9);
+        x[ 6] ^= ROTL32(x[ 2] + x[14], 13); x[10] ^= ROTL32(x[ 6] + x[ 2], 18);
+        x[ 3] ^= ROTL32(x[15] + x[11],  7); x[ 7] ^= ROTL32(x[ 3] + x[15],  9);
+        x[11] ^= ROTL32(x[ 7] + x[ 3], 13); x[15] ^= ROTL32(x[11] + x[ 7], 18);
+        // Rows
+        x[ 1] ^= ROTL32(x[ 0] + x[ 3],  7); x[ 2] ^= ROTL32(x[ 1] + x[ 0],  9);
+        x[ 3] ^= ROTL32(x[ 2] + x[ 1], 13); x[ 0] ^= ROTL32(x[ 3] + x[ 2], 18);
+        x[ 6] ^= ROTL32(x[ 5] + x[ 4],  7); x[ 7] ^= ROTL32(x[ 6] + x[ 5],  9);
+        x[ 4] ^= ROTL32(x[ 7] + x[ 6], 13); x[ 5] ^= ROTL32(x[ 4] + x[ 7], 18);
+        x[11] ^= ROTL32(x[10] + x[ 9],  7); x[ 8] ^= ROTL32(x[11] + x[10],  9);
+        x[ 9] ^= ROTL32(x[ 8] + x[11], 13); x[10] ^= ROTL32(x[ 9] + x[ 8], 18);
+        x[12] ^= ROTL32(x[15] + x[14],  7); x[13] ^= ROTL32(x[12] + x[15],  9);
+        x[14] ^= ROTL32(x[13] + x[12], 13); x[15] ^= ROTL32(x[14] + x[13], 18);
+    }
+    for (int i = 0; i < 16; i++) state[i] += x[i];
+    #undef ROTL32
+}
+
+// Pbkdf2Sha256: PBKDF2-HMAC-SHA256 with a single iteration, which is all scrypt needs.
+void Pbkdf2Sha256(const uint8_t* password, size_t passwordLength, const uint8_t* salt, size_t saltLength, uint8_t* out, size_t outLength) {
+    for (uint32_t blockIndex = 1; outLength > 0; blockIndex++) {
+        uint8_t counter[4] = { (uint8_t)(blockIndex >> 24), (uint8_t)(blockIndex >> 16), (uint8_t)(blockIndex >> 8), (uint8_t)blockIndex };
+        uint8_t digest[32];
+        HmacSha256(password, passwordLength, salt, saltLength, counter, sizeof(counter), digest);
+        size_t take = (outLength < sizeof(digest)) ? outLength : sizeof(digest);
+        memcpy(out, digest, take);
+        out += take;
+        outLength -= take;
+    }
+}
+
+// HmacSha256: HMAC-SHA256 of the concatenation data1 || data2.
+void HmacSha256(const uint8_t* key, size_t keyLength, const uint8_t* data1, size_t length1, const uint8_t* data2, size_t length2, uint8_t out[32]) {
+    uint8_t keyBlock[64] = { 0 };
+    if (keyLength > sizeof(keyBlock)) { // Long keys are hashed first
+        Sha256 sha;
+        Sha256Init(&sha);
+        Sha256Update(&sha, key, keyLength);
+        Sha256Final(&sha, keyBlock);
+    } else {
+        memcpy(keyBlock, key, keyLength);
+    }
+
+    uint8_t pad[64];
+    uint8_t inner[32];
+    Sha256 sha;
+    for (int i = 0; i < 64; i++) pad[i] = keyBlock[i] ^ 0x36;
+    Sha256Init(&sha);
+    Sha256Update(&sha, pad, sizeof(pad));
+    Sha256Update(&sha, data1, length1);
+    Sha256Update(&sha, data2, length2);
+    Sha256Final(&sha, inner);
+
+    for (int i = 0; i < 64; i++) pad[i] = keyBlock[i] ^ 0x5c;
+    Sha256Init(&sha);
+    Sha256Update(&sha, pad, sizeof(pad));
+    Sha256Update(&sha, inner, sizeof(inner));
+    Sha256Final(&sha, out);
+    SecureZero(keyBlock, sizeof(keyBlock));
+    SecureZero(pad, sizeof(pad));
+}
+
+// Sha256Init: Loads the SHA-256 initial hash value.
+void Sha256Init(Sha256* sha) {
+    static const uint32_t initial[8] = { 0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19 };
+    memcpy(sha->state, initial, sizeof(initial));
+    sha->length = 0;
+    sha->used = 0;
+}
+
+// Sha256Update: Adds 'length' bytes to the hash.
+void Sha256Update(Sha256* sha, const uint8_t* data, size_t length) {
+    sha->length += length;
+    while (length > 0) {
+        size_t take = 64 - sha->used;
+        if (take > length) take = length;
+        memcpy(sha->block + sha->used, data, take);
+        sha->used += (int)take;
+        data += take;
+        length -= take;
+        if (sha->used == 64) {
+            Sha256Transform(sha->state, sha->block);
+            sha->used = 0;
         }
     }
-    return false; // Username not found
 }
+
+// Sha256Final: Pads the message, processes the last block(s) and writes the big-endian digest.
+void Sha256Final(Sha256* sha, uint8_t out[32]) {
+    uint64_t bitLength = sha->length * 8;
+    uint8_t padding[72] = { 0x80 };
+    size_t padLength = (sha->used < 56) ? (size_t)(56 - sha->used) : (size_t)(120 - sha->used);
+    for (int i = 0; i < 8; i++) padding[padLength + i] = (uint8_t)(bitLength >> (56 - 8 * i));
+    Sha256Update(sha, padding, padLength + 8);
+    for (int i = 0; i < 8; i++) {
+        out[4 * i] = (uint8_t)(sha->state[i] >> 24);
+        out[4 * i + 1] = (uint8_t)(sha->state[i] >> 16);
+        out[4 * i + 2] = (uint8_t)(sha->state[i] >> 8);
+        out[4 * i + 3] = (uint8_t)sha->state[i];
+    }
+}
+
+// Sha256Transform: The SHA-256 compression function for one block.
+void Sha256Transform(uint32_t state[8], const uint8_t block[64]) {
+    static const uint32_t k[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+    };
+    #define ROTR32(value, bits) (((value) >> (bits)) | ((value) << (32 - (bits))))
+    uint32_t w[64];
+    for (int i = 0; i < 16; i++) {
+        w[i] = ((uint32_t)block[4 * i] << 24) | ((uint32_t)block[4 * i + 1] << 16) | ((uint32_t)block[4 * i + 2] << 8) | block[4 * i + 3];
+    }
+    for (int i = 16; i < 64; i++) {
+        uint32_t s0 = ROTR32(w[i - 15], 7) ^ ROTR32(w[i - 15], 18) ^ (w[i - 15] >> 3);
+        uint32_t s1 = ROTR32(w[i - 2], 17) ^ ROTR32(w[i - 2], 19) ^ (w[i - 2] >> 10);
+        w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+
+    uint32_t a = state[0], b = state[1], c = state[2], d = state[3], e = state[4], f = state[5], g = state[6], h = state[7];
+    for (int i = 0; i < 64; i++) {
+        uint32_t t1 = h + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) + ((e & f) ^ (~e & g)) + k[i] + w[i];
+        uint32_t t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+        h = g; g = f; f = e; e = d + t1;
+        d = c; c = b; b = a; a = t1 + t2;
+    }
+    state[0] += a; state[1] += b; state[2] += c; state[3] += d;
+    state[4] += e; state[5] += f; state[6] += g; state[7] += h;
+    #undef ROTR32
+}
+
+// FillRandom: Reads 'length' random bytes from the operating system's CSPRNG.
+bool FillRandom(uint8_t* buffer, int length) {
+#if defined(_WIN32)
+    for (int i = 0; i < length; i++) {
+        unsigned int value;
+        if (rand_s(&value) != 0) return false;
+        buffer[i] = (uint8_t)value;
+    }
+    return true;
+#else
+    FILE* source = fopen("/dev/urandom", "rb");
+    if (source == NULL) return false;
+    bool filled = fread(buffer, 1, (size_t)length, source) == (size_t)length;
+    fclose(source);
+    return filled;
+#endif
+}
+
+// SecureZero: Overwrites a buffer through a volatile pointer so the stores are not optimized away.
+void SecureZero(void* buffer, size_t length) {
+    volatile uint8_t* bytes = (volatile uint8_t*)buffer;
+    while (length--) *bytes++ = 0;
+}
+
+#if defined(AUCTION_HEADLESS)
+// --- Headless Platform Function Implementations ---
+// Stand-ins for the raylib calls the auction core makes, so it links without raylib.
+
+// TraceLog: Writes "LEVEL: message" to stderr (keeping benchmark reports on stdout clean).
+// Formats into one buffer first so lines from different threads do not interleave.
+void TraceLog(int logLevel, const char* text, ...) {
+    if (logLevel < headlessLogLevel) return;
+    static const char* const levelNames[] = { "", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL" };
+    char line[1024];
+    va_list args;
+    va_start(args, text);
+    vsnprintf(line, sizeof(line), text, args);
+    va_end(args);
+    fprintf(stderr, "%s: %s\n", (logLevel > LOG_ALL && logLevel < LOG_NONE) ? levelNames[logLevel] : "LOG", line);
+    if (logLevel == LOG_FATAL) exit(EXIT_FAILURE); // Like raylib
+}
+
+// SetTraceLogLevel: Drops messages below 'logLevel'.
+void SetTraceLogLevel(int logLevel) {
+    headlessLogLevel = logLevel;
+}
+
+// FileExists: True if 'fileName' can be opened for reading.
+bool FileExists(const char* fileName) {
+    FILE* file = fopen(fileName, "rb");
+    if (file == NULL) return false;
+    fclose(file);
+    return true;
+}
+#endif